@@ -1,5 +1,6 @@
 QT       += core gui \
-            multimedia
+            multimedia \
+            concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,41 +11,89 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    assetmanager.cpp \
+    atlaspacker.cpp \
+    backgroundcache.cpp \
     door.cpp \
     main.cpp \
     character.cpp \
     classicboss.cpp \
     companion.cpp \
     finalboss.cpp \
+    fixedstepscheduler.cpp \
     flashbackobject.cpp \
+    framesnapshot.cpp \
     game.cpp \
+    gameclock.cpp \
+    headlessrunner.cpp \
+    hudlayer.cpp \
     launchmenu.cpp \
     level.cpp \
+    levelarena.cpp \
+    levelformat.cpp \
+    levelmanifest.cpp \
+    levelprefetcher.cpp \
     gui.cpp \
     maincharacter.cpp \
     obstacle.cpp \
+    obstaclegrid.cpp \
     optionsmenu.cpp \
     pausemenu.cpp \
     piece.cpp \
-    shortscope.cpp
+    prng.cpp \
+    renderworker.cpp \
+    replayformat.cpp \
+    shortscope.cpp \
+    softwarerenderer.cpp \
+    spritebatcher.cpp \
+    spriteblitter.cpp \
+    spritepack.cpp \
+    sweptaabb.cpp \
+    worldsnapshot.cpp
 
 HEADERS += \
+    assetmanager.h \
+    atlaspacker.h \
+    backgroundcache.h \
     character.h \
     classicboss.h \
     companion.h \
     door.h \
     finalboss.h \
+    fixedstepscheduler.h \
     flashbackobject.h \
+    framesnapshot.h \
     game.h \
+    gameclock.h \
+    headlessrunner.h \
+    hudlayer.h \
+    inputcommand.h \
     launchmenu.h \
     level.h \
+    levelarena.h \
+    levelformat.h \
+    levelmanifest.h \
+    levelprefetcher.h \
     gui.h \
     maincharacter.h \
     obstacle.h \
+    obstaclegrid.h \
     optionsmenu.h \
     pausemenu.h \
     piece.h \
-    shortscope.h
+    prng.h \
+    renderworker.h \
+    replayformat.h \
+    shortscope.h \
+    softwarerenderer.h \
+    spritebatcher.h \
+    spriteblitter.h \
+    spritepack.h \
+    spriteregistry.h \
+    spscqueue.h \
+    sweptaabb.h \
+    triplebuffer.h \
+    worldsnapshot.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -53,3 +102,38 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 RESOURCES += \
     ressources.qrc
+
+# The sprites are decoded from sprites.qrc, unless CONFIG += sprite_pack leaves them out of the
+# executable: the game then maps sprites.npak, built next to it by "make sprites"
+sprite_pack {
+    PRE_TARGETDEPS += sprites.npak
+} else {
+    RESOURCES += sprites.qrc
+}
+
+# Compile the text levels into the binary levels the game loads: make levels
+# The compiler is built from tools/levelcompiler, LEVEL_COMPILER overrides its path
+isEmpty(LEVEL_COMPILER): LEVEL_COMPILER = $$OUT_PWD/tools/levelcompiler/levelcompiler
+LEVEL_SOURCES = $$files($$PWD/assets/level/*.txt)
+levels.commands = $(MKDIR) $$shell_path($$OUT_PWD/tools/levelcompiler) && \
+    cd $$shell_path($$OUT_PWD/tools/levelcompiler) && $(QMAKE) $$shell_path($$PWD/tools/levelcompiler/levelcompiler.pro) && $(MAKE)
+for(source, LEVEL_SOURCES) {
+    levels.commands += && $$shell_path($$LEVEL_COMPILER) $$shell_path($$source) $$shell_path($$replace(source, \.txt$, .nlvl))
+}
+QMAKE_EXTRA_TARGETS += levels
+
+# Pre-scale the sprites of every level into the sprite pack the game maps: make sprites
+# The packer is built from tools/assetpacker, SPRITE_PACKER overrides its path and SPRITE_RATIOS
+# lists the device pixel ratios to pack, the other ratios fall back on the nearest packed frames
+isEmpty(SPRITE_PACKER): SPRITE_PACKER = $$OUT_PWD/tools/assetpacker/assetpacker
+isEmpty(SPRITE_RATIOS): SPRITE_RATIOS = 1
+sprites.target = sprites.npak
+sprites.commands = $(MKDIR) $$shell_path($$OUT_PWD/tools/assetpacker) && \
+    cd $$shell_path($$OUT_PWD/tools/assetpacker) && $(QMAKE) $$shell_path($$PWD/tools/assetpacker/assetpacker.pro) && $(MAKE) && \
+    cd $$shell_path($$OUT_PWD) && $$shell_path($$SPRITE_PACKER)
+for(ratio, SPRITE_RATIOS) {
+    sprites.commands += --ratio $$ratio
+}
+sprites.commands += --qrc $$shell_path($$PWD/ressources.qrc) --qrc $$shell_path($$PWD/sprites.qrc) sprites.npak
+sprites.commands += $$shell_path($$files($$PWD/assets/level/*.nlvl))
+QMAKE_EXTRA_TARGETS += sprites
@@ -0,0 +1,656 @@
+/**
+ * @file assetmanager.cpp
+ * @brief Implementation of the AssetManager class methods.
+ */
+
+#include "assetmanager.h"
+#include "atlaspacker.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QtConcurrent>
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Constructor for AssetManager class.
+ * @param aSpriteNb Number of sprite identifiers.
+ * @param aByteBudget Resident bytes above which the unused assets are evicted.
+ */
+AssetManager::AssetManager(int aSpriteNb, qint64 aByteBudget)
+    : itsSlots(aSpriteNb), itsSlotKeys(aSpriteNb), itsByteBudget(aByteBudget)
+{}
+
+/**
+ * @brief Returns the key of an asset.
+ *
+ * The device pixel ratio is part of the key, a frame scaled for another screen is another asset.
+ *
+ * @param aPath Resource path of the image.
+ * @param aSize Draw size, in logical pixels.
+ * @return Key in itsAssets.
+ */
+QString AssetManager::keyOf(const QString &aPath, const QSize &aSize) const
+{
+    return QStringLiteral("%1@%2x%3@%4").arg(aPath).arg(aSize.width()).arg(aSize.height()).arg(itsDevicePixelRatio);
+}
+
+/**
+ * @brief Memory-maps a sprite pack, the frames it holds are no longer decoded.
+ * @param aPath Path of the sprite pack.
+ * @return True if the pack was mapped and is valid.
+ */
+bool AssetManager::openPack(const QString &aPath)
+{
+    itsPack = SpritePack::View();
+    itsPackFile.close();
+    itsPackFile.setFileName(aPath);
+    if (!itsPackFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const uchar *data = itsPackFile.map(0, itsPackFile.size());
+    std::string error;
+    SpritePack::View pack;
+    if (data == nullptr || !SpritePack::open(data, size_t(itsPackFile.size()), pack, error))
+    {
+        qDebug() << "Sprite pack" << aPath << "refused:" << (data == nullptr ? "cannot be mapped" : error.c_str());
+        itsPackFile.close();
+        return false;
+    }
+
+    itsPack = pack;
+    qDebug() << "Sprite pack" << aPath << "mapped," << itsPack.header.entryNb << "frames," << itsPackFile.size() << "bytes";
+    return true;
+}
+
+/**
+ * @brief Returns whether a sprite pack is open.
+ * @return True if a pack is mapped.
+ */
+bool AssetManager::hasPack() const
+{
+    return itsPack.data != nullptr;
+}
+
+/**
+ * @brief Returns a frame scaled to its draw size, from the sprite pack or decoded.
+ *
+ * A packed frame is wrapped in a read-only image, without copy, and is only paged in when read.
+ * A frame the pack lacks is decoded and scaled as without a pack.
+ *
+ * @param aPath Resource path of the image.
+ * @param aDrawSize Size, in logical pixels, the frame is drawn at.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the frame is drawn on.
+ * @param aSourceBytes Receives the size of the image once decoded at full size.
+ * @return The frame, or a null image if it cannot be loaded.
+ */
+QImage AssetManager::load(const QString &aPath, const QSize &aDrawSize, qreal aDevicePixelRatio, qint64 &aSourceBytes) const
+{
+    SpritePack::Entry entry;
+    QByteArray path = aPath.toUtf8();
+    if (itsPack.data != nullptr
+        && itsPack.find(std::string_view(path.constData(), size_t(path.size())), uint16_t(aDrawSize.width()),
+                        uint16_t(aDrawSize.height()), uint16_t(qRound(aDevicePixelRatio * 100)), entry))
+    {
+        QImage frame(itsPack.data + entry.offset, entry.deviceWidth, entry.deviceHeight, entry.bytesPerLine,
+                     QImage::Format_ARGB32_Premultiplied);
+        frame.setDevicePixelRatio(entry.ratio / 100.0);
+        aSourceBytes = entry.sourceBytes;
+        return frame;
+    }
+    return prepare(aPath, aDrawSize, aDevicePixelRatio, aSourceBytes);
+}
+
+/**
+ * @brief Loads the frames of the sprites not prepared yet, spread over the threads of the global pool.
+ *
+ * load() only reads the manager, and QImage can be used from any thread, so the sprites are
+ * loaded independently of each other.
+ *
+ * @param someSprites Sprites to prepare.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the frames are drawn on.
+ * @param aStepNb Incremented after each sprite, may be nullptr.
+ * @param aCancelled Checked before each sprite, may be nullptr.
+ * @return Time spent loading, in nanoseconds, summed over the threads.
+ */
+qint64 AssetManager::loadAll(QVector<SpriteRequest> &someSprites, qreal aDevicePixelRatio, std::atomic<int> *aStepNb,
+                             const std::atomic<bool> *aCancelled) const
+{
+    std::atomic<qint64> cpuNs{0};
+    QtConcurrent::blockingMap(someSprites, [&](SpriteRequest &aSprite)
+    {
+        if (aCancelled != nullptr && *aCancelled)
+        {
+            return;
+        }
+        if (aSprite.prepared.isNull())
+        {
+            QElapsedTimer clock;
+            clock.start();
+            aSprite.prepared = load(aSprite.path, aSprite.size, aDevicePixelRatio, aSprite.sourceBytes);
+            cpuNs += clock.nsecsElapsed();
+        }
+        if (aStepNb != nullptr)
+        {
+            (*aStepNb)++;
+        }
+    });
+    return cpuNs;
+}
+
+/**
+ * @brief Makes the sprites of a set resident, replacing the previous content of the set.
+ * @param aSet Name of the set.
+ * @param someSprites Sprites of the set.
+ * @param aBind True to draw the sprites of the set through operator[].
+ */
+void AssetManager::acquireSet(const QString &aSet, const QVector<SpriteRequest> &someSprites, bool aBind)
+{
+    QVector<QPair<int, QString>> entries;
+    entries.reserve(someSprites.size());
+
+    // The frames missing are loaded first, all at once, so that they load in parallel
+    QVector<SpriteRequest> missing;
+    QHash<QString, int> missingIndex;
+    for (const SpriteRequest &sprite : someSprites)
+    {
+        QString key = keyOf(sprite.path, sprite.size);
+        if (!itsAssets.contains(key) && !missingIndex.contains(key))
+        {
+            missingIndex.insert(key, static_cast<int>(missing.size()));
+            missing.append(sprite);
+        }
+    }
+    if (!missing.isEmpty())
+    {
+        QElapsedTimer clock;
+        clock.start();
+        itsLoadCpuNs += loadAll(missing, itsDevicePixelRatio);
+        itsLoadWallNs += clock.nsecsElapsed();
+    }
+    QVector<int> pages;
+    QVector<QRect> sources;
+    pack(missing, pages, sources);
+
+    for (const SpriteRequest &sprite : someSprites)
+    {
+        QString key = keyOf(sprite.path, sprite.size);
+        auto asset = itsAssets.find(key);
+        if (asset != itsAssets.end())
+        {
+            itsHitNb++;
+        }
+        else
+        {
+            auto loadedIndex = missingIndex.constFind(key);
+            if (loadedIndex == missingIndex.cend())
+            {
+                continue; // Already missed in this call, the frame could not be loaded
+            }
+            int index = loadedIndex.value();
+            const QImage &scaled = missing.at(index).prepared;
+            missingIndex.erase(loadedIndex);
+            itsMissNb++;
+            if (scaled.isNull())
+            {
+                continue;
+            }
+            if (itsPack.data != nullptr && scaled.constBits() >= itsPack.data
+                && scaled.constBits() < itsPack.data + itsPackFile.size())
+            {
+                itsPackedNb++;
+            }
+
+            Asset loaded;
+            loaded.page = pages.at(index);
+            loaded.source = sources.at(index);
+            loaded.bytes = scaled.sizeInBytes();
+            loaded.sourceBytes = missing.at(index).sourceBytes;
+            itsSourceBytes += loaded.sourceBytes;
+            asset = itsAssets.insert(key, loaded);
+        }
+
+        asset->refNb++;
+        asset->lastUse = ++itsUseClock;
+        entries.append(qMakePair(sprite.id, key));
+
+        if (aBind && sprite.id >= 0)
+        {
+            if (sprite.id >= itsSlots.size())
+            {
+                itsSlots.resize(sprite.id + 1);
+                itsSlotKeys.resize(sprite.id + 1);
+            }
+            itsSlots[sprite.id].page = itsPages.value(asset->page).pixmap;
+            itsSlots[sprite.id].source = asset->source;
+            itsSlotKeys[sprite.id] = key;
+        }
+    }
+    itsPeakBytes = std::max(itsPeakBytes, itsResidentBytes);
+
+    // The previous content is released last, the sprites it shares with the new one stay resident
+    releaseSet(aSet);
+    itsSets.insert(aSet, entries);
+    evict();
+}
+
+/**
+ * @brief Packs loaded frames on new atlas pages.
+ *
+ * The frames are placed from the tallest to the shortest, then copied line by line into the pages,
+ * a packed frame costs page faults and a copy instead of a decode. Each page is uploaded to a
+ * pixmap once, at a device pixel ratio of 1, the sources are in device pixels.
+ *
+ * @param someSprites Loaded sprites, the null frames are skipped.
+ * @param somePages Receives the page of each sprite, -1 for the null frames.
+ * @param someSources Receives the place of each sprite in its page, in device pixels.
+ */
+void AssetManager::pack(const QVector<SpriteRequest> &someSprites, QVector<int> &somePages, QVector<QRect> &someSources)
+{
+    somePages.fill(-1, someSprites.size());
+    someSources.fill(QRect(), someSprites.size());
+
+    QVector<int> order;
+    for (int index = 0; index < someSprites.size(); ++index)
+    {
+        if (!someSprites.at(index).prepared.isNull())
+        {
+            order.append(index);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&someSprites](int aLeft, int aRight)
+    {
+        return someSprites.at(aLeft).prepared.height() > someSprites.at(aRight).prepared.height();
+    });
+
+    AtlasPacker packer;
+    QVector<AtlasPacker::Placement> placements(someSprites.size());
+    for (int index : order)
+    {
+        placements[index] = packer.place(someSprites.at(index).prepared.size());
+    }
+
+    QVector<QImage> images(packer.getPageNb());
+    for (int page = 0; page < images.size(); ++page)
+    {
+        images[page] = QImage(packer.getPageSize(page), QImage::Format_ARGB32_Premultiplied);
+        images[page].fill(Qt::transparent);
+    }
+    for (int index : order)
+    {
+        QImage frame = someSprites.at(index).prepared.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const AtlasPacker::Placement &placement = placements.at(index);
+        QImage &image = images[placement.page];
+        for (int y = 0; y < frame.height(); ++y)
+        {
+            std::copy_n(reinterpret_cast<const QRgb *>(frame.constScanLine(y)), frame.width(),
+                        reinterpret_cast<QRgb *>(image.scanLine(placement.position.y() + y)) + placement.position.x());
+        }
+        someSources[index] = QRect(placement.position, frame.size());
+    }
+
+    QVector<int> numbers(images.size());
+    for (int page = 0; page < images.size(); ++page)
+    {
+        Page loaded;
+        loaded.pixmap = QPixmap::fromImage(images.at(page));
+        loaded.bytes = images.at(page).sizeInBytes();
+        itsResidentBytes += loaded.bytes;
+        numbers[page] = itsNextPage++;
+        itsPages.insert(numbers[page], loaded);
+    }
+    for (int index : order)
+    {
+        somePages[index] = numbers.at(placements.at(index).page);
+    }
+}
+
+/**
+ * @brief Releases the sprites of a set, they become evictable.
+ * @param aSet Name of the set.
+ */
+void AssetManager::releaseSet(const QString &aSet)
+{
+    auto set = itsSets.find(aSet);
+    if (set == itsSets.end())
+    {
+        return;
+    }
+
+    for (const QPair<int, QString> &entry : set.value())
+    {
+        auto asset = itsAssets.find(entry.second);
+        if (asset != itsAssets.end())
+        {
+            asset->refNb--;
+        }
+    }
+    itsSets.erase(set);
+    evict();
+}
+
+/**
+ * @brief Evicts the pages no set holds a frame of, least recently used first, until the budget is met.
+ *
+ * A page is as recent as its most recently acquired frame. A slot keeps a copy of the page it is
+ * bound to, so the slots bound to the frames of an evicted page are cleared too, otherwise its
+ * pixels would stay in memory.
+ */
+void AssetManager::evict()
+{
+    if (itsResidentBytes <= itsByteBudget)
+    {
+        return;
+    }
+
+    QHash<int, quint64> lastUses;
+    QSet<int> held;
+    for (const Asset &asset : std::as_const(itsAssets))
+    {
+        quint64 &lastUse = lastUses[asset.page];
+        lastUse = std::max(lastUse, asset.lastUse);
+        if (asset.refNb > 0)
+        {
+            held.insert(asset.page);
+        }
+    }
+    QVector<QPair<quint64, int>> unused;
+    for (auto page = lastUses.cbegin(); page != lastUses.cend(); ++page)
+    {
+        if (!held.contains(page.key()))
+        {
+            unused.append(qMakePair(page.value(), page.key()));
+        }
+    }
+    std::sort(unused.begin(), unused.end());
+
+    for (const QPair<quint64, int> &candidate : unused)
+    {
+        if (itsResidentBytes <= itsByteBudget)
+        {
+            break;
+        }
+        itsResidentBytes -= itsPages.value(candidate.second).bytes;
+        itsPages.remove(candidate.second);
+
+        for (auto asset = itsAssets.begin(); asset != itsAssets.end();)
+        {
+            if (asset->page != candidate.second)
+            {
+                ++asset;
+                continue;
+            }
+            for (int id = 0; id < itsSlotKeys.size(); ++id)
+            {
+                if (itsSlotKeys[id] == asset.key())
+                {
+                    itsSlots[id] = SpriteFrame();
+                    itsSlotKeys[id].clear();
+                }
+            }
+            itsSourceBytes -= asset->sourceBytes;
+            itsEvictionNb++;
+            asset = itsAssets.erase(asset);
+        }
+    }
+
+    if (itsResidentBytes > itsByteBudget)
+    {
+        qDebug() << "Sprite sets in use take" << itsResidentBytes << "bytes, over the budget of" << itsByteBudget;
+    }
+}
+
+/**
+ * @brief Checks whether a set is held.
+ * @param aSet Name of the set.
+ * @return True if the set was acquired and not released.
+ */
+bool AssetManager::holds(const QString &aSet) const
+{
+    return itsSets.contains(aSet);
+}
+
+/**
+ * @brief Returns the frame bound to an identifier.
+ * @param aId Identifier of the frame.
+ * @return The atlas page and place of the frame, a null page if no set binds this identifier.
+ */
+const SpriteFrame &AssetManager::operator[](int aId) const
+{
+    if (aId < 0 || aId >= itsSlots.size())
+    {
+        return itsNullSprite;
+    }
+    return itsSlots[aId];
+}
+
+/**
+ * @brief Copies the frame bound to an identifier out of its atlas page.
+ * @param aId Identifier of the frame.
+ * @return The pre-scaled frame, or a null pixmap if no set binds this identifier.
+ */
+QPixmap AssetManager::pixmap(int aId) const
+{
+    const SpriteFrame &frame = (*this)[aId];
+    if (frame.page.isNull())
+    {
+        return QPixmap();
+    }
+    QPixmap copy = frame.page.copy(frame.source);
+    copy.setDevicePixelRatio(itsDevicePixelRatio);
+    return copy;
+}
+
+/**
+ * @brief Sets the device pixel ratio used for the next acquisitions.
+ * @param aDevicePixelRatio Device pixel ratio of the target screen.
+ */
+void AssetManager::setDevicePixelRatio(qreal aDevicePixelRatio)
+{
+    itsDevicePixelRatio = aDevicePixelRatio;
+}
+
+/**
+ * @brief Sets the resident bytes above which the unused assets are evicted.
+ * @param aByteBudget Number of bytes.
+ */
+void AssetManager::setItsByteBudget(qint64 aByteBudget)
+{
+    itsByteBudget = aByteBudget;
+    evict();
+}
+
+/**
+ * @brief Returns the resident bytes above which the unused assets are evicted.
+ * @return Number of bytes.
+ */
+qint64 AssetManager::getItsByteBudget() const
+{
+    return itsByteBudget;
+}
+
+/**
+ * @brief Returns the bytes used by the resident assets.
+ * @return Number of bytes.
+ */
+qint64 AssetManager::getResidentBytes() const
+{
+    return itsResidentBytes;
+}
+
+/**
+ * @brief Returns the highest number of resident bytes so far.
+ * @return Number of bytes.
+ */
+qint64 AssetManager::getPeakBytes() const
+{
+    return itsPeakBytes;
+}
+
+/**
+ * @brief Returns the bytes saved by keeping the resident assets pre-scaled.
+ * @return Number of bytes.
+ */
+qint64 AssetManager::getSavedBytes() const
+{
+    return itsSourceBytes - itsResidentBytes;
+}
+
+/**
+ * @brief Returns the number of resident assets.
+ * @return Number of assets.
+ */
+int AssetManager::getAssetNb() const
+{
+    return static_cast<int>(itsAssets.size());
+}
+
+/**
+ * @brief Returns the number of resident atlas pages.
+ * @return Number of pages.
+ */
+int AssetManager::getPageNb() const
+{
+    return static_cast<int>(itsPages.size());
+}
+
+/**
+ * @brief Returns the number of assets acquired while already resident.
+ * @return Number of hits.
+ */
+qint64 AssetManager::getItsHitNb() const
+{
+    return itsHitNb;
+}
+
+/**
+ * @brief Returns the number of assets decoded or uploaded when acquired.
+ * @return Number of misses.
+ */
+qint64 AssetManager::getItsMissNb() const
+{
+    return itsMissNb;
+}
+
+/**
+ * @brief Returns the number of assets evicted with their page to stay within the budget.
+ * @return Number of evictions.
+ */
+qint64 AssetManager::getItsEvictionNb() const
+{
+    return itsEvictionNb;
+}
+
+/**
+ * @brief Returns the number of misses served from the sprite pack instead of decoded.
+ * @return Number of packed frames acquired.
+ */
+qint64 AssetManager::getItsPackedNb() const
+{
+    return itsPackedNb;
+}
+
+/**
+ * @brief Returns the time acquireSet() waited for the frames it loaded.
+ * @return Wall time, in milliseconds.
+ */
+qint64 AssetManager::getLoadWallMs() const
+{
+    return itsLoadWallNs / 1000000;
+}
+
+/**
+ * @brief Returns the time the threads spent loading the frames of acquireSet().
+ * @return Time summed over the threads, in milliseconds.
+ */
+qint64 AssetManager::getLoadCpuMs() const
+{
+    return itsLoadCpuNs / 1000000;
+}
+
+/**
+ * @brief Lists the sprites of a level, at the sizes its level file gives.
+ *
+ * The sprites are pre-scaled to the size the level file gives each entity.
+ *
+ * @param someDrawSizes Size of the first entity of each kind in the level file.
+ * @param anEra Era of the level.
+ * @param someEraSprites Receives the sprites of the era.
+ * @param someCommonSprites Receives the sprites shared by every level.
+ */
+void AssetManager::spriteRequests(const QMap<QString, QSize> &someDrawSizes, Era anEra,
+                                  QVector<SpriteRequest> &someEraSprites, QVector<SpriteRequest> &someCommonSprites)
+{
+    auto drawSize = [&someDrawSizes](const QString &aType, const QSize &aDefault)
+    {
+        QSize size = someDrawSizes.value(aType);
+        return size.isValid() ? size : aDefault;
+    };
+    QSize sizes[SpriteSizeCount];
+    sizes[MainSize] = drawSize("MainCharacter", QSize(100, 115));
+    sizes[CompanionSize] = drawSize("Companion", QSize(50, 65));
+    sizes[Enemy1Size] = drawSize("Enemy1", QSize(100, 115));
+    sizes[Enemy2Size] = drawSize("Enemy2", QSize(100, 85));
+    sizes[BossSize] = drawSize("ClassicBoss", QSize(300, 300));
+    sizes[FinalBossSize] = drawSize("FinalBoss", QSize(55, 120));
+    sizes[SummoningSize] = QSize(70, 70);
+    sizes[PieceSize] = drawSize("Piece", QSize(35, 35));
+    sizes[ObjectSize] = drawSize("FlashbackObject", QSize(40, 40));
+    sizes[DoorSize] = drawSize("Door", QSize(110, 190));
+    sizes[ScreenSize] = QSize(1280, 720);
+    sizes[TextBackgroundSize] = QSize(450, 150);
+
+    auto request = [&sizes](const SpriteSource &aSprite)
+    {
+        SpriteRequest sprite;
+        sprite.id = aSprite.id;
+        sprite.path = QString::fromUtf8(aSprite.path);
+        sprite.size = sizes[aSprite.size];
+        return sprite;
+    };
+
+    // The main character and the enemies change with the era, the boss levels keep the previous ones
+    if (anEra != Era::None)
+    {
+        for (const SpriteSource &sprite : ERA_SPRITES[static_cast<int>(anEra)])
+        {
+            someEraSprites.append(request(sprite));
+        }
+    }
+
+    for (const SpriteSource &sprite : COMMON_SPRITES)
+    {
+        someCommonSprites.append(request(sprite));
+    }
+}
+
+/**
+ * @brief Decodes an image and scales it to its draw size, without storing it.
+ *
+ * The decoded source image only lives for the duration of this call.
+ *
+ * @param aPath Resource path of the image.
+ * @param aDrawSize Size, in logical pixels, the frame is drawn at.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the frame is drawn on.
+ * @param aSourceBytes Receives the size of the image once decoded at full size.
+ * @return The scaled frame, or a null image if the image cannot be decoded.
+ */
+QImage AssetManager::prepare(const QString &aPath, const QSize &aDrawSize, qreal aDevicePixelRatio, qint64 &aSourceBytes)
+{
+    QImage source(aPath);
+    if (source.isNull())
+    {
+        qDebug() << "Failed to load sprite" << aPath;
+        aSourceBytes = 0;
+        return QImage();
+    }
+
+    aSourceBytes = source.sizeInBytes();
+    QSize deviceSize = aDrawSize * aDevicePixelRatio;
+    QImage scaled = source.scaled(deviceSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    scaled.setDevicePixelRatio(aDevicePixelRatio);
+    return scaled;
+}
@@ -0,0 +1,344 @@
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QPixmap>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "spritepack.h"
+#include "spriteregistry.h"
+
+/**
+ * @brief Sprite a set asks for: its slot, its resource image and the size it is drawn at.
+ */
+struct SpriteRequest
+{
+    int id = -1;             ///< Slot of the sprite, see spriteregistry.h
+    QString path;            ///< Resource path of the image
+    QSize size;              ///< Draw size, in logical pixels
+    QImage prepared;         ///< Frame already scaled on a worker thread, null to decode it when acquired
+    qint64 sourceBytes = 0;  ///< Size of the prepared frame once decoded at full size
+};
+
+/**
+ * @brief Sprite as it is drawn: the atlas page holding it and its place in the page.
+ */
+struct SpriteFrame
+{
+    QPixmap page;   ///< Atlas page, shared by every frame packed on it
+    QRect source;   ///< Frame in the page, in device pixels, empty if no frame is bound
+};
+
+/**
+ * @brief The AssetManager class keeps the sprites of the sets in use resident, pre-scaled to their on-screen size.
+ *
+ * A set is a named list of sprites, such as the sprites of the current era, the sprites shared by
+ * every level, or the sprites of the next level. The same image at the same size is stored once and
+ * reference-counted by the sets holding it, so acquiring a set that shares sprites with a resident one
+ * is a hit and decodes nothing. A set can be bound, its sprites are then drawn through operator[],
+ * indexed by sprite identifier. Sprites no set holds anymore stay cached while the resident bytes fit
+ * in the byte budget, and are evicted least recently used first.
+ *
+ * The frames loaded together are packed on a few large atlas pages, see atlaspacker.h, so that the
+ * sprites of a set are drawn from a handful of pixmaps and can be batched, see spritebatcher.h. A page
+ * is evicted whole, once no set holds any of its frames.
+ *
+ * When a sprite pack is open, the frames it holds are read from the mapped file instead of being
+ * decoded and scaled, see spritepack.h.
+ */
+class AssetManager
+{
+    /**
+     * @brief Pre-scaled sprite and its residency bookkeeping.
+     */
+    struct Asset
+    {
+        int page = -1;            ///< Atlas page holding the frame, key in itsPages
+        QRect source;             ///< Frame in the page, in device pixels
+        qint64 bytes = 0;         ///< Size of the pre-scaled frame
+        qint64 sourceBytes = 0;   ///< Size of the frame once decoded at full size
+        int refNb = 0;            ///< Number of set entries holding the asset
+        quint64 lastUse = 0;      ///< Value of the use clock when the asset was last acquired
+    };
+
+    /**
+     * @brief Atlas page holding frames loaded together.
+     */
+    struct Page
+    {
+        QPixmap pixmap;           ///< Frames of the page, with transparent padding between them
+        qint64 bytes = 0;         ///< Size of the page
+    };
+
+    QHash<QString, Asset> itsAssets; /**< Resident assets, by path, draw size and device pixel ratio. */
+    QHash<int, Page> itsPages; /**< Resident atlas pages, by page number. */
+    int itsNextPage = 0; /**< Number given to the next page. */
+    QHash<QString, QVector<QPair<int, QString>>> itsSets; /**< Slot and asset key of the entries of each set. */
+    QVector<SpriteFrame> itsSlots; /**< Sprites of the bound sets, indexed by sprite identifier. */
+    QVector<QString> itsSlotKeys; /**< Asset bound to each slot, empty if none. */
+    SpriteFrame itsNullSprite; /**< Frame returned for unbound identifiers. */
+    qreal itsDevicePixelRatio = 1.0; /**< Device pixel ratio the frames are rendered for. */
+    qint64 itsByteBudget; /**< Resident bytes above which the unused assets are evicted. */
+    qint64 itsResidentBytes = 0; /**< Bytes used by the resident atlas pages. */
+    qint64 itsPeakBytes = 0; /**< Highest value of itsResidentBytes. */
+    qint64 itsSourceBytes = 0; /**< Bytes the resident assets would use at their source size. */
+    qint64 itsHitNb = 0; /**< Assets acquired while already resident. */
+    qint64 itsMissNb = 0; /**< Assets decoded or uploaded when acquired. */
+    qint64 itsEvictionNb = 0; /**< Assets evicted to stay within the budget. */
+    quint64 itsUseClock = 0; /**< Incremented on each acquisition, orders the assets for eviction. */
+    QFile itsPackFile; /**< Sprite pack, mapped while the manager lives. */
+    SpritePack::View itsPack; /**< View on the mapped sprite pack, empty if no pack is open. */
+    qint64 itsPackedNb = 0; /**< Misses served from the sprite pack. */
+    qint64 itsLoadWallNs = 0; /**< Time spent waiting for the frames loaded by acquireSet(). */
+    qint64 itsLoadCpuNs = 0; /**< Time the threads spent loading those frames, summed over the threads. */
+
+    /**
+     * @brief Returns the key of an asset.
+     *
+     * @param aPath Resource path of the image
+     * @param aSize Draw size, in logical pixels
+     * @return Key in itsAssets
+     */
+    QString keyOf(const QString &aPath, const QSize &aSize) const;
+
+    /**
+     * @brief Packs loaded frames on new atlas pages.
+     *
+     * @param someSprites Loaded sprites, the null frames are skipped
+     * @param somePages Receives the page of each sprite, -1 for the null frames
+     * @param someSources Receives the place of each sprite in its page, in device pixels
+     */
+    void pack(const QVector<SpriteRequest> &someSprites, QVector<int> &somePages, QVector<QRect> &someSources);
+
+    /**
+     * @brief Evicts the pages no set holds a frame of, least recently used first, until the budget is met.
+     */
+    void evict();
+
+public:
+    static constexpr qint64 DEFAULT_BYTE_BUDGET = 24 * 1024 * 1024; ///< Default resident bytes budget
+
+    /**
+     * @brief Constructor to initialize an empty asset manager.
+     *
+     * @param aSpriteNb Number of sprite identifiers
+     * @param aByteBudget Resident bytes above which the unused assets are evicted
+     */
+    AssetManager(int aSpriteNb = 0, qint64 aByteBudget = DEFAULT_BYTE_BUDGET);
+
+    /**
+     * @brief Memory-maps a sprite pack, the frames it holds are no longer decoded.
+     *
+     * @param aPath Path of the sprite pack
+     * @return True if the pack was mapped and is valid
+     */
+    bool openPack(const QString &aPath);
+
+    /**
+     * @brief Returns whether a sprite pack is open.
+     *
+     * @return True if a pack is mapped
+     */
+    bool hasPack() const;
+
+    /**
+     * @brief Returns a frame scaled to its draw size, from the sprite pack or decoded.
+     *
+     * Only reads the manager, so it can run on a worker thread while the GUI thread draws.
+     *
+     * @param aPath Resource path of the image
+     * @param aDrawSize Size, in logical pixels, the frame is drawn at
+     * @param aDevicePixelRatio Device pixel ratio of the screen the frame is drawn on
+     * @param aSourceBytes Receives the size of the image once decoded at full size
+     * @return The frame, pointing into the mapped pack if packed, or a null image if it cannot be loaded
+     */
+    QImage load(const QString &aPath, const QSize &aDrawSize, qreal aDevicePixelRatio, qint64 &aSourceBytes) const;
+
+    /**
+     * @brief Loads the frames of the sprites not prepared yet, spread over the threads of the global pool.
+     *
+     * @param someSprites Sprites to prepare, their prepared frame and source size are filled
+     * @param aDevicePixelRatio Device pixel ratio of the screen the frames are drawn on
+     * @param aStepNb Incremented after each sprite, may be nullptr
+     * @param aCancelled Checked before each sprite, may be nullptr
+     * @return Time spent loading, in nanoseconds, summed over the threads
+     */
+    qint64 loadAll(QVector<SpriteRequest> &someSprites, qreal aDevicePixelRatio, std::atomic<int> *aStepNb = nullptr,
+                   const std::atomic<bool> *aCancelled = nullptr) const;
+
+    /**
+     * @brief Makes the sprites of a set resident, replacing the previous content of the set.
+     *
+     * The new sprites are acquired before the previous ones are released, so the sprites both share
+     * are not evicted in between. The frames missing are loaded in parallel with loadAll(), only
+     * their packing on atlas pages and the upload of the pages run on the calling thread.
+     *
+     * @param aSet Name of the set
+     * @param someSprites Sprites of the set
+     * @param aBind True to draw the sprites of the set through operator[]
+     */
+    void acquireSet(const QString &aSet, const QVector<SpriteRequest> &someSprites, bool aBind);
+
+    /**
+     * @brief Releases the sprites of a set, they become evictable.
+     *
+     * @param aSet Name of the set
+     */
+    void releaseSet(const QString &aSet);
+
+    /**
+     * @brief Checks whether a set is held.
+     *
+     * @param aSet Name of the set
+     * @return True if the set was acquired and not released
+     */
+    bool holds(const QString &aSet) const;
+
+    /**
+     * @brief Returns the frame bound to an identifier.
+     *
+     * @param aId Identifier of the frame
+     * @return The atlas page and place of the frame, a null page if no set binds this identifier
+     */
+    const SpriteFrame &operator[](int aId) const;
+
+    /**
+     * @brief Copies the frame bound to an identifier out of its atlas page.
+     *
+     * For the widgets that need a pixmap of their own, the painters draw from the page.
+     *
+     * @param aId Identifier of the frame
+     * @return The pre-scaled frame, or a null pixmap if no set binds this identifier
+     */
+    QPixmap pixmap(int aId) const;
+
+    /**
+     * @brief Sets the device pixel ratio used for the next acquisitions.
+     *
+     * @param aDevicePixelRatio Device pixel ratio of the target screen
+     */
+    void setDevicePixelRatio(qreal aDevicePixelRatio);
+
+    /**
+     * @brief Sets the resident bytes above which the unused assets are evicted.
+     *
+     * @param aByteBudget Number of bytes
+     */
+    void setItsByteBudget(qint64 aByteBudget);
+
+    /**
+     * @brief Returns the resident bytes above which the unused assets are evicted.
+     *
+     * @return Number of bytes
+     */
+    qint64 getItsByteBudget() const;
+
+    /**
+     * @brief Returns the bytes used by the resident assets.
+     *
+     * @return Number of bytes
+     */
+    qint64 getResidentBytes() const;
+
+    /**
+     * @brief Returns the highest number of resident bytes so far.
+     *
+     * @return Number of bytes
+     */
+    qint64 getPeakBytes() const;
+
+    /**
+     * @brief Returns the bytes saved by keeping the resident assets pre-scaled.
+     *
+     * @return Number of bytes
+     */
+    qint64 getSavedBytes() const;
+
+    /**
+     * @brief Returns the number of resident assets.
+     *
+     * @return Number of assets
+     */
+    int getAssetNb() const;
+
+    /**
+     * @brief Returns the number of resident atlas pages.
+     *
+     * @return Number of pages
+     */
+    int getPageNb() const;
+
+    /**
+     * @brief Returns the number of assets acquired while already resident.
+     *
+     * @return Number of hits
+     */
+    qint64 getItsHitNb() const;
+
+    /**
+     * @brief Returns the number of assets decoded or uploaded when acquired.
+     *
+     * @return Number of misses
+     */
+    qint64 getItsMissNb() const;
+
+    /**
+     * @brief Returns the number of assets evicted with their page to stay within the budget.
+     *
+     * @return Number of evictions
+     */
+    qint64 getItsEvictionNb() const;
+
+    /**
+     * @brief Returns the number of misses served from the sprite pack instead of decoded.
+     *
+     * @return Number of packed frames acquired
+     */
+    qint64 getItsPackedNb() const;
+
+    /**
+     * @brief Returns the time acquireSet() waited for the frames it loaded.
+     *
+     * @return Wall time, in milliseconds
+     */
+    qint64 getLoadWallMs() const;
+
+    /**
+     * @brief Returns the time the threads spent loading the frames of acquireSet().
+     *
+     * @return Time summed over the threads, in milliseconds
+     */
+    qint64 getLoadCpuMs() const;
+
+    /**
+     * @brief Lists the sprites of a level, at the sizes its level file gives.
+     *
+     * @param someDrawSizes Size of the first entity of each kind in the level file, see Level::getItsDrawSizes()
+     * @param anEra Era of the level
+     * @param someEraSprites Receives the sprites of the era, none for Era::None
+     * @param someCommonSprites Receives the sprites shared by every level
+     */
+    static void spriteRequests(const QMap<QString, QSize> &someDrawSizes, Era anEra,
+                               QVector<SpriteRequest> &someEraSprites, QVector<SpriteRequest> &someCommonSprites);
+
+    /**
+     * @brief Decodes an image and scales it to its draw size, without storing it.
+     *
+     * Only QImage is used, so the frames can be prepared on a worker thread.
+     *
+     * @param aPath Resource path of the image
+     * @param aDrawSize Size, in logical pixels, the frame is drawn at
+     * @param aDevicePixelRatio Device pixel ratio of the screen the frame is drawn on
+     * @param aSourceBytes Receives the size of the image once decoded at full size
+     * @return The scaled frame, or a null image if the image cannot be decoded
+     */
+    static QImage prepare(const QString &aPath, const QSize &aDrawSize, qreal aDevicePixelRatio, qint64 &aSourceBytes);
+};
+
+#endif // ASSETMANAGER_H
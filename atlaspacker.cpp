@@ -0,0 +1,103 @@
+/**
+ * @file atlaspacker.cpp
+ * @brief Implementation of the AtlasPacker class methods.
+ */
+
+#include "atlaspacker.h"
+
+/**
+ * @brief Constructor for AtlasPacker class.
+ * @param aPageSize Width and height of a page, in pixels.
+ * @param aPadding Transparent pixels kept between two frames.
+ */
+AtlasPacker::AtlasPacker(int aPageSize, int aPadding)
+    : itsPageSize(aPageSize), itsPadding(aPadding)
+{}
+
+/**
+ * @brief Places a frame.
+ *
+ * The padding is kept on the right and under each frame, the frames of a page never touch.
+ *
+ * @param aSize Size of the frame, in pixels.
+ * @return Page and position of the frame.
+ */
+AtlasPacker::Placement AtlasPacker::place(const QSize &aSize)
+{
+    int width = aSize.width() + itsPadding;
+    int height = aSize.height() + itsPadding;
+    Placement placement;
+
+    // A frame larger than a page is alone on a page of its size, its shelf leaves no room
+    if (width > itsPageSize || height > itsPageSize)
+    {
+        Shelf full;
+        full.height = itsPageSize;
+        full.x = itsPageSize;
+        placement.page = static_cast<int>(itsPageSizes.size());
+        itsShelves.append(QVector<Shelf>{full});
+        itsPageSizes.append(aSize);
+        return placement;
+    }
+
+    for (int page = 0; page < itsShelves.size(); ++page)
+    {
+        QVector<Shelf> &shelves = itsShelves[page];
+        for (Shelf &shelf : shelves)
+        {
+            if (height <= shelf.height && shelf.x + width <= itsPageSize)
+            {
+                placement.page = page;
+                placement.position = QPoint(shelf.x, shelf.y);
+                shelf.x += width;
+                break;
+            }
+        }
+
+        int bottom = shelves.isEmpty() ? 0 : shelves.last().y + shelves.last().height;
+        if (placement.page < 0 && bottom + height <= itsPageSize)
+        {
+            Shelf shelf;
+            shelf.y = bottom;
+            shelf.height = height;
+            shelf.x = width;
+            shelves.append(shelf);
+            placement.page = page;
+            placement.position = QPoint(0, bottom);
+        }
+
+        if (placement.page >= 0)
+        {
+            QSize &extent = itsPageSizes[page];
+            extent = extent.expandedTo(QSize(placement.position.x() + aSize.width(), placement.position.y() + aSize.height()));
+            return placement;
+        }
+    }
+
+    Shelf shelf;
+    shelf.height = height;
+    shelf.x = width;
+    itsShelves.append(QVector<Shelf>{shelf});
+    itsPageSizes.append(aSize);
+    placement.page = static_cast<int>(itsPageSizes.size()) - 1;
+    return placement;
+}
+
+/**
+ * @brief Returns the number of pages opened so far.
+ * @return Number of pages.
+ */
+int AtlasPacker::getPageNb() const
+{
+    return static_cast<int>(itsPageSizes.size());
+}
+
+/**
+ * @brief Returns the size a page needs to hold the frames placed on it.
+ * @param aPage Page number.
+ * @return Size, at most the page size unless the page holds a single larger frame.
+ */
+QSize AtlasPacker::getPageSize(int aPage) const
+{
+    return itsPageSizes.value(aPage);
+}
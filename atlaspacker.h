@@ -0,0 +1,77 @@
+#ifndef ATLASPACKER_H
+#define ATLASPACKER_H
+
+#include <QPoint>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @brief The AtlasPacker class places frames on atlas pages, shelf by shelf.
+ *
+ * A page is filled with horizontal shelves, a frame goes on the first shelf tall enough with room
+ * left on its right, otherwise on a new shelf under the last one, otherwise on a new page. The
+ * frames are best placed from the tallest to the shortest, the shelves then waste little height.
+ * A frame larger than a page gets a page of its own, of its size.
+ */
+class AtlasPacker
+{
+    /**
+     * @brief Row of frames of a page.
+     */
+    struct Shelf
+    {
+        int y = 0;       ///< Top of the shelf
+        int height = 0;  ///< Height of the tallest frame of the shelf
+        int x = 0;       ///< Left of the room left on the shelf
+    };
+
+    int itsPageSize; /**< Width and height of a page, in pixels. */
+    int itsPadding; /**< Transparent pixels kept between two frames, so that filtering does not bleed. */
+    QVector<QVector<Shelf>> itsShelves; /**< Shelves of each page. */
+    QVector<QSize> itsPageSizes; /**< Extent of the frames placed on each page. */
+
+public:
+    static constexpr int PAGE_SIZE = 2048; ///< Default page size, supported as a texture size everywhere
+
+    /**
+     * @brief Placement of a frame.
+     */
+    struct Placement
+    {
+        int page = -1;     ///< Page of the frame
+        QPoint position;   ///< Top left corner of the frame in the page, in pixels
+    };
+
+    /**
+     * @brief Constructor to initialize a packer without pages.
+     *
+     * @param aPageSize Width and height of a page, in pixels
+     * @param aPadding Transparent pixels kept between two frames
+     */
+    AtlasPacker(int aPageSize = PAGE_SIZE, int aPadding = 2);
+
+    /**
+     * @brief Places a frame.
+     *
+     * @param aSize Size of the frame, in pixels
+     * @return Page and position of the frame
+     */
+    Placement place(const QSize &aSize);
+
+    /**
+     * @brief Returns the number of pages opened so far.
+     *
+     * @return Number of pages
+     */
+    int getPageNb() const;
+
+    /**
+     * @brief Returns the size a page needs to hold the frames placed on it.
+     *
+     * @param aPage Page number
+     * @return Size, at most the page size unless the page holds a single larger frame
+     */
+    QSize getPageSize(int aPage) const;
+};
+
+#endif // ATLASPACKER_H
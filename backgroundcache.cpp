@@ -0,0 +1,153 @@
+/**
+ * @file backgroundcache.cpp
+ * @brief Implementation of the BackgroundCache class methods.
+ */
+
+#include "backgroundcache.h"
+#include <QImage>
+#include <QDebug>
+#include <algorithm>
+
+/**
+ * @brief Constructor for BackgroundCache class.
+ * @param aTileWidth Width of a tile, in logical pixels.
+ */
+BackgroundCache::BackgroundCache(int aTileWidth)
+    : itsTileWidth(aTileWidth)
+{}
+
+/**
+ * @brief Decodes a background, scales it to the level size and cuts it into tiles.
+ * @param aPath Resource path of the background image.
+ * @param aLevelSize Size of the level, in logical pixels.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on.
+ */
+void BackgroundCache::build(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio)
+{
+    if (holds(aPath, aLevelSize, aDevicePixelRatio))
+    {
+        return;
+    }
+    build(aPath, prepare(aPath, aLevelSize, aDevicePixelRatio), aDevicePixelRatio);
+}
+
+/**
+ * @brief Cuts a background already scaled into tiles.
+ *
+ * The background is opaque, so the tiles are stored without alpha channel and are
+ * copied without blending.
+ *
+ * @param aPath Resource path of the background image.
+ * @param aScaled Background scaled to the level size, in device pixels.
+ * @param aDevicePixelRatio Device pixel ratio the background was scaled for.
+ */
+void BackgroundCache::build(const QString &aPath, const QImage &aScaled, qreal aDevicePixelRatio)
+{
+    clear();
+    if (aScaled.isNull())
+    {
+        return;
+    }
+
+    int deviceTileWidth = qRound(itsTileWidth * aDevicePixelRatio);
+    int tileNb = (aScaled.width() + deviceTileWidth - 1) / deviceTileWidth;
+    for (int tile = 0; tile < tileNb; ++tile)
+    {
+        int x = tile * deviceTileWidth;
+        QImage slice = aScaled.copy(x, 0, std::min(deviceTileWidth, aScaled.width() - x), aScaled.height());
+        QPixmap pixmap = QPixmap::fromImage(slice);
+        pixmap.setDevicePixelRatio(aDevicePixelRatio);
+        itsTiles.append(pixmap);
+        itsResidentBytes += slice.sizeInBytes();
+    }
+
+    itsPath = aPath;
+    itsHeight = qRound(aScaled.height() / aDevicePixelRatio);
+}
+
+/**
+ * @brief Checks whether the cache already holds a background at a size.
+ * @param aPath Resource path of the background image.
+ * @param aLevelSize Size of the level, in logical pixels.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on.
+ * @return True if the tiles match.
+ */
+bool BackgroundCache::holds(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio) const
+{
+    int tileNb = (aLevelSize.width() + itsTileWidth - 1) / itsTileWidth;
+    return aPath == itsPath && aLevelSize.height() == itsHeight && tileNb == itsTiles.size()
+           && !itsTiles.isEmpty() && itsTiles.first().devicePixelRatio() == aDevicePixelRatio;
+}
+
+/**
+ * @brief Decodes a background and scales it to the level size.
+ * @param aPath Resource path of the background image.
+ * @param aLevelSize Size of the level, in logical pixels.
+ * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on.
+ * @return The scaled background, or a null image if the image cannot be decoded.
+ */
+QImage BackgroundCache::prepare(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio)
+{
+    QImage source(aPath);
+    if (source.isNull())
+    {
+        qDebug() << "Failed to load background" << aPath;
+        return QImage();
+    }
+
+    QSize deviceSize = aLevelSize * aDevicePixelRatio;
+    return source.scaled(deviceSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+        .convertToFormat(QImage::Format_RGB32);
+}
+
+/**
+ * @brief Records the tiles overlapping the camera in a frame.
+ * @param aSnapshot Snapshot of the frame, its origin already set to level coordinates.
+ * @param aCamera Rectangle of the level seen by the camera.
+ * @return Number of tiles drawn.
+ */
+int BackgroundCache::draw(FrameSnapshot *aSnapshot, const QRect &aCamera) const
+{
+    if (itsTiles.isEmpty())
+    {
+        return 0;
+    }
+
+    int firstTile = std::max(0, aCamera.left() / itsTileWidth);
+    int lastTile = std::min(static_cast<int>(itsTiles.size()) - 1, aCamera.right() / itsTileWidth);
+
+    for (int tile = firstTile; tile <= lastTile; ++tile)
+    {
+        aSnapshot->drawPixmap(QPoint(tile * itsTileWidth, 0), itsTiles.at(tile));
+    }
+    return lastTile - firstTile + 1;
+}
+
+/**
+ * @brief Removes every tile from the cache.
+ */
+void BackgroundCache::clear()
+{
+    itsTiles.clear();
+    itsPath.clear();
+    itsHeight = 0;
+    itsResidentBytes = 0;
+}
+
+/**
+ * @brief Returns the number of tiles of the current background.
+ * @return Number of tiles.
+ */
+int BackgroundCache::getItsTileNb() const
+{
+    return static_cast<int>(itsTiles.size());
+}
+
+/**
+ * @brief Returns the bytes used by the tiles.
+ * @return Number of bytes.
+ */
+qint64 BackgroundCache::getResidentBytes() const
+{
+    return itsResidentBytes;
+}
@@ -0,0 +1,105 @@
+#ifndef BACKGROUNDCACHE_H
+#define BACKGROUNDCACHE_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include "framesnapshot.h"
+
+/**
+ * @brief The BackgroundCache class keeps the background of a level pre-scaled and cut into tiles.
+ *
+ * The background image is decoded and scaled to the size of the level once, when the level
+ * loads, then cut into tiles as wide as the screen. A frame only copies the one or two
+ * tiles the camera overlaps instead of stretching the whole image over the level.
+ */
+class BackgroundCache
+{
+    QVector<QPixmap> itsTiles; /**< Tiles of the scaled background, from left to right. */
+    QString itsPath; /**< Resource path of the image the tiles come from. */
+    int itsTileWidth; /**< Width of a tile, in logical pixels. */
+    int itsHeight = 0; /**< Height of the tiles, in logical pixels. */
+    qint64 itsResidentBytes = 0; /**< Bytes used by the tiles. */
+
+public:
+    /**
+     * @brief Constructor to initialize an empty background cache.
+     *
+     * @param aTileWidth Width of a tile, in logical pixels
+     */
+    BackgroundCache(int aTileWidth = 1280);
+
+    /**
+     * @brief Decodes a background, scales it to the level size and cuts it into tiles.
+     *
+     * Nothing is done if the cache already holds this image at this size.
+     *
+     * @param aPath Resource path of the background image
+     * @param aLevelSize Size of the level, in logical pixels
+     * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on
+     */
+    void build(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio = 1.0);
+
+    /**
+     * @brief Cuts a background already scaled by prepare() into tiles.
+     *
+     * @param aPath Resource path of the background image
+     * @param aScaled Background scaled to the level size, in device pixels
+     * @param aDevicePixelRatio Device pixel ratio the background was scaled for
+     */
+    void build(const QString &aPath, const QImage &aScaled, qreal aDevicePixelRatio);
+
+    /**
+     * @brief Checks whether the cache already holds a background at a size.
+     *
+     * @param aPath Resource path of the background image
+     * @param aLevelSize Size of the level, in logical pixels
+     * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on
+     * @return True if build() would have nothing to do
+     */
+    bool holds(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio) const;
+
+    /**
+     * @brief Decodes a background and scales it to the level size, without cutting it.
+     *
+     * Only QImage is used, so this can run on a worker thread.
+     *
+     * @param aPath Resource path of the background image
+     * @param aLevelSize Size of the level, in logical pixels
+     * @param aDevicePixelRatio Device pixel ratio of the screen the background is drawn on
+     * @return The scaled background, or a null image if the image cannot be decoded
+     */
+    static QImage prepare(const QString &aPath, const QSize &aLevelSize, qreal aDevicePixelRatio);
+
+    /**
+     * @brief Records the tiles overlapping the camera in a frame.
+     *
+     * @param aSnapshot Snapshot of the frame, its origin already set to level coordinates
+     * @param aCamera Rectangle of the level seen by the camera
+     * @return Number of tiles drawn
+     */
+    int draw(FrameSnapshot *aSnapshot, const QRect &aCamera) const;
+
+    /**
+     * @brief Removes every tile from the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of tiles of the current background.
+     *
+     * @return Number of tiles
+     */
+    int getItsTileNb() const;
+
+    /**
+     * @brief Returns the bytes used by the tiles.
+     *
+     * @return Number of bytes
+     */
+    qint64 getResidentBytes() const;
+};
+
+#endif // BACKGROUNDCACHE_H
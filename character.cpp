@@ -1,4 +1,7 @@
 #include "character.h"
+#include <cmath>
+
+double Character::itsStepScale = 1;
 
 /**
  * @brief Constructor of the Character class.
@@ -12,7 +15,7 @@
  * @param type Type of the character.
  */
 Character::Character(int aX, int aY, int aWidth, int aHeight, int type)
-    : itsCharacter(aX, aY, aWidth, aHeight), itsType(type)
+    : itsCharacter(aX, aY, aWidth, aHeight), itsPreviousCharacter(aX, aY, aWidth, aHeight), itsType(type)
 {}
 
 /**
@@ -25,6 +28,34 @@ QRect Character::getRect()
     return itsCharacter;
 }
 
+/**
+ * @brief Stores the current rectangle as the one of the previous tick.
+ */
+void Character::savePreviousRect()
+{
+    itsPreviousCharacter = itsCharacter;
+}
+
+/**
+ * @brief Gets the rectangle interpolated between the previous and the current tick.
+ *
+ * Teleports (more than 200 pixels in one tick) are not interpolated.
+ *
+ * @param anAlpha Interpolation factor between 0 and 1.
+ * @return The interpolated rectangle.
+ */
+QRect Character::getInterpolatedRect(double anAlpha)
+{
+    QPoint delta = itsCharacter.topLeft() - itsPreviousCharacter.topLeft();
+    if (delta.manhattanLength() > 200)
+    {
+        return itsCharacter;
+    }
+    QRect interpolated = itsCharacter;
+    interpolated.moveTopLeft(itsPreviousCharacter.topLeft() + delta * anAlpha);
+    return interpolated;
+}
+
 /**
  * @brief Gets the hit points (HP) of the character.
  *
@@ -84,3 +115,40 @@ int Character::getType()
 {
     return itsType;
 }
+
+/**
+ * @brief Sets the ratio between the duration of a tick and the one the speeds are tuned for.
+ *
+ * @param aStepScale Ratio, 100 divided by the tick rate.
+ */
+void Character::setStepScale(double aStepScale)
+{
+    itsStepScale = aStepScale;
+}
+
+/**
+ * @brief Gets the ratio between the duration of a tick and the one the speeds are tuned for.
+ *
+ * @return Ratio, 1 at 100 Hz.
+ */
+double Character::getStepScale()
+{
+    return itsStepScale;
+}
+
+/**
+ * @brief Turns a speed tuned for 100 Hz into a move of whole pixels for the current tick.
+ *
+ * The move is truncated towards zero and the fraction left is carried to the next tick.
+ *
+ * @param aSpeed Speed, in pixels per tick at 100 Hz.
+ * @param aRemainder Fraction of pixel carried between ticks, updated.
+ * @return Move of the current tick, in pixels.
+ */
+int Character::scaleMove(double aSpeed, double &aRemainder)
+{
+    double move = aSpeed * itsStepScale + aRemainder;
+    double whole = std::trunc(move);
+    aRemainder = move - whole;
+    return static_cast<int>(whole);
+}
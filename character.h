@@ -2,6 +2,7 @@
 #define CHARACTER_H
 
 #include "obstacle.h"
+#include "obstaclegrid.h"
 #include <list>
 
 using namespace std;
@@ -13,13 +14,18 @@ class Character
 {
 protected:
     QRect itsCharacter; ///< Represents the character's dimensions and position
-    int itsXSpeed; ///< Character's speed in the X direction
-    int itsYSpeed; ///< Character's speed in the Y direction
+    QRect itsPreviousCharacter; ///< Character's rectangle at the end of the previous tick
+    int itsXSpeed = 0; ///< Character's speed in the X direction
+    int itsYSpeed = 0; ///< Character's speed in the Y direction
     int itsHP = 3; ///< Character's health points, initialized to 3
     int itsDamage; ///< Damage the character can inflict
     std::list<QString> itsImages; ///< List of images associated with the character
     bool itsDead = false; ///< Character's state, false means alive
     int itsType;
+    double itsXRemainder = 0; ///< Fraction of pixel not yet moved in the X direction
+    double itsYRemainder = 0; ///< Fraction of pixel not yet moved in the Y direction
+
+    static double itsStepScale; ///< Ticks of the tuned rate run in one tick, 1 at 100 Hz
 
 public:
     /**
@@ -35,9 +41,9 @@ public:
     /**
      * @brief Updates the character's position.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
      */
-    virtual void updatePosition(list<Obstacle *>* obstacles) = 0;
+    virtual void updatePosition(ObstacleGrid* obstacles) = 0;
 
     /**
      * @brief Performs an attack.
@@ -58,6 +64,19 @@ public:
      */
     QRect getRect();
 
+    /**
+     * @brief Stores the current rectangle as the one of the previous tick.
+     */
+    void savePreviousRect();
+
+    /**
+     * @brief Returns the rectangle interpolated between the previous and the current tick.
+     *
+     * @param anAlpha Interpolation factor, 0 for the previous tick and 1 for the current one
+     * @return Interpolated rectangle, used for rendering only
+     */
+    QRect getInterpolatedRect(double anAlpha);
+
     /**
      * @brief Returns the character's current health points.
      *
@@ -89,6 +108,35 @@ public:
     void setItsDead(bool state);
 
     int getType();
+
+    /**
+     * @brief Sets the ratio between the duration of a tick and the one the speeds are tuned for.
+     *
+     * The speeds of the game are expressed in pixels per tick at 100 Hz, and are scaled by this
+     * ratio when the simulation runs at another rate.
+     *
+     * @param aStepScale Ratio, 100 divided by the tick rate
+     */
+    static void setStepScale(double aStepScale);
+
+    /**
+     * @brief Gets the ratio between the duration of a tick and the one the speeds are tuned for.
+     *
+     * @return Ratio, 1 at 100 Hz
+     */
+    static double getStepScale();
+
+    /**
+     * @brief Turns a speed tuned for 100 Hz into a move of whole pixels for the current tick.
+     *
+     * The fraction of pixel left is carried to the next tick, so the distance covered in a second
+     * does not depend on the tick rate. At 100 Hz a whole speed is moved as is.
+     *
+     * @param aSpeed Speed, in pixels per tick at 100 Hz
+     * @param aRemainder Fraction of pixel carried between ticks, updated
+     * @return Move of the current tick, in pixels
+     */
+    static int scaleMove(double aSpeed, double &aRemainder);
 };
 
 #endif // CHARACTER_H
@@ -1,6 +1,4 @@
 #include "classicboss.h"
-#include <cstdlib>
-#include <ctime>
 #include <QTransform>
 
 /**
@@ -12,14 +10,29 @@
  * @param aY Initial Y position of the boss.
  * @param aWidth Width of the boss.
  * @param aHeight Height of the boss.
+ * @param aRandom Generator of the level, which outlives the boss.
  */
-ClassicBoss::ClassicBoss(int aX, int aY, int aWidth, int aHeight)
-    : Character(aX, aY, aWidth, aHeight, 0)
+ClassicBoss::ClassicBoss(int aX, int aY, int aWidth, int aHeight, Prng *aRandom)
+    : Character(aX, aY, aWidth, aHeight, 0), itsRandom(aRandom)
 {
     itsSummoning = new std::list<QRect*>();
     itsHP = 12;
 }
 
+/**
+ * @brief Destructor of the ClassicBoss class.
+ *
+ * Frees the summonings still in flight and their list.
+ */
+ClassicBoss::~ClassicBoss()
+{
+    for (QRect *summoning : *itsSummoning)
+    {
+        delete summoning;
+    }
+    delete itsSummoning;
+}
+
 /**
  * @brief Executes the boss's attack based on its phase.
  */
@@ -28,7 +41,6 @@ void ClassicBoss::attack() {
     {
         isSwordVertical = true;
         // If not already attacking, start the attack sequence
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
         for (int i = 0; i < 6; ++i){
             QRect* sword = new QRect(100 + i * 180, 50, 70, 70);
             itsSummoning->push_back(sword);
@@ -39,10 +51,9 @@ void ClassicBoss::attack() {
     if (!isAttacking && itsPhase == 2)
     {
         isSwordVertical = false;
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
         for (int i = 0; i < 2; ++i)
         {
-            QRect* sword = new QRect(1030, (std::rand() % (450 - 290 + 1) + 290) + i * 90, 70, 70);
+            QRect* sword = new QRect(1030, itsRandom->bounded(290, 450) + i * 90, 70, 70);
             itsSummoning->push_back(sword);
         }
         isAttacking = true;
@@ -51,7 +62,6 @@ void ClassicBoss::attack() {
     {
         isSwordVertical = true;
         // If not already attacking, start the attack sequence
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
         for (int i = 0; i < 6; ++i){
             QRect* sword = new QRect(150 + i * 180, 50, 70, 70);
             itsSummoning->push_back(sword);
@@ -62,32 +72,36 @@ void ClassicBoss::attack() {
     {
         if(itsPhase == 1)
         {
+            // toRect() rounds the move of 1.7 pixels to 2 at 100 Hz, the move is scaled to the tick rate
+            int fall = scaleMove(2, itsSwordRemainder);
             for (QRect* sword : *itsSummoning)
             {
                 QTransform transform;
                 QRectF rotatedSword = transform.mapRect(*sword);
-                rotatedSword.translate(0, 1.7);
+                rotatedSword.translate(0, fall);
                 *sword = rotatedSword.toRect();
             }
         }
         else if(itsPhase == 2)
         {
+            int move = scaleMove(-3, itsSwordRemainder);
             for (QRect* sword : *itsSummoning)
             {
                 QTransform transform;
                 transform.rotate(0.0);
                 QRectF rotatedSword = transform.mapRect(*sword);
-                rotatedSword.translate(-3, 0);
+                rotatedSword.translate(move, 0);
                 *sword = rotatedSword.toRect();
             }
         }
         else if(itsPhase == 3)
         {
+            int fall = scaleMove(2, itsSwordRemainder);
             for (QRect* sword : *itsSummoning)
             {
                 QTransform transform;
                 QRectF rotatedSword = transform.mapRect(*sword);
-                rotatedSword.translate(0, 1.7);
+                rotatedSword.translate(0, fall);
                 *sword = rotatedSword.toRect();
             }
         }
@@ -156,9 +170,9 @@ void ClassicBoss::setItsPhase(int phase)
 /**
  * @brief Updates the boss's position. Empty implementation.
  *
- * @param obstacles List of obstacles.
+ * @param obstacles Grid of the obstacles.
  */
-void ClassicBoss::updatePosition(std::list<Obstacle *>* obstacles)
+void ClassicBoss::updatePosition(ObstacleGrid* obstacles)
 {
     // Do nothing, empty function
 }
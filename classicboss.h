@@ -2,6 +2,7 @@
 #define CLASSICBOSS_H
 
 #include "character.h"
+#include "prng.h"
 
 /**
  * @brief Class representing a classic boss in the game.
@@ -14,6 +15,8 @@ class ClassicBoss : public Character
     bool isAttacking = false;
     bool isSwordVertical = true;
     int itsPhase = 1;
+    Prng *itsRandom; ///< Generator of the level, it places the horizontal swords
+    double itsSwordRemainder = 0; ///< Fraction of pixel the swords have not moved yet
 public:
     /**
      * @brief Constructor to initialize the classic boss.
@@ -22,15 +25,21 @@ public:
      * @param aY Initial Y position of the boss
      * @param aWidth Width of the boss
      * @param aHeight Height of the boss
+     * @param aRandom Generator of the level
      */
-    ClassicBoss(int aX, int aY, int aWidth, int aHeight);
+    ClassicBoss(int aX, int aY, int aWidth, int aHeight, Prng *aRandom);
+
+    /**
+     * @brief Destructor, frees the summonings still in flight.
+     */
+    ~ClassicBoss();
 
     /**
      * @brief Updates the boss's position.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
      */
-    void updatePosition(list<Obstacle *>* obstacles) override;
+    void updatePosition(ObstacleGrid* obstacles) override;
 
     /**
      * @brief Performs an attack.
@@ -12,7 +12,7 @@
  * @param mainCharacter Pointer to the main character.
  */
 Companion::Companion(int aX, int aY, int aWidth, int aHeight, MainCharacter *mainCharacter)
-    : itsCompanion(aX, aY, aWidth, aHeight), groundLevel(aY), mainCharacter(mainCharacter)
+    : itsCompanion(aX, aY, aWidth, aHeight), itsPreviousCompanion(aX, aY, aWidth, aHeight), groundLevel(aY), mainCharacter(mainCharacter)
 {}
 
 /**
@@ -23,10 +23,10 @@ Companion::~Companion() {}
 /**
  * @brief Updates the position of the companion based on obstacles and flashback objects.
  *
- * @param obstacles List of obstacles in the game.
+ * @param obstacles Grid of the obstacles in the game.
  * @param objects List of flashback objects in the game.
  */
-void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<FlashbackObject *> *objects)
+void Companion::updatePosition(ObstacleGrid *obstacles, std::list<FlashbackObject *> *objects)
 {
     // Position of the main character
     QRect mainCharRect = mainCharacter->getRect();
@@ -61,9 +61,14 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
         int deltaX = targetX - itsCompanion.left();
         int deltaY = targetY - itsCompanion.top();
 
+        // The speeds are tuned for 100 Hz and scaled to the tick rate, without passing the target
         if (abs(deltaX) > 10)
         {
-            itsXSpeed = (deltaX > 0) ? 4 : -10;
+            itsXSpeed = Character::scaleMove((deltaX > 0) ? 4 : -10, itsXRemainder);
+            if (abs(itsXSpeed) > abs(deltaX))
+            {
+                itsXSpeed = deltaX;
+            }
         }
         else
         {
@@ -72,7 +77,11 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
 
         if (abs(deltaY) > 10)
         {
-            itsYSpeed = (deltaY > 0) ? 4 : -10;
+            itsYSpeed = Character::scaleMove((deltaY > 0) ? 4 : -10, itsYRemainder);
+            if (abs(itsYSpeed) > abs(deltaY))
+            {
+                itsYSpeed = deltaY;
+            }
         }
         else
         {
@@ -86,12 +95,15 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
     }
 
     // Limit the vertical speed to prevent too rapid movements
-    itsYSpeed = std::min(itsYSpeed, 10);
+    itsYSpeed = std::min(itsYSpeed, static_cast<int>(std::lround(10 * Character::getStepScale())));
 
     bool obstacleDetected = false;
     int maxObstacleTop = INT_MIN; // Keep track of the highest height of all encountered obstacles
 
-    for (Obstacle* obstacle : *obstacles)
+    // Only the obstacles around the move matter, with room for the dodge movements
+    QRect reach = itsCompanion.united(itsCompanion.translated(itsXSpeed, itsYSpeed)).adjusted(-128, -128, 128, 128);
+
+    for (Obstacle* obstacle : obstacles->query(reach))
     {
         QRect obstacleRect = obstacle->getRect();
         QRect nextPosition = itsCompanion.translated(itsXSpeed, itsYSpeed);
@@ -105,7 +117,7 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
             if (itsCompanion.bottom() <= obstacleRect.top() && itsCompanion.top() >= groundLevel)
             {
                 // If there is an obstacle ahead but the companion is on the ground, it jumps
-                itsYSpeed = -17; // Initialize jump speed
+                itsYSpeed = Character::scaleMove(-17, itsYRemainder); // Initialize jump speed
                 itsJump = true;
             }
             else if (itsCompanion.bottom() > obstacleRect.top() && itsCompanion.top() < groundLevel)
@@ -134,7 +146,7 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
     int floatOffset = static_cast<int>(floatAmplitude * sin(floatFrequency * time));
 
     // Apply the movement to the companion
-    itsCompanion.translate(itsXSpeed, itsYSpeed + floatOffset);
+    itsCompanion.translate(itsXSpeed, itsYSpeed + Character::scaleMove(floatOffset, itsFloatRemainder));
 
     // Prevent the companion from falling below groundLevel
     if (itsCompanion.bottom() > groundLevel)
@@ -142,7 +154,7 @@ void Companion::updatePosition(std::list<Obstacle *> *obstacles, std::list<Flash
         itsCompanion.moveBottom(groundLevel);
         itsYSpeed = 0; // Stop falling
     }
-    time++;
+    time += Character::getStepScale();
 }
 
 /**
@@ -244,3 +256,29 @@ QRect Companion::getRect()
 {
     return itsCompanion;
 }
+
+/**
+ * @brief Stores the current rectangle as the one of the previous tick.
+ */
+void Companion::savePreviousRect()
+{
+    itsPreviousCompanion = itsCompanion;
+}
+
+/**
+ * @brief Gets the rectangle interpolated between the previous and the current tick.
+ *
+ * @param anAlpha Interpolation factor between 0 and 1.
+ * @return The interpolated rectangle.
+ */
+QRect Companion::getInterpolatedRect(double anAlpha)
+{
+    QPoint delta = itsCompanion.topLeft() - itsPreviousCompanion.topLeft();
+    if (delta.manhattanLength() > 200)
+    {
+        return itsCompanion;
+    }
+    QRect interpolated = itsCompanion;
+    interpolated.moveTopLeft(itsPreviousCompanion.topLeft() + delta * anAlpha);
+    return interpolated;
+}
@@ -16,6 +16,7 @@ using namespace std;
 class Companion
 {
     QRect itsCompanion;
+    QRect itsPreviousCompanion; ///< Companion's rectangle at the end of the previous tick
     bool itsJump = 0; /**< Flag indicating whether the avatar is currently jumping. */
     bool itsRight = false; /**< Flag indicating whether the avatar is moving right. */
     bool itsLeft = false; /**< Flag indicating whether the avatar is moving left. */
@@ -23,7 +24,10 @@ class Companion
     int itsYSpeed; ///< Character's speed in the Y direction
     int groundLevel;
     MainCharacter* mainCharacter; ///< Référence au personnage principal
-    int time = 0;
+    float time = 0; ///< Time of the floating effect, in ticks at 100 Hz
+    double itsXRemainder = 0; ///< Fraction of pixel not yet moved in the X direction
+    double itsYRemainder = 0; ///< Fraction of pixel not yet moved in the Y direction
+    double itsFloatRemainder = 0; ///< Fraction of pixel of the floating effect not yet moved
 
 public:
     /**
@@ -52,9 +56,10 @@ public:
     /**
      * @brief Updates the companion's position.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
+     * @param objects List of flashback objects present in the game
      */
-    void updatePosition(list<Obstacle *>* obstacles, std::list<FlashbackObject *> *objects);
+    void updatePosition(ObstacleGrid* obstacles, std::list<FlashbackObject *> *objects);
 
     /**
      * @brief Enables or disables the movement of the Companion to the right.
@@ -99,6 +104,19 @@ public:
     bool getPreviousDirection();
 
     QRect getRect();
+
+    /**
+     * @brief Stores the current rectangle as the one of the previous tick.
+     */
+    void savePreviousRect();
+
+    /**
+     * @brief Returns the rectangle interpolated between the previous and the current tick.
+     *
+     * @param anAlpha Interpolation factor, 0 for the previous tick and 1 for the current one
+     * @return Interpolated rectangle, used for rendering only
+     */
+    QRect getInterpolatedRect(double anAlpha);
 };
 
 #endif // COMPANION_H
@@ -29,21 +29,22 @@ void FinalBoss::attack() {}
 /**
  * @brief Updates the position of the final boss based on obstacles.
  *
- * @param obstacles List of obstacles in the game.
+ * @param obstacles Grid of the obstacles in the game.
  */
-void FinalBoss::updatePosition(std::list<Obstacle *>* obstacles)
+void FinalBoss::updatePosition(ObstacleGrid* obstacles)
 {
     if(itsHP > 0)
     {
         QRect newCharacterRect = itsCharacter;
-        newCharacterRect.translate(itsXSpeed, 0);
+        newCharacterRect.translate(scaleMove(itsXSpeed, itsXRemainder), 0);
 
-        for (Obstacle* obstacle : *obstacles)
+        for (Obstacle* obstacle : obstacles->query(newCharacterRect))
         {
             if (newCharacterRect.intersects(obstacle->getRect()))
             {
                 // Reverse direction upon collision
                 itsXSpeed = -itsXSpeed;
+                itsXRemainder = 0;
                 itsPreviousDirection = !itsPreviousDirection;
                 newCharacterRect.translate(2 * itsXSpeed, 0); // Adjust position to avoid sticking
                 break;
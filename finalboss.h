@@ -26,7 +26,7 @@ public:
      */
     FinalBoss(int aX, int aY, int aWidth, int aHeight, int type = 0);
     void attack() override;
-    void updatePosition(std::list<Obstacle *>* obstacles) override;
+    void updatePosition(ObstacleGrid* obstacles) override;
     bool getIsAttacking();
     bool getPreviousDirection() override;
     void setIsAttacking(bool attack);
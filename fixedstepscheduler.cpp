@@ -0,0 +1,107 @@
+/**
+ * @file fixedstepscheduler.cpp
+ * @brief Implementation of the FixedStepScheduler class methods.
+ */
+
+#include "fixedstepscheduler.h"
+
+/**
+ * @brief Constructor for FixedStepScheduler class.
+ * @param aTickRate Number of ticks per second.
+ */
+FixedStepScheduler::FixedStepScheduler(int aTickRate)
+{
+    setTickRate(aTickRate);
+}
+
+/**
+ * @brief Checks whether a tick rate is supported.
+ * @param aTickRate Number of ticks per second.
+ * @return True for 60, 100, 120 and 240 Hz, false otherwise.
+ */
+bool FixedStepScheduler::isSupportedTickRate(int aTickRate)
+{
+    return aTickRate == 60 || aTickRate == 100 || aTickRate == 120 || aTickRate == 240;
+}
+
+/**
+ * @brief Changes the tick rate and restarts the clock.
+ * @param aTickRate Number of ticks per second.
+ */
+void FixedStepScheduler::setTickRate(int aTickRate)
+{
+    itsTickRate = isSupportedTickRate(aTickRate) ? aTickRate : DEFAULT_TICK_RATE;
+    itsStepNs = 1000000000LL / itsTickRate;
+    restart();
+}
+
+/**
+ * @brief Returns the tick rate.
+ * @return Number of ticks per second.
+ */
+int FixedStepScheduler::getTickRate() const
+{
+    return itsTickRate;
+}
+
+/**
+ * @brief Restarts the clock and drops the accumulated time.
+ */
+void FixedStepScheduler::restart()
+{
+    itsClock.start();
+    itsLastNs = 0;
+    itsAccumulatorNs = 0;
+}
+
+/**
+ * @brief Consumes the elapsed time and returns the number of ticks to run.
+ * @return Number of ticks to run now.
+ */
+int FixedStepScheduler::ticksDue()
+{
+    qint64 now = itsClock.nsecsElapsed();
+    qint64 delta = now - itsLastNs;
+    itsLastNs = now;
+
+    // A gap of a quarter of a second means the loop was stopped (pause, loading): do not replay it
+    if (delta > 250000000LL)
+    {
+        delta = itsStepNs;
+    }
+
+    itsAccumulatorNs += delta;
+
+    int ticks = static_cast<int>(itsAccumulatorNs / itsStepNs);
+    if (ticks > itsMaxCatchUpTicks)
+    {
+        ticks = itsMaxCatchUpTicks;
+        itsAccumulatorNs %= itsStepNs;
+    }
+    else
+    {
+        itsAccumulatorNs -= ticks * itsStepNs;
+    }
+    return ticks;
+}
+
+/**
+ * @brief Returns how far the clock is between the last tick and the next one.
+ * @return Interpolation factor between 0 and 1.
+ */
+double FixedStepScheduler::getAlpha() const
+{
+    // Include the time elapsed since the last call, so frames between two wake-ups still move
+    qint64 pending = itsAccumulatorNs + itsClock.nsecsElapsed() - itsLastNs;
+    return qMin(1.0, static_cast<double>(pending) / itsStepNs);
+}
+
+/**
+ * @brief Returns the time left before the next tick is due.
+ * @return Time in nanoseconds, 0 if a tick is already due.
+ */
+qint64 FixedStepScheduler::getNsecsToNextTick() const
+{
+    qint64 pending = itsAccumulatorNs + itsClock.nsecsElapsed() - itsLastNs;
+    return qMax<qint64>(0, itsStepNs - pending);
+}
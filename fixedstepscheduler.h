@@ -0,0 +1,84 @@
+#ifndef FIXEDSTEPSCHEDULER_H
+#define FIXEDSTEPSCHEDULER_H
+
+#include <QElapsedTimer>
+
+/**
+ * @brief The FixedStepScheduler class decides how many simulation ticks are due.
+ *
+ * Elapsed wall time is added to an accumulator and consumed in fixed-size steps,
+ * so the simulation advances at the same rate whatever the timer jitter is. What
+ * is left in the accumulator gives the interpolation factor used for rendering.
+ */
+class FixedStepScheduler
+{
+    QElapsedTimer itsClock; /**< Monotonic clock measuring the elapsed time. */
+    int itsTickRate; /**< Number of ticks per second. */
+    qint64 itsStepNs; /**< Duration of one tick, in nanoseconds. */
+    qint64 itsAccumulatorNs = 0; /**< Elapsed time not yet consumed by a tick. */
+    qint64 itsLastNs = 0; /**< Clock value at the previous call to ticksDue(). */
+    int itsMaxCatchUpTicks = 8; /**< Maximum number of ticks run in one call. */
+
+public:
+    static constexpr int DEFAULT_TICK_RATE = 100; /**< Rate the gameplay constants are tuned for. */
+
+    /**
+     * @brief Constructor to initialize the scheduler.
+     *
+     * @param aTickRate Number of ticks per second
+     */
+    FixedStepScheduler(int aTickRate = DEFAULT_TICK_RATE);
+
+    /**
+     * @brief Checks whether a tick rate is supported.
+     *
+     * @param aTickRate Number of ticks per second
+     * @return True for 60, 100, 120 and 240 Hz, false otherwise
+     */
+    static bool isSupportedTickRate(int aTickRate);
+
+    /**
+     * @brief Changes the tick rate and restarts the clock.
+     *
+     * @param aTickRate Number of ticks per second, must be supported
+     */
+    void setTickRate(int aTickRate);
+
+    /**
+     * @brief Returns the tick rate.
+     *
+     * @return Number of ticks per second
+     */
+    int getTickRate() const;
+
+    /**
+     * @brief Restarts the clock and drops the accumulated time.
+     */
+    void restart();
+
+    /**
+     * @brief Consumes the elapsed time and returns the number of ticks to run.
+     *
+     * A long gap, for example after a pause, only yields one tick, and at most
+     * itsMaxCatchUpTicks are returned so that a slow machine does not spiral.
+     *
+     * @return Number of ticks to run now
+     */
+    int ticksDue();
+
+    /**
+     * @brief Returns how far the clock is between the last tick and the next one.
+     *
+     * @return Interpolation factor between 0 and 1
+     */
+    double getAlpha() const;
+
+    /**
+     * @brief Returns the time left before the next tick is due.
+     *
+     * @return Time in nanoseconds, 0 if a tick is already due
+     */
+    qint64 getNsecsToNextTick() const;
+};
+
+#endif // FIXEDSTEPSCHEDULER_H
@@ -12,7 +12,7 @@
  * @param aNb Number associated with the flashback object.
  * @param aText Text associated with the flashback object.
  */
-FlashbackObject::FlashbackObject(int aX, int aY, int aWidth, int aHeight, QString aNb, QString aText)
+FlashbackObject::FlashbackObject(int aX, int aY, int aWidth, int aHeight, int aNb, QString aText)
     : itsNb(aNb), itsText(aText), itsFlashbackObject(aX, aY, aWidth, aHeight)
 {}
 
@@ -29,9 +29,9 @@ QRect FlashbackObject::getRect()
 /**
  * @brief Gets the number associated with the flashback object.
  *
- * @return A QString object representing the number of the flashback object.
+ * @return The number of the flashback object in its level.
  */
-QString FlashbackObject::getItsNb()
+int FlashbackObject::getItsNb()
 {
     return itsNb;
 }
@@ -8,7 +8,7 @@
  */
 class FlashbackObject
 {
-    const QString itsNb;
+    const int itsNb; ///< Number of the object in its level, from 1 to 3
     const QString itsText;
     QRect itsFlashbackObject; ///< Rectangle representing the dimensions and position of the flashback object
 
@@ -21,7 +21,7 @@ public:
      * @param aWidth Width of the flashback object
      * @param aHeight Height of the flashback object
      */
-    FlashbackObject(int aX, int aY, int aWidth, int aHeight, QString aNb, QString aText);
+    FlashbackObject(int aX, int aY, int aWidth, int aHeight, int aNb, QString aText);
 
     /**
      * @brief Returns the rectangle representing the flashback object.
@@ -30,7 +30,7 @@ public:
      */
     QRect getRect();
 
-    QString getItsNb();
+    int getItsNb();
     
     QString getItsText();
 };
@@ -0,0 +1,151 @@
+/**
+ * @file framesnapshot.cpp
+ * @brief Implementation of the FrameSnapshot class methods.
+ */
+
+#include "framesnapshot.h"
+
+/**
+ * @brief Constructor for FrameSnapshot class.
+ * @param aSize Size of the frame, in logical pixels.
+ * @param aDevicePixelRatio Device pixel ratio of the screen.
+ */
+FrameSnapshot::FrameSnapshot(const QSize &aSize, qreal aDevicePixelRatio)
+    : itsSize(aSize), itsDevicePixelRatio(aDevicePixelRatio)
+{
+}
+
+/**
+ * @brief Returns the index of a pixmap, which is added on first use.
+ *
+ * A frame draws dozens of sprites from a few atlas pages, each page is only held once.
+ *
+ * @param aPixmap Pixmap drawn.
+ * @return Index of the pixmap in the snapshot.
+ */
+int FrameSnapshot::sourceIndex(const QPixmap &aPixmap)
+{
+    auto index = itsSourceIndexes.constFind(aPixmap.cacheKey());
+    if (index != itsSourceIndexes.constEnd())
+    {
+        return index.value();
+    }
+    itsPixmaps.append(aPixmap);
+    return itsSourceIndexes.insert(aPixmap.cacheKey(), static_cast<int>(itsPixmaps.size()) - 1).value();
+}
+
+/**
+ * @brief Sets the offset added to the targets of the next commands.
+ * @param anOrigin Position of the origin of the recorded coordinates on screen.
+ */
+void FrameSnapshot::setOrigin(const QPoint &anOrigin)
+{
+    itsOrigin = anOrigin;
+}
+
+/**
+ * @brief Records part of a pixmap stretched to a rectangle.
+ * @param aTarget Rectangle drawn to, relative to the origin.
+ * @param aPixmap Pixmap drawn.
+ * @param aSource Part of the pixmap drawn, in its device pixels.
+ * @param isSprite True for a sprite of an atlas page.
+ */
+void FrameSnapshot::drawPixmap(const QRect &aTarget, const QPixmap &aPixmap, const QRect &aSource, bool isSprite)
+{
+    if (aPixmap.isNull() || aSource.isEmpty())
+    {
+        return;
+    }
+    Command command;
+    command.source = sourceIndex(aPixmap);
+    command.sourceRect = aSource;
+    command.target = aTarget.translated(itsOrigin);
+    command.isSprite = isSprite;
+    itsCommands.append(command);
+}
+
+/**
+ * @brief Records a whole pixmap at its logical size.
+ * @param aTopLeft Position of the pixmap, relative to the origin.
+ * @param aPixmap Pixmap drawn.
+ */
+void FrameSnapshot::drawPixmap(const QPoint &aTopLeft, const QPixmap &aPixmap)
+{
+    drawPixmap(QRect(aTopLeft, aPixmap.deviceIndependentSize().toSize()), aPixmap, aPixmap.rect());
+}
+
+/**
+ * @brief Records a rectangle filled with a color.
+ * @param aTarget Rectangle filled, relative to the origin.
+ * @param aColor Fill color.
+ */
+void FrameSnapshot::fillRect(const QRect &aTarget, const QColor &aColor)
+{
+    Command command;
+    command.target = aTarget.translated(itsOrigin);
+    command.color = aColor;
+    itsCommands.append(command);
+}
+
+/**
+ * @brief Replaces the pixmaps with their images, so that the snapshot can leave the GUI thread.
+ *
+ * On the raster platform a pixmap holds an image, which is shared without copy.
+ */
+void FrameSnapshot::convertToImages()
+{
+    itsImages.reserve(itsPixmaps.size());
+    for (const QPixmap &pixmap : itsPixmaps)
+    {
+        itsImages.append(pixmap.toImage());
+    }
+    itsPixmaps.clear();
+    itsSourceIndexes.clear();
+}
+
+/**
+ * @brief Returns the size of the frame.
+ * @return Size in logical pixels.
+ */
+QSize FrameSnapshot::getItsSize() const
+{
+    return itsSize;
+}
+
+/**
+ * @brief Returns the device pixel ratio the frame is drawn for.
+ * @return Device pixel ratio.
+ */
+qreal FrameSnapshot::getItsDevicePixelRatio() const
+{
+    return itsDevicePixelRatio;
+}
+
+/**
+ * @brief Returns the drawing operations of the frame.
+ * @return Commands in painting order.
+ */
+const QVector<FrameSnapshot::Command> &FrameSnapshot::getItsCommands() const
+{
+    return itsCommands;
+}
+
+/**
+ * @brief Returns a pixmap drawn, before convertToImages().
+ * @param anIndex Source index of a command.
+ * @return The pixmap.
+ */
+const QPixmap &FrameSnapshot::pixmap(int anIndex) const
+{
+    return itsPixmaps.at(anIndex);
+}
+
+/**
+ * @brief Returns an image drawn, after convertToImages().
+ * @param anIndex Source index of a command.
+ * @return The image.
+ */
+const QImage &FrameSnapshot::image(int anIndex) const
+{
+    return itsImages.at(anIndex);
+}
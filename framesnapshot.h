@@ -0,0 +1,140 @@
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+/**
+ * @brief The FrameSnapshot class records what a frame draws, so that it can be painted later or elsewhere.
+ *
+ * The GUI builds a snapshot from the state of the game, then the snapshot is painted on the widget
+ * or handed to the render thread. A command draws part of an image, or fills a rectangle, in screen
+ * coordinates. Pixmaps can only be used on the GUI thread: convertToImages() replaces them with the
+ * images they hold, after which the snapshot is immutable and can be read from any thread. The
+ * pixmaps recorded are never painted on again, the atlas pages, the background tiles and the HUD
+ * layer are replaced rather than modified, so the images share their pixels without copy.
+ */
+class FrameSnapshot
+{
+public:
+    /**
+     * @brief Drawing operation of a frame.
+     */
+    struct Command
+    {
+        int source = -1; ///< Index of the image drawn, -1 to fill the target with color
+        QRect sourceRect; ///< Part of the image drawn, in device pixels of the image
+        QRect target; ///< Rectangle drawn to, in logical pixels of the screen
+        QColor color; ///< Color the target is filled with when there is no image
+        bool isSprite = false; ///< True for the atlas sprites, which the sprite batcher and the blitter take
+    };
+
+private:
+    QSize itsSize; /**< Size of the frame, in logical pixels. */
+    qreal itsDevicePixelRatio = 1.0; /**< Device pixel ratio of the screen the frame is drawn for. */
+    QPoint itsOrigin; /**< Offset added to the targets of the commands recorded, the opposite of the camera position. */
+    QVector<QPixmap> itsPixmaps; /**< Images drawn while the snapshot is recorded, emptied by convertToImages(). */
+    QVector<QImage> itsImages; /**< Images drawn, filled by convertToImages(). */
+    QHash<qint64, int> itsSourceIndexes; /**< Index of each pixmap recorded, by cache key. */
+    QVector<Command> itsCommands; /**< Drawing operations, in painting order. */
+
+    /**
+     * @brief Returns the index of a pixmap, which is added on first use.
+     *
+     * @param aPixmap Pixmap drawn
+     * @return Index of the pixmap in the snapshot
+     */
+    int sourceIndex(const QPixmap &aPixmap);
+
+public:
+    /**
+     * @brief Constructor to initialize an empty snapshot.
+     *
+     * @param aSize Size of the frame, in logical pixels
+     * @param aDevicePixelRatio Device pixel ratio of the screen
+     */
+    explicit FrameSnapshot(const QSize &aSize = QSize(), qreal aDevicePixelRatio = 1.0);
+
+    /**
+     * @brief Sets the offset added to the targets of the next commands.
+     *
+     * @param anOrigin Position of the origin of the recorded coordinates on screen
+     */
+    void setOrigin(const QPoint &anOrigin);
+
+    /**
+     * @brief Records part of a pixmap stretched to a rectangle.
+     *
+     * @param aTarget Rectangle drawn to, relative to the origin
+     * @param aPixmap Pixmap drawn, nothing is recorded if it is null
+     * @param aSource Part of the pixmap drawn, in its device pixels
+     * @param isSprite True for a sprite of an atlas page
+     */
+    void drawPixmap(const QRect &aTarget, const QPixmap &aPixmap, const QRect &aSource, bool isSprite = false);
+
+    /**
+     * @brief Records a whole pixmap at its logical size.
+     *
+     * @param aTopLeft Position of the pixmap, relative to the origin
+     * @param aPixmap Pixmap drawn, nothing is recorded if it is null
+     */
+    void drawPixmap(const QPoint &aTopLeft, const QPixmap &aPixmap);
+
+    /**
+     * @brief Records a rectangle filled with a color.
+     *
+     * @param aTarget Rectangle filled, relative to the origin
+     * @param aColor Fill color
+     */
+    void fillRect(const QRect &aTarget, const QColor &aColor);
+
+    /**
+     * @brief Replaces the pixmaps with their images, so that the snapshot can leave the GUI thread.
+     */
+    void convertToImages();
+
+    /**
+     * @brief Returns the size of the frame.
+     *
+     * @return Size in logical pixels
+     */
+    QSize getItsSize() const;
+
+    /**
+     * @brief Returns the device pixel ratio the frame is drawn for.
+     *
+     * @return Device pixel ratio
+     */
+    qreal getItsDevicePixelRatio() const;
+
+    /**
+     * @brief Returns the drawing operations of the frame.
+     *
+     * @return Commands in painting order
+     */
+    const QVector<Command> &getItsCommands() const;
+
+    /**
+     * @brief Returns a pixmap drawn, before convertToImages().
+     *
+     * @param anIndex Source index of a command
+     * @return The pixmap
+     */
+    const QPixmap &pixmap(int anIndex) const;
+
+    /**
+     * @brief Returns an image drawn, after convertToImages().
+     *
+     * @param anIndex Source index of a command
+     * @return The image
+     */
+    const QImage &image(int anIndex) const;
+};
+
+#endif // FRAMESNAPSHOT_H
@@ -1,21 +1,409 @@
 #include "game.h"
+#include "levelmanifest.h"
+#include <QDebug>
+#include <QFile>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+
+/**
+ * @brief Copies the state of a character into a snapshot.
+ *
+ * The previous rectangle is the interpolation at 0, which already accounts for teleports.
+ *
+ * @param aCharacter Character to copy.
+ * @param aMover Receives the state.
+ */
+static void captureMover(Character *aCharacter, WorldSnapshot::Mover &aMover)
+{
+    aMover.previousRect = aCharacter->getInterpolatedRect(0.0);
+    aMover.rect = aCharacter->getRect();
+    aMover.hp = aCharacter->getItsHP();
+    aMover.type = aCharacter->getType();
+    aMover.left = false;
+    aMover.right = false;
+    aMover.previousDirection = aCharacter->getPreviousDirection();
+    aMover.dead = aCharacter->getItsDead();
+}
 
 /**
  * @brief Constructor of the Game class.
  *
- * Initializes the game with an initial level and sets up the game timer.
+ * Initializes the game with an initial level and starts the simulation thread.
+ * A headless game has no audio and no thread: its owner calls step() for each tick.
+ * If the initial level cannot be loaded, nothing runs: the owner checks getItsLevel()->isLoaded().
  *
  * @param parent Pointer to the parent object, default is nullptr.
+ * @param aLevelNb Number of the first level.
+ * @param isHeadless True to run without audio and without thread.
+ * @param aSeed Seed of the gameplay random numbers, each level derives its generator from it.
  */
-Game::Game(QObject* parent)
-    : QObject(parent), itsLevel(new Level(0)), itsDead(false), isPaused(false)
+Game::Game(QObject* parent, int aLevelNb, bool isHeadless, quint64 aSeed)
+    : QObject(parent), itsLevel(new Level(aLevelNb, !isHeadless, aSeed)), itsSeed(aSeed), itsDead(false), isPaused(false), itsHeadless(isHeadless)
 {
-    // Set up the game loop timer
-    itsTimer = new QTimer(this);
-    connect(itsTimer, SIGNAL(timeout()), this, SLOT(gameLoop()));
-    itsTimer->start(10); // Start the game loop with a 10 ms interval
-
     playerIsNearDoor = false;
+    itsPool.setMaxThreadCount(1);
+    itsClock.start();
+    captureObstacles();
+    if (itsLevel->isLoaded())
+    {
+        publishSnapshot();
+    }
+    start();
+}
+
+/**
+ * @brief Starts running the ticks on the simulation thread.
+ *
+ * Does nothing when headless, when the thread already runs or when the level was not loaded.
+ * The time spent stopped is not caught up.
+ */
+void Game::start()
+{
+    if (itsHeadless || itsRunning || !itsLevel->isLoaded())
+    {
+        return;
+    }
+    itsScheduler.restart();
+    itsRunning = true;
+    itsPool.start([this]() { run(); });
+}
+
+/**
+ * @brief Stops the simulation thread, after the tick it is running.
+ */
+void Game::stop()
+{
+    itsRunning = false;
+    itsPool.waitForDone();
+}
+
+/**
+ * @brief Returns whether the simulation thread runs the ticks.
+ *
+ * @return True between start() and stop().
+ */
+bool Game::isRunning() const
+{
+    return itsRunning;
+}
+
+/**
+ * @brief Runs the ticks as they are due until stop(), on the simulation thread.
+ *
+ * The world mutex is only held while ticking, the thread sleeps without it until the next tick.
+ */
+void Game::run()
+{
+    while (itsRunning)
+    {
+        qint64 waitNs = 0;
+        {
+            QMutexLocker locker(&itsWorldMutex);
+            advance();
+            waitNs = itsScheduler.getNsecsToNextTick();
+        }
+        QThread::usleep(static_cast<unsigned long>(qBound<qint64>(100, waitNs / 1000, 2000)));
+    }
+}
+
+/**
+ * @brief Runs the game loop ticks that are due.
+ *
+ * Several catch-up ticks can run in one call when the thread woke up late, so the
+ * simulation speed does not depend on the sleep jitter. A snapshot is published after
+ * each tick.
+ */
+void Game::advance()
+{
+    int ticks = itsScheduler.ticksDue();
+    for (int i = 0; i < ticks; ++i)
+    {
+        step();
+        publishSnapshot();
+    }
+}
+
+/**
+ * @brief Runs exactly one tick of the game loop.
+ *
+ * A replay first loads the levels loaded before this tick of the recorded run, and checks the
+ * state of the world once the tick has run.
+ */
+void Game::step()
+{
+    if (itsReplaying)
+    {
+        applyReplayedLevels();
+    }
+    itsTickNb++;
+    itsGameClock.advance(1000000000LL / itsScheduler.getTickRate());
+    Character::setStepScale(static_cast<double>(FixedStepScheduler::DEFAULT_TICK_RATE) / itsScheduler.getTickRate());
+    savePreviousRects();
+    applyInputs();
+    gameLoop();
+    endReplayTick();
+}
+
+/**
+ * @brief Copies the rectangles of the obstacles of the current level.
+ *
+ * The obstacles do not move, the snapshots share this copy instead of copying them after every tick.
+ */
+void Game::captureObstacles()
+{
+    itsObstacleRects.clear();
+    for (Obstacle *obstacle : *itsLevel->getItsObstacles())
+    {
+        itsObstacleRects.append(obstacle->getRect());
+    }
+}
+
+/**
+ * @brief Copies the state of the world into a snapshot and publishes it.
+ *
+ * The snapshot written is a recycled one, every field is overwritten and the vectors keep
+ * their capacity, so a tick does not allocate once the level runs.
+ */
+void Game::publishSnapshot()
+{
+    WorldSnapshot &snapshot = itsSnapshots.back();
+    snapshot.tickNb = itsTickNb;
+    snapshot.gameTimeMs = itsGameClock.getNowMs();
+    snapshot.publishedNs = itsClock.nsecsElapsed();
+    snapshot.alpha = itsScheduler.getAlpha();
+    snapshot.stepNs = 1000000000LL / itsScheduler.getTickRate();
+
+    snapshot.levelNb = itsLevel->getItsNb();
+    snapshot.levelWidth = itsLevel->getItsLevelWidth();
+    snapshot.era = itsLevel->getItsEra();
+    snapshot.hudNb = itsLevel->getItsHUDNb();
+    snapshot.flashbackObjectTotal = itsLevel->getItsFlashbackObjectNb();
+    snapshot.obstacles = itsObstacleRects;
+    snapshot.drawSizes = itsLevel->getItsDrawSizes();
+
+    MainCharacter *mainCharacter = itsLevel->getItsMainCharacter();
+    captureMover(mainCharacter, snapshot.mainCharacter);
+    snapshot.mainCharacter.left = mainCharacter->getItsLeft();
+    snapshot.mainCharacter.right = mainCharacter->getItsRight();
+    snapshot.pieceNb = mainCharacter->getItsPieceNb();
+    snapshot.flashbackObjectNb = mainCharacter->getItsFlashbackObjectNb();
+    snapshot.dead = itsDead;
+    snapshot.playerIsNearDoor = playerIsNearDoor;
+
+    Companion *companion = itsLevel->getItsCompanion();
+    snapshot.companion.previousRect = companion->getInterpolatedRect(0.0);
+    snapshot.companion.rect = companion->getRect();
+    snapshot.companion.left = companion->getItsLeft();
+    snapshot.companion.right = companion->getItsRight();
+    snapshot.companion.previousDirection = companion->getPreviousDirection();
+
+    snapshot.enemies.resize(static_cast<int>(itsLevel->getItsEnemies()->size()));
+    int enemy = 0;
+    for (Character* character : *itsLevel->getItsEnemies())
+    {
+        captureMover(character, snapshot.enemies[enemy++]);
+    }
+
+    snapshot.hasFinalBoss = itsLevel->getItsFinalBoss() != nullptr;
+    if (snapshot.hasFinalBoss)
+    {
+        captureMover(itsLevel->getItsFinalBoss(), snapshot.finalBoss);
+    }
+
+    ClassicBoss* boss = itsLevel->getItsBoss();
+    snapshot.hasBoss = boss != nullptr;
+    snapshot.summonings.clear();
+    if (boss != nullptr)
+    {
+        captureMover(boss, snapshot.boss);
+        snapshot.isSwordVertical = boss->getIsSwordVertical();
+        for (QRect* summoning : *boss->getItsSummoning())
+        {
+            snapshot.summonings.append(*summoning);
+        }
+    }
+
+    snapshot.pieces.clear();
+    for (Piece* piece : *itsLevel->getItsPieces())
+    {
+        snapshot.pieces.append(piece->getRect());
+    }
+    snapshot.flashbackObjects.clear();
+    for (FlashbackObject* object : *itsLevel->getItsFlashbackObjects())
+    {
+        snapshot.flashbackObjects.append({object->getRect(), object->getItsNb()});
+    }
+
+    snapshot.hasDoor = itsLevel->getItsDoor() != nullptr;
+    snapshot.door = snapshot.hasDoor ? itsLevel->getItsDoor()->getRect() : QRect();
+
+    itsSnapshots.publish();
+}
+
+/**
+ * @brief Returns the mutex to lock to change the world from another thread than the simulation one.
+ *
+ * @return The world mutex.
+ */
+QMutex *Game::getItsWorldMutex()
+{
+    return &itsWorldMutex;
+}
+
+/**
+ * @brief Posts an input command, applied at the start of the next tick.
+ *
+ * The command is dated on the clock of the game, to measure how long it waits for its tick.
+ *
+ * @param anAction Action of the player.
+ * @param isPressed True when the key was pressed, false when it was released.
+ * @return False if the queue is full.
+ */
+bool Game::postInput(InputAction anAction, bool isPressed)
+{
+    InputCommand command;
+    command.timeNs = itsClock.nsecsElapsed();
+    command.action = anAction;
+    command.pressed = isPressed;
+    if (!itsInputs.push(command))
+    {
+        qDebug() << "Input queue full, command dropped";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the longest wait of an input command before its tick, and resets it.
+ *
+ * @return Time in nanoseconds since the last call.
+ */
+qint64 Game::takeInputWaitNs()
+{
+    return itsInputWaitNs.exchange(0);
+}
+
+/**
+ * @brief Applies the input commands posted since the last tick.
+ *
+ * The queue is drained once per tick, so the tick sees every key event in the order it happened
+ * and the rest of the tick reads one settled input state. Several attacks posted during the
+ * same tick only attack once. A replay applies the commands recorded for this tick instead,
+ * and a recording stores every command with the tick it is applied at.
+ */
+void Game::applyInputs()
+{
+    qint64 nowNs = itsClock.nsecsElapsed();
+    bool hasAttacked = false;
+
+    InputCommand command;
+    while (itsInputs.pop(command))
+    {
+        if (itsReplaying)
+        {
+            continue;
+        }
+        qint64 waitNs = nowNs - command.timeNs;
+        if (waitNs > itsInputWaitNs.load(std::memory_order_relaxed))
+        {
+            itsInputWaitNs.store(waitNs, std::memory_order_relaxed);
+        }
+
+        if (!itsRecordPath.isEmpty())
+        {
+            ReplayFormat::Record record = {};
+            record.tick = itsReplayTick;
+            record.kind = ReplayFormat::Input;
+            record.parameter = static_cast<quint8>(command.action);
+            record.value = command.pressed ? 1 : 0;
+            itsRecording.records.push_back(record);
+        }
+        applyInput(command.action, command.pressed, hasAttacked);
+    }
+
+    while (itsReplaying && itsReplayRecord < itsReplay.records.size()
+           && itsReplay.records[itsReplayRecord].tick == itsReplayTick
+           && itsReplay.records[itsReplayRecord].kind == ReplayFormat::Input)
+    {
+        const ReplayFormat::Record &record = itsReplay.records[itsReplayRecord++];
+        applyInput(static_cast<InputAction>(record.parameter), record.value != 0, hasAttacked);
+    }
+}
+
+/**
+ * @brief Applies one input command to the main character and the companion.
+ *
+ * @param anAction Action of the player.
+ * @param isPressed True when the key was pressed, false when it was released.
+ * @param hasAttacked True once the main character attacked during this tick, set by an attack.
+ */
+void Game::applyInput(InputAction anAction, bool isPressed, bool &hasAttacked)
+{
+    MainCharacter *mainCharacter = itsLevel->getItsMainCharacter();
+    Companion *companion = itsLevel->getItsCompanion();
+
+    switch (anAction)
+    {
+    case InputAction::Left:
+        if (isPressed)
+        {
+            mainCharacter->setPreviousDirection(true);
+        }
+        mainCharacter->moveLeft(isPressed);
+        companion->moveLeft(isPressed);
+        break;
+    case InputAction::Right:
+        if (isPressed)
+        {
+            mainCharacter->setPreviousDirection(false);
+        }
+        mainCharacter->moveRight(isPressed);
+        companion->moveRight(isPressed);
+        break;
+    case InputAction::Jump:
+        mainCharacter->jump(isPressed);
+        companion->jump(isPressed);
+        break;
+    case InputAction::Attack:
+        if (isPressed && !hasAttacked)
+        {
+            attackMC();
+            hasAttacked = true;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Returns the last snapshot of the world, only called by the GUI thread.
+ *
+ * @return The snapshot, valid until the next call.
+ */
+const WorldSnapshot &Game::getSnapshot()
+{
+    itsSnapshots.update();
+    return itsSnapshots.front();
+}
+
+/**
+ * @brief Stores the rectangles of every mover before a tick.
+ */
+void Game::savePreviousRects()
+{
+    itsLevel->getItsMainCharacter()->savePreviousRect();
+    itsLevel->getItsCompanion()->savePreviousRect();
+
+    for (Character* character : *itsLevel->getItsEnemies())
+    {
+        character->savePreviousRect();
+    }
+
+    if (itsLevel->getItsFinalBoss() != nullptr)
+    {
+        itsLevel->getItsFinalBoss()->savePreviousRect();
+    }
 }
 
 /**
@@ -26,41 +414,70 @@ Game::Game(QObject* parent)
  */
 void Game::gameLoop()
 {
+    if (itsProfiling)
+    {
+        itsPhaseStartNs = itsPhaseClock.nsecsElapsed();
+    }
+
     if (itsLevel->getItsBoss() != nullptr)
     {
         itsLevel->getItsBoss()->attack();
     }
+    endPhase(BossPhase);
 
     if (!itsDead)
-        itsLevel->getItsMainCharacter()->updatePosition(itsLevel->getItsObstacles());
+        itsLevel->getItsMainCharacter()->updatePosition(itsLevel->getItsObstacleGrid());
+    endPhase(MainCharacterPhase);
 
-    itsLevel->getItsCompanion()->updatePosition(itsLevel->getItsObstacles(), itsLevel->getItsFlashbackObjects());
+    itsLevel->getItsCompanion()->updatePosition(itsLevel->getItsObstacleGrid(), itsLevel->getItsFlashbackObjects());
+    endPhase(CompanionPhase);
 
     for (Character* character : *itsLevel->getItsEnemies())
     {
         if (character != nullptr)
         {
-            character->updatePosition(itsLevel->getItsObstacles());
+            character->updatePosition(itsLevel->getItsObstacleGrid());
             //character->attack(itsMainCharacter);
         }
     }
+    endPhase(EnemiesPhase);
 
     if (itsLevel->getItsFinalBoss() != nullptr)
     {
-        itsLevel->getItsFinalBoss()->updatePosition(itsLevel->getItsObstacles());
+        itsLevel->getItsFinalBoss()->updatePosition(itsLevel->getItsObstacleGrid());
     }
+    endPhase(FinalBossPhase);
 
     checkPlayerCollisions();
+    endPhase(CollisionsPhase);
+}
+
+/**
+ * @brief Adds the time elapsed since the previous phase to a phase.
+ *
+ * Does nothing when profiling is disabled.
+ *
+ * @param aPhase Phase that just ended.
+ */
+void Game::endPhase(Phase aPhase)
+{
+    if (itsProfiling)
+    {
+        qint64 now = itsPhaseClock.nsecsElapsed();
+        itsPhaseNs[aPhase] += now - itsPhaseStartNs;
+        itsPhaseStartNs = now;
+    }
 }
 
 /**
  * @brief Destructor of the Game class.
  *
- * Frees allocated memory for the timer and the level.
+ * Stops the simulation thread, writes the replay being recorded and frees the level.
  */
 Game::~Game()
 {
-    delete itsTimer;
+    stop();
+    stopRecording();
     delete itsLevel;
 }
 
@@ -114,11 +531,10 @@ void Game::attackMC()
         // Add enemies periodically when final boss loses health
         if (itsLevel->getItsFinalBoss()->getItsHP() <= 0 && itsLevel->getItsFinalBoss()->getItsHP() % 4 == 0)
         {
-            std::srand(static_cast<unsigned int>(std::time(nullptr)));
-            int x = std::rand() % (1030 - 50 + 1) + 50;
+            int x = itsLevel->getItsRandom()->bounded(50, 1030);
             int y = itsLevel->getItsFinalBoss()->getRect().y();
 
-            ShortScope* newEnemy = new ShortScope(x, y, 100, 115, 1);
+            ShortScope* newEnemy = itsLevel->getItsArena()->create<ShortScope>(x, y, 100, 115, 1);
             itsLevel->getItsEnemies()->push_back(newEnemy);
         }
     }
@@ -174,8 +590,7 @@ void Game::checkPlayerCollisions()
             {
                 it = summonings->erase(it);
                 delete summoning;
-                std::srand(static_cast<unsigned int>(std::time(nullptr)));
-                boss->setItsPhase(std::rand() % 3 + 1);
+                boss->setItsPhase(itsLevel->getItsRandom()->bounded(1, 3));
                 boss->setIsAttacking(false);
             }
             else
@@ -184,10 +599,9 @@ void Game::checkPlayerCollisions()
             }
         }
 
-        // Delete boss if it's dead and has no summonings left
+        // Remove the boss if it's dead and has no summonings left, the level arena frees it
         if (boss->getItsHP() <= 0 && summonings->empty())
         {
-            delete boss;
             itsLevel->setItsBoss(nullptr);
         }
     }
@@ -200,7 +614,6 @@ void Game::checkPlayerCollisions()
         {
             itsLevel->getItsMainCharacter()->addPiece();
             it = itsLevel->getItsPieces()->erase(it);
-            delete piece;
         }
         else
         {
@@ -215,9 +628,8 @@ void Game::checkPlayerCollisions()
         if (playerHitbox.intersects(object->getRect()))
         {
             itsLevel->getItsMainCharacter()->addFlashbackObject();
-            emit objectCollected(object->getItsText());
+            emit objectCollected(object->getItsText(), itsGameClock.getNowMs());
             it = itsLevel->getItsFlashbackObjects()->erase(it);
-            delete object;
         }
         else
         {
@@ -232,7 +644,7 @@ void Game::checkPlayerCollisions()
         if (playerHitbox.intersects(enemy->getRect()))
         {
             isAnyCollision = true;
-            itsLevel->getItsMainCharacter()->startCollision();
+            itsLevel->getItsMainCharacter()->startCollision(itsGameClock.getNowMs());
             break;
         }
     }
@@ -241,7 +653,7 @@ void Game::checkPlayerCollisions()
     if (itsLevel->getItsFinalBoss() != nullptr && playerHitbox.intersects(itsLevel->getItsFinalBoss()->getRect()))
     {
         isAnyCollision = true;
-        itsLevel->getItsMainCharacter()->startCollision();
+        itsLevel->getItsMainCharacter()->startCollision(itsGameClock.getNowMs());
     }
 
     // End collision state if no collision detected
@@ -251,7 +663,7 @@ void Game::checkPlayerCollisions()
     }
 
     // Reduce main character's health if collision state persists
-    if (itsLevel->getItsMainCharacter()->checkCollisionDuration())
+    if (itsLevel->getItsMainCharacter()->checkCollisionDuration(itsGameClock.getNowMs()))
     {
         itsLevel->getItsMainCharacter()->setItsHP(itsLevel->getItsMainCharacter()->getItsHP() - 1);
         if (itsLevel->getItsMainCharacter()->getItsHP() <= 0)
@@ -261,11 +673,8 @@ void Game::checkPlayerCollisions()
         }
     }
 
-    // Emit signal for door collision
-    if (itsLevel->getItsDoor() && playerHitbox.intersects(itsLevel->getItsDoor()->getRect()))
-    {
-        emit onDoorCollision();
-    }
+    // Whether the player can go through the door, the GUI reads it from the snapshot
+    onDoorCollision();
 }
 
 /**
@@ -289,27 +698,71 @@ bool Game::getItsDead()
 }
 
 /**
- * @brief Retrieves the game timer.
+ * @brief Retrieves the seed of the gameplay random numbers.
  *
- * @return Pointer to the QTimer object used for the game.
+ * @return Seed given to the constructor.
  */
-QTimer* Game::getItsTimer()
+quint64 Game::getItsSeed() const
 {
-    return itsTimer;
+    return itsSeed;
 }
 
 /**
  * @brief Loads the next level in the game.
  *
  * Deletes the current Level object and loads the next level by incrementing its number.
- * Also resets the player's near door state.
+ * A level prefetched by a worker is swapped in as is, only its generator is reseeded and
+ * its music is started here.
+ * Also resets the player's near door state. Called on the GUI thread, the simulation
+ * thread waits for the swap.
+ *
+ * @param aPrefetchedLevel Next level already built, nullptr to build it now.
+ * @return False if the next level could not be loaded.
  */
-void Game::loadNextLevel()
+bool Game::loadNextLevel(Level *aPrefetchedLevel)
 {
+    QMutexLocker locker(&itsWorldMutex);
     int nextLevelNumber = itsLevel->getItsNb() + 1;
-    delete itsLevel;
-    itsLevel = new Level(nextLevelNumber);
-    playerIsNearDoor = false;
+    bool loaded = false;
+    if (aPrefetchedLevel != nullptr)
+    {
+        aPrefetchedLevel->setSeed(itsSeed);
+        loaded = replaceLevel(aPrefetchedLevel, false);
+        if (loaded && !itsHeadless)
+        {
+            itsLevel->startMusic();
+        }
+    }
+    else
+    {
+        loaded = replaceLevel(new Level(nextLevelNumber, !itsHeadless, itsSeed), false);
+    }
+    locker.unlock();
+    if (loaded)
+    {
+        emit levelLoaded();
+    }
+    return loaded;
+}
+
+/**
+ * @brief Loads a fresh copy of a level.
+ *
+ * Deletes the current Level object and resets the player's dead and near door states.
+ *
+ * @param aNumber Number of the level to load.
+ * @return False if the level could not be loaded.
+ */
+bool Game::loadLevel(int aNumber)
+{
+    QMutexLocker locker(&itsWorldMutex);
+    bool loaded = replaceLevel(new Level(aNumber, !itsHeadless, itsSeed), true);
+    locker.unlock();
+    if (loaded)
+    {
+        emit levelLoaded();
+    }
+    return loaded;
 }
 
 /**
@@ -353,20 +806,348 @@ void Game::onDoorCollision()
     }
 }
 
+/**
+ * @brief Replaces the current level, called with the world mutex locked.
+ *
+ * A recording stores the load with the tick it happens before. A level built by the GUI thread
+ * owns a music player, which must be deleted on that thread, so a replay running on the
+ * simulation thread hands the previous level over to it. A level that was not loaded has no
+ * characters to play, it is deleted and the current level is kept.
+ *
+ * @param aLevel New level, taken over by the game.
+ * @param isDeadReset True to bring the player back to life.
+ * @return False if the new level was not loaded.
+ */
+bool Game::replaceLevel(Level *aLevel, bool isDeadReset)
+{
+    if (!aLevel->isLoaded())
+    {
+        qDebug() << "Level" << aLevel->getItsNb() << "could not be loaded, the current level is kept";
+        delete aLevel;
+        return false;
+    }
+
+    Level *previous = itsLevel;
+    itsLevel = aLevel;
+    if (previous != nullptr && !itsHeadless && QThread::currentThread() != thread())
+    {
+        QMetaObject::invokeMethod(this, [previous]() { delete previous; }, Qt::QueuedConnection);
+    }
+    else
+    {
+        delete previous;
+    }
+
+    if (isDeadReset)
+    {
+        itsDead = false;
+    }
+    playerIsNearDoor = false;
+    itsTickNb = 0;
+    captureObstacles();
+
+    if (!itsRecordPath.isEmpty())
+    {
+        ReplayFormat::Record record = {};
+        record.tick = itsReplayTick;
+        record.kind = ReplayFormat::LoadLevel;
+        record.parameter = isDeadReset ? 1 : 0;
+        record.value = aLevel->getItsNb();
+        itsRecording.records.push_back(record);
+    }
+    publishSnapshot();
+    return true;
+}
+
+/**
+ * @brief Starts recording the inputs and the level loads into a replay.
+ *
+ * The current level is loaded again and the game clock starts from zero, so the recorded run
+ * starts like its replays.
+ *
+ * @param aPath File the replay is written to by stopRecording().
+ * @return False if the current level could not be loaded again.
+ */
+bool Game::startRecording(const QString &aPath)
+{
+    QMutexLocker locker(&itsWorldMutex);
+    int levelNb = itsLevel->getItsNb();
+    if (!replaceLevel(new Level(levelNb, !itsHeadless, itsSeed), true))
+    {
+        return false;
+    }
+
+    itsRecording = ReplayFormat::Replay();
+    itsRecording.seed = itsSeed;
+    itsRecording.levelNb = levelNb;
+    itsRecording.tickRate = static_cast<quint32>(itsScheduler.getTickRate());
+    itsRecordPath = aPath;
+    itsReplayTick = 0;
+    itsGameClock.reset();
+    locker.unlock();
+    emit levelLoaded();
+    return true;
+}
+
+/**
+ * @brief Stops the recording and writes the replay.
+ *
+ * @return False if nothing was recorded or the file could not be written.
+ */
+bool Game::stopRecording()
+{
+    QMutexLocker locker(&itsWorldMutex);
+    if (itsRecordPath.isEmpty())
+    {
+        return false;
+    }
+    std::vector<unsigned char> blob;
+    ReplayFormat::write(itsRecording, blob);
+    QString path = itsRecordPath;
+    itsRecordPath.clear();
+    itsRecording = ReplayFormat::Replay();
+    locker.unlock();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(reinterpret_cast<const char *>(blob.data()), qint64(blob.size())) != qint64(blob.size()))
+    {
+        qDebug() << "Failed to write replay" << path;
+        return false;
+    }
+    qDebug() << "Replay written to" << path << ":" << blob.size() << "bytes";
+    return true;
+}
+
+/**
+ * @brief Starts playing a replay.
+ *
+ * The seed and the tick rate of the recorded run replace those of the game, and the first level
+ * of the replay is loaded with the game clock back at zero. Every level and every input command of the replay must be valid, so
+ * that a damaged replay is refused before it runs.
+ *
+ * @param aPath File written by stopRecording().
+ * @return False if the replay cannot be read or is invalid.
+ */
+bool Game::startReplay(const QString &aPath)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qDebug() << "Failed to open replay" << aPath;
+        return false;
+    }
+    QByteArray content = file.readAll();
+    ReplayFormat::Replay replay;
+    std::string error;
+    if (!ReplayFormat::read(reinterpret_cast<const uchar *>(content.constData()), size_t(content.size()), replay, error))
+    {
+        qDebug() << "Invalid replay" << aPath << ":" << QString::fromStdString(error);
+        return false;
+    }
+
+    // The loads of a tick must come before its inputs, as they are recorded
+    int levelCount = LevelManifest::instance().getItsLevelNb();
+    bool valid = replay.levelNb >= 0 && replay.levelNb < levelCount;
+    for (size_t index = 0; valid && index < replay.records.size(); ++index)
+    {
+        const ReplayFormat::Record &record = replay.records[index];
+        if (record.kind == ReplayFormat::LoadLevel)
+        {
+            valid = record.value >= 0 && record.value < levelCount
+                    && (index == 0 || replay.records[index - 1].tick != record.tick
+                        || replay.records[index - 1].kind == ReplayFormat::LoadLevel);
+        }
+        else
+        {
+            valid = record.parameter <= static_cast<quint8>(InputAction::Attack);
+        }
+    }
+    if (!valid)
+    {
+        qDebug() << "Invalid replay" << aPath << ": unknown level or input";
+        return false;
+    }
+
+    QMutexLocker locker(&itsWorldMutex);
+    if (!replaceLevel(new Level(replay.levelNb, !itsHeadless, replay.seed), true))
+    {
+        return false;
+    }
+    itsSeed = replay.seed;
+    itsScheduler.setTickRate(static_cast<int>(replay.tickRate));
+    itsReplay = std::move(replay);
+    itsReplayRecord = 0;
+    itsReplayTick = 0;
+    itsGameClock.reset();
+    itsDivergentTick = -1;
+    itsReplaying = !itsReplay.hashes.empty();
+    qDebug() << "Replaying" << aPath << ":" << itsReplay.hashes.size() << "ticks from level" << itsReplay.levelNb
+             << "with seed" << itsSeed;
+    locker.unlock();
+    emit levelLoaded();
+    return true;
+}
+
+/**
+ * @brief Returns whether a replay is playing.
+ *
+ * @return True from startReplay() until the last tick of the replay has run.
+ */
+bool Game::isReplaying() const
+{
+    return itsReplaying;
+}
+
+/**
+ * @brief Returns the number of ticks of the last replay started.
+ *
+ * @return Number of ticks recorded.
+ */
+quint32 Game::getReplayTickNb() const
+{
+    return static_cast<quint32>(itsReplay.hashes.size());
+}
+
+/**
+ * @brief Returns the first tick at which the replay differed from the recorded run.
+ *
+ * @return Tick counted from the start of the replay, -1 if every tick so far was identical.
+ */
+qint64 Game::getDivergentTick() const
+{
+    return itsDivergentTick;
+}
+
+/**
+ * @brief Loads the levels the recorded run loaded before the current tick.
+ *
+ * The levels are built without music, since this may run on the simulation thread: the music
+ * of the last one is started on the GUI thread, as long as it is still the current level. A level
+ * that cannot be loaded ends the replay, reported as diverged at this tick.
+ */
+void Game::applyReplayedLevels()
+{
+    bool loaded = false;
+    while (itsReplayRecord < itsReplay.records.size()
+           && itsReplay.records[itsReplayRecord].tick == itsReplayTick
+           && itsReplay.records[itsReplayRecord].kind == ReplayFormat::LoadLevel)
+    {
+        const ReplayFormat::Record &record = itsReplay.records[itsReplayRecord++];
+        if (!replaceLevel(new Level(record.value, false, itsSeed), record.parameter != 0))
+        {
+            itsReplaying = false;
+            if (itsDivergentTick < 0)
+            {
+                itsDivergentTick = itsReplayTick;
+            }
+            qDebug() << "Replay stopped at tick" << itsReplayTick << ": level" << record.value << "could not be loaded";
+            break;
+        }
+        loaded = true;
+    }
+    if (loaded)
+    {
+        if (!itsHeadless)
+        {
+            Level *level = itsLevel;
+            QMetaObject::invokeMethod(this, [this, level]()
+            {
+                QMutexLocker locker(&itsWorldMutex);
+                if (itsLevel == level)
+                {
+                    level->startMusic();
+                }
+            }, Qt::QueuedConnection);
+        }
+        emit levelLoaded();
+    }
+}
+
+/**
+ * @brief Records or checks the state of the world after a tick.
+ *
+ * A recording stores the hash of the state, a replay compares it with the recorded one and
+ * reports the first tick that differs. The replay ends after its last tick, the game then
+ * goes on with the inputs of the player.
+ */
+void Game::endReplayTick()
+{
+    if (!itsRecordPath.isEmpty())
+    {
+        itsRecording.hashes.push_back(hashState());
+    }
+    if (itsReplaying)
+    {
+        if (itsDivergentTick < 0 && hashState() != itsReplay.hashes[itsReplayTick])
+        {
+            itsDivergentTick = itsReplayTick;
+            qDebug() << "Replay diverged at tick" << itsReplayTick;
+        }
+        if (itsReplayTick + 1 >= itsReplay.hashes.size())
+        {
+            itsReplaying = false;
+            qDebug() << "Replay finished:" << itsReplay.hashes.size() << "ticks,"
+                     << (itsDivergentTick < 0 ? "identical to the recorded run" : "diverged");
+        }
+    }
+    itsReplayTick++;
+}
+
+/**
+ * @brief Hashes the state of the world a replay must reproduce.
+ *
+ * Covers the rectangle and the health of the main character and the rectangles of the enemies,
+ * which every difference in the inputs, the random numbers or the physics ends up moving.
+ *
+ * @return Hash of the state.
+ */
+quint32 Game::hashState() const
+{
+    quint32 hash = ReplayFormat::HASH_START;
+    auto addRect = [&hash](const QRect &aRect)
+    {
+        hash = ReplayFormat::hashValue(hash, aRect.x());
+        hash = ReplayFormat::hashValue(hash, aRect.y());
+        hash = ReplayFormat::hashValue(hash, aRect.width());
+        hash = ReplayFormat::hashValue(hash, aRect.height());
+    };
+
+    MainCharacter *mainCharacter = itsLevel->getItsMainCharacter();
+    addRect(mainCharacter->getRect());
+    hash = ReplayFormat::hashValue(hash, mainCharacter->getItsHP());
+    for (Character *enemy : *itsLevel->getItsEnemies())
+    {
+        if (enemy != nullptr)
+        {
+            addRect(enemy->getRect());
+        }
+    }
+    return hash;
+}
+
 /**
  * @brief Restarts the current level.
  *
  * Deletes the current Level object and creates a new Level with the initial level number.
- * Also resets the game "dead" state and restarts the game timer.
+ * Also resets the game "dead" state and restarts the simulation thread. If the level cannot
+ * be loaded, the game stays stopped on the current one.
+ *
+ * @return False if the level could not be loaded.
  */
-void Game::restartLevel()
+bool Game::restartLevel()
 {
-    delete itsLevel;
-    itsLevel = new Level(1); // or use another level number if needed
-
-    itsDead = false;
+    QMutexLocker locker(&itsWorldMutex);
+    if (!replaceLevel(new Level(1, !itsHeadless, itsSeed), true)) // or use another level number if needed
+    {
+        return false;
+    }
+    itsScheduler.restart();
+    locker.unlock();
+    emit levelLoaded();
 
-    itsTimer->start();
+    start();
+    return true;
 }
 
 /**
@@ -389,3 +1170,91 @@ void Game::setIsPaused(bool status)
     isPaused = status;
 }
 
+/**
+ * @brief Sets the simulation rate.
+ *
+ * The gameplay speeds are tuned for 100 Hz, each tick scales them by its duration, so the
+ * game runs at the same speed at every rate.
+ *
+ * @param aTickRate Ticks per second, one of 60, 100, 120 or 240.
+ */
+void Game::setTickRate(int aTickRate)
+{
+    QMutexLocker locker(&itsWorldMutex);
+    itsScheduler.setTickRate(aTickRate);
+}
+
+/**
+ * @brief Gets the simulation rate.
+ *
+ * @return Ticks per second.
+ */
+int Game::getTickRate() const
+{
+    return itsScheduler.getTickRate();
+}
+
+/**
+ * @brief Gets the interpolation factor between the tick of the last snapshot and the next one.
+ *
+ * The snapshot taken by the GUI thread is dated on the clock of the game, which both threads read.
+ *
+ * @return Factor between 0 and 1.
+ */
+double Game::getInterpolationAlpha() const
+{
+    return itsSnapshots.front().getAlpha(itsClock.nsecsElapsed());
+}
+
+/**
+ * @brief Enables or disables the measure of each phase of the game loop.
+ *
+ * @param enabled True to measure the phases, the previous measures are reset.
+ */
+void Game::setProfiling(bool enabled)
+{
+    itsProfiling = enabled;
+    if (enabled)
+    {
+        std::fill(std::begin(itsPhaseNs), std::end(itsPhaseNs), 0);
+        itsPhaseClock.start();
+    }
+}
+
+/**
+ * @brief Gets the time spent in a phase of the game loop.
+ *
+ * @param aPhase Phase of the game loop.
+ * @return Time in nanoseconds since profiling was enabled.
+ */
+qint64 Game::getPhaseNsecs(Phase aPhase) const
+{
+    return itsPhaseNs[aPhase];
+}
+
+/**
+ * @brief Gets a readable name for a phase of the game loop.
+ *
+ * @param aPhase Phase of the game loop.
+ * @return Name of the phase.
+ */
+QString Game::getPhaseName(Phase aPhase)
+{
+    switch (aPhase)
+    {
+    case BossPhase:
+        return "boss";
+    case MainCharacterPhase:
+        return "main character";
+    case CompanionPhase:
+        return "companion";
+    case EnemiesPhase:
+        return "enemies";
+    case FinalBossPhase:
+        return "final boss";
+    case CollisionsPhase:
+        return "collisions";
+    default:
+        return "unknown";
+    }
+}
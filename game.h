@@ -2,10 +2,20 @@
 #define GAME_H
 
 #include <QObject>
-#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThreadPool>
+#include <atomic>
 #include "level.h"
 #include "menu.h"
 #include "shortscope.h"
+#include "fixedstepscheduler.h"
+#include "gameclock.h"
+#include "inputcommand.h"
+#include "replayformat.h"
+#include "spscqueue.h"
+#include "triplebuffer.h"
+#include "worldsnapshot.h"
 #include <QLabel>
 
 using namespace std;
@@ -13,24 +23,166 @@ using namespace std;
 /**
  * @brief Class representing the main game logic.
  *
- * Inherits from QObject to use Qt's signal and slot mechanism.
+ * Inherits from QObject to use Qt's signal and slot mechanism. Unless headless, the ticks run on
+ * a simulation thread, which publishes a WorldSnapshot after each one: the GUI draws from the
+ * snapshots, so a slow frame does not delay the physics. The inputs reach the simulation through
+ * a lock-free queue of commands, the GUI thread only locks the world mutex to swap the level.
+ * The commands and the level loads can be recorded with the tick they apply at, and played again
+ * tick for tick from the replay file, with or without GUI.
  */
 class Game : public QObject
 {
     Q_OBJECT
 
+public:
+    /**
+     * @brief Steps of the game loop measured when profiling is enabled.
+     */
+    enum Phase
+    {
+        BossPhase,
+        MainCharacterPhase,
+        CompanionPhase,
+        EnemiesPhase,
+        FinalBossPhase,
+        CollisionsPhase,
+        PhaseCount
+    };
+
+private:
     Level * itsLevel; ///< Pointer to the current level in the game
-    QTimer *itsTimer; ///< Timer to manage the game loop
+    quint64 itsSeed = 0; ///< Seed of the gameplay random numbers, each level derives its generator from it
+    QThreadPool itsPool; ///< Simulation thread, unused when headless
+    std::atomic<bool> itsRunning{false}; ///< True while the simulation thread runs the ticks
+    QMutex itsWorldMutex; ///< Held by the simulation thread during the ticks, and by the GUI thread to change the world
+    FixedStepScheduler itsScheduler; ///< Decides how many ticks of the game loop are due
+    GameClock itsGameClock; ///< Time of the simulation, moved by each tick, read by the timers of the entities
+    QElapsedTimer itsClock; ///< Clock the snapshots are dated with, read by both threads
+    TripleBuffer<WorldSnapshot> itsSnapshots; ///< Hands the snapshots from the thread that ticks to the GUI thread
+    SpscQueue<InputCommand, 256> itsInputs; ///< Commands posted by the GUI thread, drained at the start of each tick
+    std::atomic<qint64> itsInputWaitNs{0}; ///< Longest wait of a command before its tick since the last read
+    quint32 itsReplayTick = 0; ///< Ticks run since the recording or the replay started
+    QString itsRecordPath; ///< File the recording is written to, empty when not recording
+    ReplayFormat::Replay itsRecording; ///< Events and hashes recorded so far
+    ReplayFormat::Replay itsReplay; ///< Replay being played
+    size_t itsReplayRecord = 0; ///< Next event of the replay to apply
+    std::atomic<bool> itsReplaying{false}; ///< True while a replay drives the inputs and the level loads
+    qint64 itsDivergentTick = -1; ///< First tick the replay differed at, -1 if none
+    QVector<QRect> itsObstacleRects; ///< Obstacles of the current level, shared with every snapshot
+    quint64 itsTickNb = 0; ///< Number of ticks run in the current level
     bool itsDead = false; ///< Flag indicating if the player is dead
     bool isPaused = false;
+    bool itsHeadless = false; ///< True when the game runs without GUI, audio nor timer
+    bool itsProfiling = false; ///< True to measure the time spent in each phase of the game loop
+    QElapsedTimer itsPhaseClock; ///< Clock used to measure the phases
+    qint64 itsPhaseStartNs = 0; ///< Clock value at the start of the current phase
+    qint64 itsPhaseNs[PhaseCount] = {}; ///< Time spent in each phase since profiling was enabled
 
 public:
     /**
      * @brief Constructor to initialize the game.
      *
      * @param parent Parent object, default is nullptr
+     * @param aLevelNb Number of the first level
+     * @param isHeadless True to run without audio and without timer, ticks are then driven by step()
+     * @param aSeed Seed of the gameplay random numbers, the same seed replays the same numbers
+     */
+    Game(QObject *parent = nullptr, int aLevelNb = 0, bool isHeadless = false, quint64 aSeed = 0);
+
+    /**
+     * @brief Starts running the ticks on the simulation thread.
+     *
+     * Does nothing when headless, or when the first level could not be loaded.
+     */
+    void start();
+
+    /**
+     * @brief Stops the simulation thread, after the tick it is running.
+     */
+    void stop();
+
+    /**
+     * @brief Returns whether the simulation thread runs the ticks.
+     *
+     * @return True between start() and stop()
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Returns the mutex to lock to change the world from another thread than the simulation one.
+     *
+     * @return The world mutex
+     */
+    QMutex *getItsWorldMutex();
+
+    /**
+     * @brief Posts an input command, applied at the start of the next tick.
+     *
+     * Only called by one thread, the GUI one, and never blocks.
+     *
+     * @param anAction Action of the player
+     * @param isPressed True when the key was pressed, false when it was released
+     * @return False if the queue is full, the command is then dropped
+     */
+    bool postInput(InputAction anAction, bool isPressed);
+
+    /**
+     * @brief Returns the longest wait of an input command before its tick, and resets it.
+     *
+     * @return Time in nanoseconds since the last call
+     */
+    qint64 takeInputWaitNs();
+
+    /**
+     * @brief Starts recording the inputs and the level loads, from a fresh copy of the current level.
+     *
+     * @param aPath File the replay is written to
+     * @return False if the current level could not be loaded again, nothing is recorded then
+     */
+    bool startRecording(const QString &aPath);
+
+    /**
+     * @brief Stops the recording and writes the replay file.
+     *
+     * @return False if nothing was recorded or the file could not be written
+     */
+    bool stopRecording();
+
+    /**
+     * @brief Plays a replay: its seed, first level, inputs and level loads replace those of the game.
+     *
+     * @param aPath Replay file
+     * @return False if the replay cannot be read or is invalid
+     */
+    bool startReplay(const QString &aPath);
+
+    /**
+     * @brief Returns whether a replay is playing.
+     *
+     * @return True until the last tick of the replay has run
+     */
+    bool isReplaying() const;
+
+    /**
+     * @brief Returns the number of ticks of the last replay started.
+     *
+     * @return Number of ticks
      */
-    Game(QObject *parent = nullptr);
+    quint32 getReplayTickNb() const;
+
+    /**
+     * @brief Returns the first tick at which the replay differed from the recorded run.
+     *
+     * @return Tick counted from the start of the replay, -1 if none
+     */
+    qint64 getDivergentTick() const;
+
+    /**
+     * @brief Returns the last snapshot of the world, only called by the GUI thread.
+     *
+     * @return The snapshot, valid until the next call
+     */
+    const WorldSnapshot &getSnapshot();
 
     /**
      * @brief Destructor to clean up resources.
@@ -56,14 +208,40 @@ public:
      */
     bool getItsDead();
 
+    /**
+     * @brief Returns the seed of the gameplay random numbers.
+     *
+     * @return Seed given to the constructor
+     */
+    quint64 getItsSeed() const;
+
     /**
      * @brief Initiates an attack by the main character.
      */
     void attackMC();
 
-    void loadNextLevel();
+    /**
+     * @brief Replaces the current level with the next one.
+     *
+     * @param aPrefetchedLevel Next level already built, taken over by the game, nullptr to build it now
+     * @return False if the next level could not be loaded, the current level is kept
+     */
+    bool loadNextLevel(Level *aPrefetchedLevel = nullptr);
 
-    void restartLevel();
+    /**
+     * @brief Replaces the current level with a fresh copy of the given level.
+     *
+     * @param aNumber Number of the level to load
+     * @return False if the level could not be loaded, the current level is kept
+     */
+    bool loadLevel(int aNumber);
+
+    /**
+     * @brief Restarts the game from the first level and restarts the simulation thread.
+     *
+     * @return False if the level could not be loaded, the game then stays stopped
+     */
+    bool restartLevel();
 
     bool playerIsNearDoor;
 
@@ -71,21 +249,163 @@ public:
 
     void setIsPaused(bool statut);
 
-    QTimer *getItsTimer();
-
      void onDoorCollision();
-private slots:
+
+    /**
+     * @brief Sets the simulation rate.
+     *
+     * The gameplay speeds are tuned for 100 Hz and scaled to the rate.
+     *
+     * @param aTickRate Ticks per second, one of 60, 100, 120 or 240
+     */
+    void setTickRate(int aTickRate);
+
+    /**
+     * @brief Returns the simulation rate.
+     *
+     * @return Ticks per second
+     */
+    int getTickRate() const;
+
+    /**
+     * @brief Returns how far the clock is between the tick of the last snapshot and the next one.
+     *
+     * Only called by the GUI thread, after getSnapshot().
+     *
+     * @return Interpolation factor between 0 and 1, used to render in-between ticks
+     */
+    double getInterpolationAlpha() const;
+
+    /**
+     * @brief Runs exactly one tick of the game loop.
+     *
+     * Used to drive the game without timer, for example in headless mode.
+     */
+    void step();
+
+    /**
+     * @brief Enables or disables the measure of each phase of the game loop.
+     *
+     * Enabling it resets the measures.
+     *
+     * @param enabled True to measure the phases
+     */
+    void setProfiling(bool enabled);
+
+    /**
+     * @brief Returns the time spent in a phase of the game loop.
+     *
+     * @param aPhase Phase of the game loop
+     * @return Time in nanoseconds since profiling was enabled
+     */
+    qint64 getPhaseNsecs(Phase aPhase) const;
+
+    /**
+     * @brief Returns a readable name for a phase of the game loop.
+     *
+     * @param aPhase Phase of the game loop
+     * @return Name of the phase
+     */
+    static QString getPhaseName(Phase aPhase);
+
+private:
+    /**
+     * @brief Runs the ticks as they are due until stop(), on the simulation thread.
+     */
+    void run();
+
+    /**
+     * @brief Runs every game loop tick that is due since the last call, and publishes a snapshot after each.
+     */
+    void advance();
+
+    /**
+     * @brief Applies the input commands posted since the last tick, in the order they were posted.
+     */
+    void applyInputs();
+
+    /**
+     * @brief Applies one input command to the main character and the companion.
+     *
+     * @param anAction Action of the player
+     * @param isPressed True when the key was pressed
+     * @param hasAttacked True once the main character attacked during the tick
+     */
+    void applyInput(InputAction anAction, bool isPressed, bool &hasAttacked);
+
+    /**
+     * @brief Replaces the current level, with the world mutex locked or from the thread of a headless game.
+     *
+     * @param aLevel New level, taken over by the game, deleted if it was not loaded
+     * @param isDeadReset True to bring the player back to life
+     * @return False if the new level was not loaded, the current level is kept
+     */
+    bool replaceLevel(Level *aLevel, bool isDeadReset);
+
+    /**
+     * @brief Loads the levels the replay loads before the current tick.
+     */
+    void applyReplayedLevels();
+
+    /**
+     * @brief Records or checks the hash of the state after a tick.
+     */
+    void endReplayTick();
+
+    /**
+     * @brief Hashes the rectangle and health of the main character and the rectangles of the enemies.
+     *
+     * @return Hash of the state
+     */
+    quint32 hashState() const;
+
     /**
      * @brief Main game loop to update game state.
      */
     void gameLoop();
 
+    /**
+     * @brief Copies the rectangles of the obstacles of the current level, once per level.
+     */
+    void captureObstacles();
+
+    /**
+     * @brief Copies the state of the world into a snapshot and publishes it.
+     *
+     * Called with the world mutex locked, or from the thread that steps a headless game.
+     */
+    void publishSnapshot();
+
+    /**
+     * @brief Stores the rectangles of every mover before a tick, for interpolation.
+     */
+    void savePreviousRects();
+
+    /**
+     * @brief Adds the time elapsed since the last phase to a phase, when profiling.
+     *
+     * @param aPhase Phase that just ended
+     */
+    void endPhase(Phase aPhase);
+
 signals:
     /**
      * @brief Signal emitted to request the game over screen.
      */
     void gameOverScreenRequested();
-    void objectCollected(QString aText);
+
+    /**
+     * @brief Signal emitted when the player collects a flashback object.
+     *
+     * @param aText Text of the flashback object
+     * @param aGameTimeMs Time of the collection on the game clock, in milliseconds
+     */
+    void objectCollected(QString aText, qint64 aGameTimeMs);
+
+    /**
+     * @brief Signal emitted after a new level replaced the current one.
+     */
+    void levelLoaded();
 };
 
 #endif // GAME_H
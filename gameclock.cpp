@@ -0,0 +1,54 @@
+/**
+ * @file gameclock.cpp
+ * @brief Implementation of the GameClock class methods.
+ */
+
+#include "gameclock.h"
+
+/**
+ * @brief Moves the clock forward by one tick.
+ * @param aStepNs Duration of the tick, in nanoseconds.
+ */
+void GameClock::advance(qint64 aStepNs)
+{
+    itsNowNs += aStepNs;
+    itsTickNb++;
+}
+
+/**
+ * @brief Moves the clock back to the start.
+ *
+ * A recording and its replays then see the same times, whatever ran before.
+ */
+void GameClock::reset()
+{
+    itsNowNs = 0;
+    itsTickNb = 0;
+}
+
+/**
+ * @brief Getter for the simulated time.
+ * @return Time in nanoseconds.
+ */
+qint64 GameClock::getItsNowNs() const
+{
+    return itsNowNs;
+}
+
+/**
+ * @brief Returns the simulated time in milliseconds.
+ * @return Time in milliseconds.
+ */
+qint64 GameClock::getNowMs() const
+{
+    return itsNowNs / 1000000;
+}
+
+/**
+ * @brief Getter for the number of ticks run.
+ * @return Number of ticks.
+ */
+quint64 GameClock::getItsTickNb() const
+{
+    return itsTickNb;
+}
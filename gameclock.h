@@ -0,0 +1,54 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+#include <QtGlobal>
+
+/**
+ * @brief The GameClock class gives the time of the simulation, counted in ticks.
+ *
+ * The clock only moves when a tick runs, by the duration of that tick, so it stops
+ * while the game is paused, the catch-up ticks each see their own time, and a replay
+ * sees the same times as the recorded run. The timers of the entities compare times
+ * of this clock instead of the wall clock.
+ */
+class GameClock
+{
+    qint64 itsNowNs = 0; /**< Simulated time elapsed since the game started, in nanoseconds. */
+    quint64 itsTickNb = 0; /**< Number of ticks run since the game started. */
+
+public:
+    /**
+     * @brief Moves the clock forward by one tick.
+     *
+     * @param aStepNs Duration of the tick, in nanoseconds
+     */
+    void advance(qint64 aStepNs);
+
+    /**
+     * @brief Moves the clock back to the start, before a recording or a replay.
+     */
+    void reset();
+
+    /**
+     * @brief Getter for the simulated time.
+     *
+     * @return Time elapsed in the ticks run, in nanoseconds
+     */
+    qint64 getItsNowNs() const;
+
+    /**
+     * @brief Returns the simulated time in milliseconds, the unit of the gameplay timers.
+     *
+     * @return Time elapsed in the ticks run, in milliseconds
+     */
+    qint64 getNowMs() const;
+
+    /**
+     * @brief Getter for the number of ticks run.
+     *
+     * @return Number of ticks
+     */
+    quint64 getItsTickNb() const;
+};
+
+#endif // GAMECLOCK_H
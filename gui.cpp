@@ -1,4 +1,10 @@
 #include "gui.h"
+#include <QDebug>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
 
 /**
      * @brief Constructor to initialize the GUI.
@@ -8,17 +14,37 @@
 */
 GUI::GUI(Game* aGame, QWidget *parent) : QWidget(parent), itsGame(aGame)
 {
+    QElapsedTimer startupClock;
+    startupClock.start();
     setFixedSize(1280, 720);
 
     itsTimer = new QTimer(this);
-    connect(itsTimer, SIGNAL(timeout()), this, SLOT(update()));
+    connect(itsTimer, &QTimer::timeout, this, &GUI::nextFrame);
     itsTimer->start(30); // Mise à jour toutes les 5 millisecondes
 
-    // Initialisation du générateur de nombres aléatoires
-    srand(static_cast<unsigned int>(time(nullptr)));
-
+    // The background and the loading animations, listed by the level manifest, are decoded on the
+    // global thread pool while the sprites load, only their conversion to pixmaps runs here
+    const WorldSnapshot &world = itsGame->getSnapshot();
+    QString backgroundPath = LevelManifest::instance().getLevel(world.levelNb).background;
+    QFuture<QImage> background = QtConcurrent::run(&BackgroundCache::prepare, backgroundPath,
+                                                   QSize(world.levelWidth, height()), devicePixelRatioF());
+    QFuture<QImage> loadingFrames = QtConcurrent::mapped(LevelManifest::instance().getItsLoadingFrames(),
+                                                         [](const QString &aPath) { return QImage(aPath); });
+
+    // A sprite pack built by "make sprites" replaces the decoding of the sprites it holds
+    itsSprites.openPack(QCoreApplication::applicationDirPath() + "/sprites.npak");
     loadImages(); // Charger toutes les images nécessaires pour l'animation
 
+    for (const QImage &frame : loadingFrames.results())
+    {
+        loadingPixmaps.append(QPixmap::fromImage(frame));
+    }
+    itsHud.loadAtlas(devicePixelRatioF());
+    itsPendingAssets.backgroundPath = backgroundPath;
+    itsPendingAssets.background = background.result();
+    updateBackground();
+    itsPendingAssets = PreparedAssets();
+
     gameOverLabel = new QLabel(this);
     gameOverLabel->setAlignment(Qt::AlignCenter);
     gameOverLabel->hide();
@@ -46,6 +72,18 @@ GUI::GUI(Game* aGame, QWidget *parent) : QWidget(parent), itsGame(aGame)
     connect(pauseMenu, &PauseMenu::optionsRequested, this, &GUI::showOptionsMenu);
     connect(itsGame, &Game::gameOverScreenRequested, this, &GUI::displayGameOverScreen);
     connect(itsGame, &Game::objectCollected, this, &GUI::drawFlashbackText);
+    connect(itsGame, &Game::levelLoaded, this, &GUI::updateBackground);
+    connect(itsGame, &Game::levelLoaded, this, &GUI::loadImages);
+
+    // A replay restarts the level by itself after a death
+    connect(itsGame, &Game::levelLoaded, this, [this]() {
+        gameOverLabel->hide();
+        restartButtonRect = QRect();
+    });
+
+    qDebug() << "Startup in" << startupClock.elapsed() << "ms: sprites loaded in" << itsSprites.getLoadWallMs()
+             << "ms of wall time for" << itsSprites.getLoadCpuMs() << "ms of CPU time on"
+             << QThreadPool::globalInstance()->maxThreadCount() << "threads";
 }
 /**
      * @brief Destructor to clean up resources.
@@ -58,298 +96,359 @@ GUI::~GUI()
     delete gameOverLabel;
 }
 /**
-     * @brief Loads images used in the GUI.
+     * @brief Makes the sprites of the current level resident in the asset manager.
+     *
+     * The era set is replaced when the era changes, the boss levels keep the sprites of the previous
+     * era. The shared set is acquired again at the sizes of the new level, its sprites are hits unless
+     * those sizes changed. Sprites prefetched for this level only have to be uploaded.
 */
 void GUI::loadImages()
 {
-    backgroundPixmaps["level_0"] = QPixmap(":/map/assets/map/map0.png");
-    backgroundPixmaps["level_1"] = QPixmap(":/map/assets/map/map1.png");
-    backgroundPixmaps["boss_1"] = QPixmap(":/map/assets/map/boss1.png");
-    backgroundPixmaps["level_2"] = QPixmap(":/map/assets/map/map2.png");
-    backgroundPixmaps["boss_2"] = QPixmap(":/map/assets/map/boss2.png");
-    backgroundPixmaps["level_3"] = QPixmap(":/map/assets/map/map3.png");
-    backgroundPixmaps["boss_3"] = QPixmap(":/map/assets/map/boss3.png");
+    itsSprites.releaseSet(NEXT_SET);
 
-    
-    if(itsGame->getItsLevel()->getItsEnemyType() == "ws")
+    // The level may be replaced by the simulation thread, it is read from the last snapshot
+    const WorldSnapshot &world = itsGame->getSnapshot();
+    Era era = world.era;
+    bool newEra = era != Era::None && era != itsSpriteEra;
+    if (!newEra && itsSprites.holds(COMMON_SET))
+    {
+        return;
+    }
+
+    QVector<SpriteRequest> eraSprites;
+    QVector<SpriteRequest> commonSprites;
+    if (itsPendingAssets.era != Era::None && itsPendingAssets.era == era)
     {
-        // Chargement des images pour les animations du personnage principal
-        characterPixmaps["main_walk1"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk1.png");
-        characterPixmaps["main_walk2"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk2.png");
-        characterPixmaps["main_walk3"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk3.png");
-        characterPixmaps["main_walk1_reversed"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk1_reversed.png");
-        characterPixmaps["main_walk2_reversed"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk2_reversed.png");
-        characterPixmaps["main_walk3_reversed"] = QPixmap(":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk3_reversed.png");
-
-        // Chargement des images pour les ennemis
-        characterPixmaps["skeleton_walk1"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk1.png");
-        characterPixmaps["skeleton_walk2"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk2.png");
-        characterPixmaps["skeleton_walk3"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk3.png");
-        characterPixmaps["skeleton_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk1_reversed.png");
-        characterPixmaps["skeleton_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk2_reversed.png");
-        characterPixmaps["skeleton_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/skeleton/skeleton_walk3_reversed.png");
-
-        characterPixmaps["wolf_walk1"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_1.png");
-        characterPixmaps["wolf_walk2"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_2.png");
-        characterPixmaps["wolf_walk3"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_3.png");
-        characterPixmaps["wolf_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_1_reversed.png");
-        characterPixmaps["wolf_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_2_reversed.png");
-        characterPixmaps["wolf_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/wicked_wolf/wolf_run_3_reversed.png");
-
-        // Chargement des images d'attaques du personnage principal
-        characterPixmaps["main_sword_attack1"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack1.png");
-        characterPixmaps["main_sword_attack2"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack2.png");
-        characterPixmaps["main_sword_attack3"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack3.png");
-        characterPixmaps["main_sword_attack3_reversed"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack1_reversed.png");
-        characterPixmaps["main_sword_attack2_reversed"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack2_reversed.png");
-        characterPixmaps["main_sword_attack3_reversed"] = QPixmap(":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack3_reversed.png");
-
-        // Chargement des images de morts
-        characterPixmaps["main_dead"] = QPixmap(":/dead/assets/nova/nova_dead.png");
-    }
-    if(itsGame->getItsLevel()->getItsEnemyType() == "cs")
+        eraSprites = itsPendingAssets.eraSprites;
+        commonSprites = itsPendingAssets.commonSprites;
+    }
+    else
     {
-        // Chargement des images pour les animations du personnage principal
-        characterPixmaps["main_walk1"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk1.png");
-        characterPixmaps["main_walk2"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk2.png");
-        characterPixmaps["main_walk3"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk3.png");
-        characterPixmaps["main_walk1_reversed"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk1_reversed.png");
-        characterPixmaps["main_walk2_reversed"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk2_reversed.png");
-        characterPixmaps["main_walk3_reversed"] = QPixmap(":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk3_reversed.png");
-
-        // Chargement des images pour les ennemis
-        characterPixmaps["soldier_walk1"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_1.png");
-        characterPixmaps["soldier_walk2"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_2.png");
-        characterPixmaps["soldier_walk3"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_3.png");
-        characterPixmaps["soldier_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_1_reversed.png");
-        characterPixmaps["soldier_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_2_reversed.png");
-        characterPixmaps["soldier_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/soldier/walk/soldier_walk_3_reversed.png");
-
-        characterPixmaps["canon_walk1"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_1.png");
-        characterPixmaps["canon_walk2"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_2.png");
-        characterPixmaps["canon_walk3"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_1.png");
-        characterPixmaps["canon_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_1_reversed.png");
-        characterPixmaps["canon_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_2_reversed.png");
-        characterPixmaps["canon_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/canon/walk/canon_walk_1_reversed.png");
-
-        // Chargement des images d'attaques du personnage principal
-        characterPixmaps["main_sword_attack1"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack1.png");
-        characterPixmaps["main_sword_attack2"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack2.png");
-        characterPixmaps["main_sword_attack3"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack3.png");
-        characterPixmaps["main_sword_attack1_reversed"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack1_reversed.png");
-        characterPixmaps["main_sword_attack2_reversed"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack2_reversed.png");
-        characterPixmaps["main_sword_attack3_reversed"] = QPixmap(":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack3_reversed.png");
-
-        // Chargement des images de morts
-        characterPixmaps["main_dead"] = QPixmap(":/dead/assets/nova/nova_dead.png");
-    }
-    if(itsGame->getItsLevel()->getItsEnemyType() == "nt")
+        AssetManager::spriteRequests(world.drawSizes, era, eraSprites, commonSprites);
+    }
+
+    itsSprites.setDevicePixelRatio(devicePixelRatioF());
+    if (newEra)
     {
-        // Chargement des images pour les animations du personnage principal
-        characterPixmaps["main_walk1"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk1.png");
-        characterPixmaps["main_walk2"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk2.png");
-        characterPixmaps["main_walk3"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk3.png");
-        characterPixmaps["main_walk1_reversed"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk1_reversed.png");
-        characterPixmaps["main_walk2_reversed"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk2_reversed.png");
-        characterPixmaps["main_walk3_reversed"] = QPixmap(":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk3_reversed.png");
-
-        // Chargement des images pour les ennemis
-        characterPixmaps["nautilus_walk1"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_1.png");
-        characterPixmaps["nautilus_walk2"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_2.png");
-        characterPixmaps["nautilus_walk3"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_3.png");
-        characterPixmaps["nautilus_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_1_reversed.png");
-        characterPixmaps["nautilus_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_2_reversed.png");
-        characterPixmaps["nautilus_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_3_reversed.png");
-
-        characterPixmaps["turret_walk1"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk1_reversed.png");
-        characterPixmaps["turret_walk2"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk2_reversed.png");
-        characterPixmaps["turret_walk3"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk3_reversed.png");
-        characterPixmaps["turret_walk1_reversed"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk1.png");
-        characterPixmaps["turret_walk2_reversed"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk2.png");
-        characterPixmaps["turret_walk3_reversed"] = QPixmap(":/déplacements/assets/ennemy/turret/walk/turret_walk3.png");
-
-        // Chargement des images d'attaques du personnage principal
-        characterPixmaps["main_sword_attack1"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png");
-        characterPixmaps["main_sword_attack2"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png");
-        characterPixmaps["main_sword_attack3"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png");
-        characterPixmaps["main_sword_attack1_reversed"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1_reversed.png");
-        characterPixmaps["main_sword_attack2_reversed"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack2_reversed.png");
-        characterPixmaps["main_sword_attack3_reversed"] = QPixmap(":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack3_reversed.png");
-
-        // Chargement des images de morts
-        characterPixmaps["main_dead"] = QPixmap(":/dead/assets/nova/nova_dead.png");
-    }
-
-    // Chargement des images pour les animations du companion
-    characterPixmaps["companion_walk1"] = QPixmap(":/déplacements/assets/sparkle/sparke_fly_1.png"); //mouvement vers la droite
-    characterPixmaps["companion_walk2"] = QPixmap(":/déplacements/assets/sparkle/sparkle_fly_2.png"); //mouvement vers la droite
-    characterPixmaps["companion_walk1_reversed"] = QPixmap(":/déplacements/assets/sparkle/sparkle_fly_1_reversed.png");
-    characterPixmaps["companion_walk2_reversed"] = QPixmap(":/déplacements/assets/sparkle/sparkle_fly_2_reversed.png");
-
-    // Chargement des images des boss
-    characterPixmaps["chevalry"] = QPixmap(":/attacks/assets/ennemy/chevalry/chevalry.png");
-    characterPixmaps["chevalry_dead"] = QPixmap(":/attacks/assets/ennemy/chevalry/chevalry_dead.png");
-    characterPixmaps["sword_vertical"] = QPixmap(":/attacks/assets/ennemy/chevalry/sword_vertical.png");
-    characterPixmaps["sword_horizontal"] = QPixmap(":/attacks/assets/ennemy/chevalry/sword_horizontal.png");
-    characterPixmaps["ghost_fly_1_reversed"] = QPixmap(":/déplacements/assets/ennemy/ghost/ghost_fly_1_reversed.png");
-    characterPixmaps["ghost_dead"] = QPixmap(":/déplacements/assets/ennemy/ghost/ghost_dead.png");
-    characterPixmaps["ghost_fly_2_reversed"] = QPixmap(":/déplacements/assets/ennemy/ghost/ghost_fly_2_reversed.png");
-    characterPixmaps["little_fantome_walk_1"] = QPixmap(":/déplacements/assets/ennemy/ghost/little_fantome_walk_1.png");
-    characterPixmaps["little_fantome_walk_2"] = QPixmap(":/déplacements/assets/ennemy/ghost/little_fantome_walk_2.png");
-
-    characterPixmaps["asterios_walk1"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_walk2.png");
-    characterPixmaps["asterios_walk2"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_walk3.png");
-    characterPixmaps["asterios_walk1_reversed"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_walk2_reversed.png");
-    characterPixmaps["asterios_walk2_reversed"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_walk3_reversed.png");
-    characterPixmaps["asterios_with_armor_walk1"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_with_armor_walk2.png");
-    characterPixmaps["asterios_with_armor_walk2"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_with_armor_walk3.png");
-    characterPixmaps["asterios_with_armor_walk1_reversed"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_with_armor_walk2_reversed.png");
-    characterPixmaps["asterios_with_armor_walk2_reversed"] = QPixmap(":/déplacements/assets/asterios/walk/asterios_with_armor_walk3_reversed.png");
-
-    // Chargement des images de pieces
-    elementPixmaps["pieces1"] = QPixmap(":/hud/assets/hud_elements/piece/piece.png");
-    elementPixmaps["victory"] = QPixmap(":/hud/assets/game_style/victory.png");
-
-    doorPixmaps["door_1"] = QPixmap(":/door/assets/door/door1.png");
-    doorPixmaps["door_2"] = QPixmap(":/door/assets/door/door2.png");
-    doorPixmaps["door_3"] = QPixmap(":/door/assets/door/door3.png");
-    doorPixmaps["portal_1"] = QPixmap(":/portal/assets/portal/portail1.png");
-    doorPixmaps["portal_2"] = QPixmap(":/portal/assets/portal/portail2.png");
-
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile1.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile2.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile3.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile4.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile5.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile6.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile7.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile8.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile9.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile10.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile11.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile12.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile13.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile14.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile15.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile16.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile17.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile18.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile19.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile20.png"));
-    loadingPixmaps.append(QPixmap(":/ile/assets/ile/ile21.png"));
-
-
-    // Chargement des images de pieces, d'objets et autres
-    elementPixmaps["pieces1"] = QPixmap(":/hud/assets/hud_elements/piece/piece.png");
-
-    elementPixmaps["lvl0_object1"] = QPixmap(":/object/assets/object/lvl0_object1.png");
-
-    elementPixmaps["lvl1_object1"] = QPixmap(":/object/assets/object/lvl1_object1.png");
-    elementPixmaps["lvl1_object2"] = QPixmap(":/object/assets/object/lvl1_object2.png");
-    elementPixmaps["lvl1_object3"] = QPixmap(":/object/assets/object/lvl1_object3.png");
-
-    elementPixmaps["lvl2_object1"] = QPixmap(":/object/assets/object/lvl2_object1.png");
-    elementPixmaps["lvl2_object2"] = QPixmap(":/object/assets/object/lvl2_object2.png");
-    elementPixmaps["lvl2_object3"] = QPixmap(":/object/assets/object/lvl2_object3.png");
-
-    elementPixmaps["lvl3_object1"] = QPixmap(":/object/assets/object/lvl3_object1.png");
-    elementPixmaps["lvl3_object2"] = QPixmap(":/object/assets/object/lvl3_object2.png");
-    elementPixmaps["lvl3_object3"] = QPixmap(":/object/assets/object/lvl3_object3.png");
-
-    elementPixmaps["text_background"] = QPixmap(":/menu/assets/game_style/text_background.png");
+        itsSprites.acquireSet(ERA_SET, eraSprites, true);
+        itsSpriteEra = era;
+    }
+    itsSprites.acquireSet(COMMON_SET, commonSprites, true);
+
+    qDebug() << "Assets:" << itsSprites.getAssetNb() << "sprites on" << itsSprites.getPageNb() << "atlas pages," << itsSprites.getResidentBytes() << "bytes resident of"
+             << itsSprites.getItsByteBudget() << "(peak" << itsSprites.getPeakBytes() << ")," << itsSprites.getItsHitNb()
+             << "hits," << itsSprites.getItsMissNb() << "misses (" << itsSprites.getItsPackedNb() << "from the sprite pack),"
+             << itsSprites.getItsEvictionNb() << "evictions," << itsSprites.getSavedBytes() << "bytes saved by pre-scaling";
 }
 /**
      * @brief Event handler for painting the GUI.
      *
+     * With the threaded backend, the last frame painted by the render thread is drawn. Otherwise,
+     * the last frame recorded is painted here.
+     *
      * @param event Paint event.
 */
 void GUI::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
-    QPainter painter(this);
-
-    itsGame->onDoorCollision();
 
-    int positionX = itsGame->getItsLevel()->getItsMainCharacter()->getRect().center().x();
-    if (positionX > itsGame->getItsLevel()->getItsLevelWidth() - width()/2)
+    if (itsRenderBackend == RenderBackend::Threaded)
     {
-        painter.translate(-itsGame->getItsLevel()->getItsLevelWidth() + width(), 0);
+        QPainter painter(this);
+        itsRenderWorker.present(&painter);
     }
-    else if (positionX > width()/2)
+    else if (itsRenderBackend == RenderBackend::Software)
     {
-        painter.translate(-positionX + width()/2, 0);
+        // The frame is composed in the back buffer, the widget only draws one image
+        QImage *backBuffer = itsSoftware.backBuffer(size(), devicePixelRatioF());
+        QPainter painter(backBuffer);
+        replay(&painter, itsSnapshot);
+        painter.end();
+        QPainter(this).drawImage(0, 0, *backBuffer);
     }
+    else
+    {
+        QPainter painter(this);
+        replay(&painter, itsSnapshot);
+    }
+}
 
-    updateBackground(); // Mettre à jour l'image de fond en fonction du niveau
-
-    int levelNumber = itsGame->getItsLevel()->getItsNb();
+/**
+     * @brief Records a frame and has it painted, called by the timer of the GUI.
+     *
+     * The snapshot is handed to the render thread with the threaded backend, the GUI thread then
+     * goes back to the events while the frame is painted.
+*/
+void GUI::nextFrame()
+{
+    // The frame is drawn from the last snapshot, entities between its tick and the previous one
+    itsWorld = &itsGame->getSnapshot();
+    itsAlpha = itsGame->getInterpolationAlpha();
 
-    if (levelNumber == 1 || levelNumber == 3 || levelNumber == 5)
+    // The flashback text is timed by the ticks, it stays while the game is paused
+    if (itsFlashbackText->isVisible() && itsWorld->gameTimeMs >= itsFlashbackHideMs)
     {
-        painter.drawPixmap(0, 0, 8000, 720, backgroundPixmap);
+        hideFlashbackText();
     }
-    else if (levelNumber == 2 || levelNumber == 4|| levelNumber == 6)
+
+    prefetchNextLevel();
+
+    updateCamera();
+    record();
+    if (itsRenderBackend == RenderBackend::Threaded)
     {
-        painter.drawPixmap(0, 0, 1280, 720, backgroundPixmap);
+        itsSnapshot.convertToImages();
+        itsRenderWorker.submit(std::move(itsSnapshot));
+        itsSnapshot = FrameSnapshot();
     }
-    else if (levelNumber == 0)
+    else
     {
-        painter.drawPixmap(0, 0, 3840, 720, backgroundPixmap);
+        update();
     }
+}
+
+/**
+     * @brief Records the current frame in the snapshot.
+     *
+     * The world is recorded in level coordinates, the snapshot moves it by the camera. The sprites
+     * are marked as such, for the sprite batcher or the blitter that paint them.
+*/
+void GUI::record()
+{
+    itsSnapshot = FrameSnapshot(size(), devicePixelRatioF());
+    itsSnapshot.setOrigin(QPoint(-itsCamera.left(), 0));
+    itsDrawnSprites = 0;
+    itsCulledSprites = 0;
+
+    // Only the tiles under the camera are copied, the background is scaled when the level loads
+    itsBackground.draw(&itsSnapshot, itsCamera);
 
-    drawObstacles(&painter);
-    drawPieces(&painter);
-    drawFlashbackObjects(&painter);
-    drawDoor(&painter);
-    drawCharacters(&painter);
+    drawObstacles();
+    drawPieces();
+    drawFlashbackObjects();
+    drawDoor();
+    drawCharacters();
 
-    drawHUD(&painter);
-    drawBoss(&painter);
+    // The HUD is drawn over the sprites recorded so far and under the next ones
+    drawHUD();
+    drawBoss();
 
-    if (itsGame->getItsDead())
+    if (itsWorld->dead)
     {
-        drawDeadMainCharacter(&painter);
+        drawDeadMainCharacter();
     }
     else if (isAttacking)
     {
-        drawAttackMC(&painter);
+        drawAttackMC();
     }
     else
     {
-        drawMainCharacter(&painter);
+        drawMainCharacter();
     }
     
-    drawCompanion(&painter);
-    
+    drawCompanion();
+
+    if (itsCullingReport)
+    {
+        itsTotalDrawnSprites += itsDrawnSprites;
+        itsTotalCulledSprites += itsCulledSprites;
+        if (++itsCullingFrames % CULLING_REPORT_FRAMES == 0)
+        {
+            QTextStream(stdout) << "Culling: " << itsTotalDrawnSprites << " sprites drawn in " << itsTotalBatches << " batches, "
+                                << itsTotalCulledSprites << " culled over the last " << CULLING_REPORT_FRAMES << " frames, "
+                                << itsRenderWorker.getItsDroppedNb() << " frames dropped by the render thread, "
+                                << itsGame->takeInputWaitNs() / 1000 << " us of longest input wait" << Qt::endl;
+            itsTotalDrawnSprites = 0;
+            itsTotalCulledSprites = 0;
+            itsTotalBatches = 0;
+        }
+    }
+
 
     if (isLoading) {
-        painter.fillRect(rect(), Qt::black);
+        itsSnapshot.setOrigin(QPoint());
+        itsSnapshot.fillRect(rect(), Qt::black);
         int frameWidth = loadingPixmaps[0].width(); // Largeur de chaque image de la séquence
         int frameHeight = loadingPixmaps[0].height(); // Hauteur de chaque image de la séquence
         int x = (width() - frameWidth) / 2;
         int y = (height() - frameHeight) / 2;
 
-        // Calculer l'index de l'image à afficher
-        int index = 0;
+        // The level being left gives the frames of its loading animation
+        const LevelTransition &transition = LevelManifest::instance().getLevel(itsWorld->levelNb).transition;
+        int index = (frameIndex % transition.frameNb) + transition.firstFrame;
+
+        QPixmap currentFrame = loadingPixmaps.at(index);
+
+        // Dessiner l'image actuelle
+        itsSnapshot.drawPixmap(QPoint(x, y), currentFrame);
+
+        // Progress of the prefetch of the next level, under the animation
+        QRect progressBar(x, y + frameHeight + 20, frameWidth, 8);
+        itsSnapshot.fillRect(progressBar, Qt::darkGray);
+        progressBar.setWidth(qRound(frameWidth * itsPrefetcher.getProgress()));
+        itsSnapshot.fillRect(progressBar, Qt::white);
+    }
+
 
-        if (levelNumber == 2)
+}
+
+/**
+     * @brief Paints a recorded frame on the GUI thread, with the raster or the software backend.
+     *
+     * The sprites go through the sprite batcher, or through the software renderer when it is
+     * selected, in which case aPainter paints on its back buffer. The batch pending is sent before
+     * anything else is drawn, so the frame keeps the order it was recorded in.
+     *
+     * @param aPainter Painter of the widget or of the back buffer.
+     * @param aSnapshot Frame recorded, its pixmaps not converted.
+*/
+void GUI::replay(QPainter *aPainter, const FrameSnapshot &aSnapshot)
+{
+    bool software = itsRenderBackend == RenderBackend::Software;
+    itsBatcher.begin(aPainter);
+    if (software)
+    {
+        itsSoftware.begin(aPainter);
+    }
+
+    for (const FrameSnapshot::Command &command : aSnapshot.getItsCommands())
+    {
+        if (command.isSprite)
         {
-            index = ((frameIndex) % 7) + 7;
+            SpriteFrame frame{aSnapshot.pixmap(command.source), command.sourceRect};
+            if (software)
+            {
+                itsSoftware.draw(command.target, frame);
+            }
+            else
+            {
+                itsBatcher.draw(command.target, frame);
+            }
+            continue;
         }
-        else if (levelNumber == 4)
+
+        itsBatcher.flush();
+        if (command.source < 0)
         {
-            index = (frameIndex % 7) + 14;
+            aPainter->fillRect(command.target, command.color);
         }
+        else
+        {
+            aPainter->drawPixmap(QRectF(command.target), aSnapshot.pixmap(command.source), QRectF(command.sourceRect));
+        }
+    }
 
-        QPixmap currentFrame = loadingPixmaps.at(index);
+    itsBatcher.flush();
+    if (software)
+    {
+        itsSoftware.end();
+    }
+    if (itsCullingReport)
+    {
+        itsTotalBatches += itsBatcher.getItsBatchNb();
+    }
+}
 
-        // Dessiner l'image actuelle
-        painter.drawPixmap(x, y, currentFrame);
+
+/**
+     * @brief Starts the prefetch of the next level once the main character is close to the door.
+     *
+     * The distance is given by the level manifest. The prefetch runs once per level, the
+     * result is kept until the player goes through the door.
+*/
+void GUI::prefetchNextLevel()
+{
+    int nextLevel = itsWorld->levelNb + 1;
+    if (!itsWorld->hasDoor || nextLevel >= LevelManifest::instance().getItsLevelNb())
+    {
+        return;
+    }
+
+    if (itsPrefetcher.getItsLevelNb() != nextLevel)
+    {
+        int distance = std::abs(itsWorld->door.center().x() - itsWorld->mainCharacter.rect.center().x());
+        if (distance <= LevelManifest::instance().getItsPrefetchDistance())
+        {
+            itsPrefetcher.start(nextLevel, itsSpriteEra, devicePixelRatioF(), height());
+        }
+        return;
+    }
+
+    // The sprites of the next era are made resident as soon as they are decoded, next to the current ones
+    if (itsPrefetcher.isReady() && itsPrefetcher.getItsAssets().era != Era::None && !itsSprites.holds(NEXT_SET))
+    {
+        const PreparedAssets &assets = itsPrefetcher.getItsAssets();
+        itsSprites.setDevicePixelRatio(devicePixelRatioF());
+        itsSprites.acquireSet(NEXT_SET, assets.eraSprites + assets.commonSprites, false);
     }
+}
 
+/**
+     * @brief Updates the rectangle of the level seen by the camera.
+     *
+     * The camera follows the main character and stops at the edges of the level.
+*/
+void GUI::updateCamera()
+{
+    int positionX = itsWorld->mainCharacter.getInterpolatedRect(itsAlpha).center().x();
+    int levelWidth = itsWorld->levelWidth;
+    int offset = 0;
+
+    if (positionX > levelWidth - width()/2)
+    {
+        offset = levelWidth - width();
+    }
+    else if (positionX > width()/2)
+    {
+        offset = positionX - width()/2;
+    }
+
+    itsCamera = QRect(offset, 0, width(), height());
+}
+
+/**
+     * @brief Checks whether a rectangle of the level is seen by the camera, and counts it.
+     *
+     * @param aRect Rectangle in level coordinates.
+     * @return True if the rectangle must be drawn.
+*/
+bool GUI::isVisible(const QRect &aRect)
+{
+    if (aRect.intersects(itsCamera))
+    {
+        itsDrawnSprites++;
+        return true;
+    }
+    itsCulledSprites++;
+    return false;
+}
 
+/**
+     * @brief Draws a sprite of the level if the camera sees it.
+     *
+     * The sprite is recorded in the snapshot, it is painted with the other sprites of its atlas page.
+     *
+     * @param aRect Rectangle of the sprite in level coordinates.
+     * @param aSprite Sprite to draw.
+*/
+void GUI::drawSprite(const QRect &aRect, SpriteId aSprite)
+{
+    if (isVisible(aRect))
+    {
+        drawFrame(aRect, itsSprites[aSprite]);
+    }
 }
 
+/**
+     * @brief Records a frame in the snapshot, as a sprite.
+     *
+     * @param aRect Rectangle of the frame in level coordinates.
+     * @param aFrame Frame to draw.
+*/
+void GUI::drawFrame(const QRect &aRect, const SpriteFrame &aFrame)
+{
+    itsSnapshot.drawPixmap(aRect, aFrame.page, aFrame.source, true);
+}
 
 /**
      * @brief Event handler for key press events.
@@ -358,6 +457,21 @@ void GUI::paintEvent(QPaintEvent *event)
 */
 void GUI::keyPressEvent(QKeyEvent *event)
 {
+    // A held key already moves the character, the repeated events would attack or pause again
+    if (event->isAutoRepeat())
+    {
+        return;
+    }
+    // The simulation is stopped while the next level loads
+    if (isLoading)
+    {
+        return;
+    }
+    // A replay plays the recorded inputs and level loads, the keys only pause it
+    if (itsGame->isReplaying() && event->key() != Qt::Key_Escape)
+    {
+        return;
+    }
     if (event->key() == Qt::Key_Escape)
     {
         // Inversez l'état de la pause
@@ -367,7 +481,7 @@ void GUI::keyPressEvent(QKeyEvent *event)
         if (isPaused)
         {
             itsGame->setIsPaused(true);
-            itsGame->getItsTimer()->stop();
+            itsGame->stop();
             pauseMenu->show(); // Remplacez "pauseMenu" par votre nom d'objet de menu de pause
         }
         else // Sinon, cachez le menu de pause
@@ -375,55 +489,66 @@ void GUI::keyPressEvent(QKeyEvent *event)
             pauseMenu->hide(); // Remplacez "pauseMenu" par votre nom d'objet de menu de pause
         }
     }
+    // The inputs are applied by the simulation at the start of its next tick
     if (event->key() == Qt::Key_Left)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->setPreviousDirection(true);
-        itsGame->getItsLevel()->getItsMainCharacter()->moveLeft(true);
-        itsGame->getItsLevel()->getItsCompanion()->moveLeft(true);
+        itsGame->postInput(InputAction::Left, true);
     }
     else if (event->key() == Qt::Key_Right)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->setPreviousDirection(false);
-        itsGame->getItsLevel()->getItsMainCharacter()->moveRight(true);
-        itsGame->getItsLevel()->getItsCompanion()->moveRight(true);
+        itsGame->postInput(InputAction::Right, true);
     }
     else if (event->key() == Qt::Key_Up)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->jump(true);
-        itsGame->getItsLevel()->getItsCompanion()->jump(true);
+        itsGame->postInput(InputAction::Jump, true);
     }
 
     else if (event->key() == Qt::Key_Down)
     {
-        itsGame->onDoorCollision(); // Vérifie la collision avec la porte
-
-        if (itsGame->playerIsNearDoor)
+        // The simulation checks the collision with the door on every tick
+        const WorldSnapshot &world = itsGame->getSnapshot();
+        if (world.playerIsNearDoor)
         {
-            itsTimer->stop(); // Arrêter le timer principal
-
-            int currentLevel = itsGame->getItsLevel()->getItsNb();
-            int nextLevel = currentLevel + 1;
+            int nextLevel = world.levelNb + 1;
 
-            // Vérifier si l'animation de chargement doit être déclenchée
-            if ((currentLevel == 2 && nextLevel == 3) || (currentLevel == 4 && nextLevel == 5))
+            // The manifest tells whether leaving this level plays a loading animation
+            const LevelTransition &transition = LevelManifest::instance().getLevel(world.levelNb).transition;
+            if (transition.frameNb > 0 && !loadingPixmaps.isEmpty())
             {
+                itsTimer->stop(); // Arrêter le timer principal
+
+                // The world must not move behind the loading animation
+                itsGame->setIsPaused(true);
+                itsGame->stop();
+
                 // Activer le mode de chargement
                 isLoading = true;
+                if (itsPrefetcher.getItsLevelNb() != nextLevel)
+                {
+                    itsPrefetcher.start(nextLevel, itsSpriteEra, devicePixelRatioF(), height());
+                }
+                itsLoadingClock.start();
 
-                // Utiliser un QTimer pour l'animation de chargement
+                // The animation runs until the prefetch is done, and at least for the duration of the transition
+                int minimumDuration = transition.duration;
                 QTimer* loadingTimer = new QTimer(this);
-                connect(loadingTimer, &QTimer::timeout, this, [=]() {
-                    // Incrémenter l'index de l'image
-                    frameIndex = (frameIndex + 1) % loadingPixmaps.size();
-                    // Redessiner l'écran
-                    update();
-                });
-                loadingTimer->start(500); // Intervalle de l'animation (en millisecondes)
+                connect(loadingTimer, &QTimer::timeout, this, [this, loadingTimer, nextLevel, minimumDuration]() {
+                    frameIndex = int(itsLoadingClock.elapsed() / LOADING_FRAME_MS);
+                    nextFrame();
+
+                    if (!itsPrefetcher.isReady() || itsLoadingClock.elapsed() < minimumDuration)
+                    {
+                        return;
+                    }
+
+                    PreparedAssets assets;
+                    Level *level = itsPrefetcher.take(nextLevel, assets);
+                    itsPendingAssets = assets;
+                    itsGame->loadNextLevel(level);
+                    itsPendingAssets = PreparedAssets();
+                    itsGame->setIsPaused(false);
+                    itsGame->start();
 
-                // Charger le niveau suivant après un délai fixe
-                QTimer::singleShot(3500, [this, loadingTimer]() {
-                    itsGame->loadNextLevel();
-                    loadImages();
                     isLoading = false; // Désactiver le mode de chargement
                     itsTimer->start(); // Redémarrer le timer principal
                     frameIndex = 0;
@@ -431,17 +556,22 @@ void GUI::keyPressEvent(QKeyEvent *event)
                     loadingTimer->deleteLater(); // Supprimer le QTimer
                     actionInProgress = true;
                 });
+                loadingTimer->start(LOADING_POLL_MS);
             }
             else
             {
-                // Charger directement le niveau suivant sans animation de chargement
-                itsGame->loadNextLevel();
+                // Charger directement le niveau suivant sans animation de chargement, prefetched if possible
+                PreparedAssets assets;
+                Level *level = itsPrefetcher.take(nextLevel, assets);
+                itsPendingAssets = assets;
+                itsGame->loadNextLevel(level);
+                itsPendingAssets = PreparedAssets();
             }
         }
     }
     else if (event->key() == Qt::Key_Space)
     {
-        itsGame->attackMC();
+        itsGame->postInput(InputAction::Attack, true);
         attackFrameCounter = 0;
     }
 }
@@ -453,6 +583,10 @@ void GUI::keyPressEvent(QKeyEvent *event)
 */
 void GUI::keyReleaseEvent(QKeyEvent *event)
 {
+    if (event->isAutoRepeat() || (itsGame->isReplaying() && event->key() != Qt::Key_Escape))
+    {
+        return;
+    }
     if(event->key() == Qt::Key_Escape)
     {
         if(pauseMenu->isHidden())
@@ -462,23 +596,20 @@ void GUI::keyReleaseEvent(QKeyEvent *event)
     }
     if (event->key() == Qt::Key_Left)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->moveLeft(false);
-        itsGame->getItsLevel()->getItsCompanion()->moveLeft(false);
+        itsGame->postInput(InputAction::Left, false);
     }
     else if (event->key() == Qt::Key_Right)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->moveRight(false);
-        itsGame->getItsLevel()->getItsCompanion()->moveRight(false);
+        itsGame->postInput(InputAction::Right, false);
     }
     else if (event->key() == Qt::Key_Up)
     {
-        itsGame->getItsLevel()->getItsMainCharacter()->jump(false);
-        itsGame->getItsLevel()->getItsCompanion()->jump(false);
+        itsGame->postInput(InputAction::Jump, false);
     }
 
+    // The attack only happens on press, releasing the key ends the animation
     if (event->key() == Qt::Key_Space)
     {
-        itsGame->attackMC();
         counterAttack = 1;
     }
 }
@@ -491,7 +622,7 @@ void GUI::keyReleaseEvent(QKeyEvent *event)
 void GUI::mousePressEvent(QMouseEvent *event)
 {
     QPoint clickPosition = event->pos();
-    if (restartButtonRect.contains(clickPosition))
+    if (restartButtonRect.contains(clickPosition) && !itsGame->isReplaying())
     {
         restartGame();
     }
@@ -499,372 +630,152 @@ void GUI::mousePressEvent(QMouseEvent *event)
 
 /**
      * @brief Draws the main character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawMainCharacter(QPainter *aPainter)
+void GUI::drawMainCharacter()
 {
-    QString key;
+    SpriteId sprite;
     counterDrawMainCharacter = (counterDrawMainCharacter + 1) % 6; // Animation de 6 frames
-    if(itsGame->getItsLevel()->getItsMainCharacter()->getItsRight())
+    if(itsWorld->mainCharacter.right)
     {
-        key = "main_walk" + QString::number((counterDrawMainCharacter / 2) + 1) + "_reversed";
+        sprite = MAIN_WALK[1][counterDrawMainCharacter / 2];
         previousDirectionRightMC = true;
     }
-    else if(itsGame->getItsLevel()->getItsMainCharacter()->getItsLeft())
+    else if(itsWorld->mainCharacter.left)
     {
-        key = "main_walk" + QString::number((counterDrawMainCharacter / 2) + 1);
+        sprite = MAIN_WALK[0][counterDrawMainCharacter / 2];
         previousDirectionRightMC = false;
     }
     else
     {
-        if(!previousDirectionRightMC)
-        {
-            key = "main_walk1_reversed";
-        }
-        if(previousDirectionRightMC)
-        {
-            key = "main_walk1";
-        }
+        sprite = MAIN_WALK[previousDirectionRightMC ? 0 : 1][0];
     }
-    aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
+    drawSprite(itsWorld->mainCharacter.getInterpolatedRect(itsAlpha), sprite);
 }
 
 /**
      * @brief Draws the companion character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing
      */
-void GUI::drawCompanion(QPainter * aPainter)
+void GUI::drawCompanion()
 {
-    QString key;
+    SpriteId sprite;
     counterCompanion = (counterCompanion + 1) % 6; // Animation de 6 frames
-    if(itsGame->getItsLevel()->getItsCompanion()->getItsLeft())
+    if(itsWorld->companion.left)
     {
-        key = "companion_walk" + QString::number((counterCompanion / 3) + 1) + "_reversed";
+        sprite = COMPANION_WALK[1][counterCompanion / 3];
         previousDirectionRightMC = true;
     }
-    else if(itsGame->getItsLevel()->getItsMainCharacter()->getItsRight())
+    else if(itsWorld->mainCharacter.right)
     {
-        key = "companion_walk" + QString::number((counterCompanion / 3) + 1);
+        sprite = COMPANION_WALK[0][counterCompanion / 3];
         previousDirectionRightMC = false;
     }
     else
     {
-        if(previousDirectionRightMC)
-        {
-            key = "companion_walk1_reversed";
-        }
-        if(!previousDirectionRightMC)
-        {
-            key = "companion_walk1";
-        }
+        sprite = COMPANION_WALK[previousDirectionRightMC ? 1 : 0][0];
     }
-    aPainter->drawPixmap(itsGame->getItsLevel()->getItsCompanion()->getRect(), characterPixmaps[key]);
+    drawSprite(itsWorld->companion.getInterpolatedRect(itsAlpha), sprite);
 }
 /**
      * @brief Draws the characters in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawCharacters(QPainter *aPainter)
+void GUI::drawCharacters()
 {
-    if(itsGame->getItsLevel()->getItsEnemyType() == "ws" or itsGame->getItsLevel()->getItsFinalBoss() != nullptr)
+    // The enemies summoned by the final boss look like the middle age ones
+    Era era = itsWorld->era;
+    if (itsWorld->hasFinalBoss)
     {
-        counterDrawEnemies = (counterDrawEnemies + 1) % 9;
-
-        QString key;
-        QString enemyType;
-        for (Character* character : *itsGame->getItsLevel()->getItsEnemies())
-        {
-            if (character->getItsDead() == false)
-            {
-                if (character->getType() == 1) // Squelette
-                {
-                    enemyType = "skeleton";
-                }
-                if (character->getType() == 2) // Loup
-                {
-                    enemyType = "wolf";
-                }
-                if (character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1);
-                }
-                else if(!character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1) + "_reversed";
-                }
-                aPainter->drawPixmap(character->getRect(), characterPixmaps[key]);
-            }
-        }
+        era = Era::MiddleAge;
     }
-    else if(itsGame->getItsLevel()->getItsEnemyType() == "cs")
+    if (era == Era::None)
     {
-        counterDrawEnemies = (counterDrawEnemies + 1) % 9;
-
-        QString key;
-        QString enemyType;
-
-        for (Character* character : *itsGame->getItsLevel()->getItsEnemies())
-        {
-            if (character->getItsDead() == false)
-            {
-                if (character->getType() == 1) // Soldat
-                {
-                    enemyType = "soldier";
-                }
-                if (character->getType() == 2) // Canon
-                {
-                    enemyType = "canon";
-                }
-                if (!character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1);
-                }
-                else if(character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1) + "_reversed";
-                }
-
-                aPainter->drawPixmap(character->getRect(), characterPixmaps[key]);
-            }
-        }
+        return;
     }
-    else if(itsGame->getItsLevel()->getItsEnemyType() == "nt")
-    {
-        counterDrawEnemies = (counterDrawEnemies + 1) % 9;
 
-        QString key;
-        QString enemyType;
+    counterDrawEnemies = (counterDrawEnemies + 1) % 9;
+    int frame = counterDrawEnemies / 3;
+    bool reversedOnPreviousDirection = ENEMY_REVERSED_ON_PREVIOUS_DIRECTION[static_cast<int>(era)];
 
-        for (Character* character : *itsGame->getItsLevel()->getItsEnemies())
+    for (const WorldSnapshot::Mover &character : itsWorld->enemies)
+    {
+        int kind = character.type;
+        if (character.dead == false && kind >= 1 && kind <= ENEMY_KIND_COUNT)
         {
-            if (character->getItsDead() == false)
-            {
-                if (character->getType() == 1) // Nautilus
-                {
-                    enemyType = "nautilus";
-                }
-                if (character->getType() == 2) // Turret
-                {
-                    enemyType = "turret";
-                }
-                if (character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1);
-                }
-                else if(!character->getPreviousDirection())
-                {
-                    key = enemyType + "_walk" + QString::number((counterDrawEnemies / 3) + 1) + "_reversed";
-                }
-
-                aPainter->drawPixmap(character->getRect(), characterPixmaps[key]);
-            }
+            bool reversed = character.previousDirection == reversedOnPreviousDirection;
+            SpriteId sprite = ENEMY_WALK[static_cast<int>(era)][kind - 1][reversed ? 1 : 0][frame];
+            drawSprite(character.getInterpolatedRect(itsAlpha), sprite);
         }
     }
 }
 /**
      * @brief Draws the collectible pieces in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawPieces(QPainter * aPainter)
+void GUI::drawPieces()
 {
-    for (Piece* piece : *itsGame->getItsLevel()->getItsPieces())
+    for (const QRect &piece : itsWorld->pieces)
     {
-        aPainter->drawPixmap(piece->getRect(), elementPixmaps["pieces1"]);
+        drawSprite(piece, PieceSprite);
     }
 }
 /**
      * @brief Draws the flashback objects in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawFlashbackObjects(QPainter * aPainter)
+void GUI::drawFlashbackObjects()
 {
-    for (FlashbackObject* object : *itsGame->getItsLevel()->getItsFlashbackObjects())
+    for (const WorldSnapshot::Object &object : itsWorld->flashbackObjects)
     {
-        QString key = "lvl"+QString::number(itsGame->getItsLevel()->getItsHUDNb())+"_object"+object->getItsNb();
-        aPainter->drawPixmap(object->getRect(), elementPixmaps[key]);
+        SpriteId sprite = flashbackObjectSprite(itsWorld->hudNb, object.nb);
+        drawSprite(object.rect, sprite);
     }
 }
 /**
      * @brief Draws the collision of obstacles in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawObstacles(QPainter *aPainter)
+void GUI::drawObstacles()
 {
-    for (Obstacle* obstacle : *itsGame->getItsLevel()->getItsObstacles())
+    // The obstacles are transparent, they are only counted by the culling report
+    for (const QRect &obstacle : itsWorld->obstacles)
     {
-        aPainter->setPen(Qt::transparent);
-        aPainter->setBrush(Qt::transparent); // Modifiez la couleur selon votre design
-        aPainter->drawRect(obstacle->getRect());
+        isVisible(obstacle);
     }
 }
 
 /**
      * @brief Draws the HUD (Heads-Up Display) in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawHUD(QPainter * aPainter)
+void GUI::drawHUD()
 {
+    // The layer is only composed again when a displayed value changes
+    itsHud.update(width(), itsWorld->mainCharacter.hp, itsWorld->pieceNb, itsWorld->flashbackObjectNb,
+                  itsWorld->flashbackObjectTotal, itsWorld->hudNb);
 
-    QPixmap pieceNb(":/hud/assets/hud_elements/font/"+QString::number(itsGame->getItsLevel()->getItsMainCharacter()->getItsPieceNb())+"_font.png");
-    QPixmap piece(":/hud/assets/hud_elements/piece/piece.png");
-
-    QPixmap heart1, heart2, heart3;
-    switch (itsGame->getItsLevel()->getItsMainCharacter()->getItsHP())
-    {
-    case 1:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_half.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        break;
-    case 2:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        break;
-    case 3:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_half.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        break;
-    case 4:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        break;
-    case 5:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_half.png");
-        break;
-    case 6:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_full.png");
-        break;
-    default:
-        heart1 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        heart2 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        heart3 = QPixmap(":/hud/assets/hud_elements/heart/heart_empty.png");
-        break;
-    }
-
-    QPixmap slash(":/hud/assets/hud_elements/font/slash.png");
-    QPixmap nbObject(":/hud/assets/hud_elements/font/"+QString::number(itsGame->getItsLevel()->getItsMainCharacter()->getItsFlashbackObjectNb())+"_font.png");
-    QPixmap nbObjectTotal(":/hud/assets/hud_elements/font/"+QString::number(itsGame->getItsLevel()->getItsFlashbackObjectNb())+"_font.png");
-
-    QPixmap nbLvl(":/hud/assets/hud_elements/font/"+QString::number(itsGame->getItsLevel()->getItsHUDNb())+"_font.png");
-    QPixmap lvl(":/hud/assets/hud_elements/font/lvl.png");
-
-
-    int fontSize = 40;
-    int pieceSize = 50;
-    int heartSize = 55;
-    int lvlWidth = fontSize*3 + 10;
-
-    int pieceNbOffsetX = 30;
-    int pieceOffsetX = 80;
-    int pieceNbOffsetY = 100;
-    int pieceOffsetY = 95;
-
-    int heart1OffsetX = 30;
-    int heart2OffsetX = 90;
-    int heart3OffsetX = 150;
-    int heartOffsetY = 30;
-
-    int slashOffsetX = width()/2 - fontSize/2;
-    int nbObjectOffsetX = slashOffsetX - fontSize;
-    int nbObjectTotalOffsetX = slashOffsetX + fontSize;
-
-    int nbLvlOffsetX = width() - fontSize - 30;
-    int lvlOffsetX = nbLvlOffsetX - lvlWidth - 10;
-
-    int fontOffsetY = 35;
-
-    int positionX = itsGame->getItsLevel()->getItsMainCharacter()->getRect().center().x();
-    int levelWidth = itsGame->getItsLevel()->getItsLevelWidth();
-    int globalOffset;
-
-    if (positionX > levelWidth - width()/2)
-    {
-        globalOffset = levelWidth - width();
-    }
-    else if (positionX > width()/2)
-    {
-        globalOffset = positionX - width()/2;
-    }
-    else
-    {
-        globalOffset = 0;
-    }
-
-    // Display of pieces number
-    aPainter->drawPixmap(globalOffset + pieceNbOffsetX, pieceNbOffsetY, fontSize, fontSize, pieceNb);
-    aPainter->drawPixmap(globalOffset + pieceOffsetX, pieceOffsetY, pieceSize, pieceSize, piece);
-
-    // Display of health
-    aPainter->drawPixmap(globalOffset + heart1OffsetX, heartOffsetY, heartSize, heartSize, heart1);
-    aPainter->drawPixmap(globalOffset + heart2OffsetX, heartOffsetY, heartSize, heartSize, heart2);
-    aPainter->drawPixmap(globalOffset + heart3OffsetX, heartOffsetY, heartSize, heartSize, heart3);
-
-    // Display of objects number
-    aPainter->drawPixmap(globalOffset + slashOffsetX, fontOffsetY, fontSize, fontSize, slash);
-    aPainter->drawPixmap(globalOffset + nbObjectOffsetX, fontOffsetY, fontSize, fontSize, nbObject);
-    aPainter->drawPixmap(globalOffset + nbObjectTotalOffsetX, fontOffsetY, fontSize, fontSize, nbObjectTotal);
-
-    // Display of level number
-    aPainter->drawPixmap(globalOffset + nbLvlOffsetX, fontOffsetY, fontSize, fontSize, nbLvl);
-    aPainter->drawPixmap(globalOffset + lvlOffsetX, fontOffsetY, lvlWidth, fontSize, lvl);
+    // The snapshot follows the camera, the HUD stays on screen
+    itsHud.draw(&itsSnapshot, QPoint(itsCamera.left(), 0));
 }
 /**
      * @brief Draws the main character's attack animation.
-     *
-     * @param painter Pointer to the painter object used for drawing.
 */
-void GUI::drawAttackMC(QPainter *aPainter)
+void GUI::drawAttackMC()
 {
-    QString key;
-
     // Calculer l'index de la frame actuelle
     int frameIndex = attackFrameCounter / 2 + 1;
 
-    switch (frameIndex)
+    if (frameIndex > 3)
     {
-    case 0:
-        key = "main_sword_attack1";
-        break;
-    case 1:
-        key = "main_sword_attack2";
-        break;
-    case 2:
-        key = "main_sword_attack3";
-        break;
-    case 3:
-        key = "main_sword_attack4";
-        break;
-    default:
         isAttacking = false; // Arrêter l'animation après la dernière frame
         attackFrameCounter = 0; // Réinitialiser le compteur pour la prochaine attaque
         return;
-        aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
-        counterAttack = 0;
     }
 
-    if (!itsGame->getItsLevel()->getItsMainCharacter()->getPreviousDirection())
+    QRect rect = itsWorld->mainCharacter.getInterpolatedRect(itsAlpha);
+    SpriteId sprite = MAIN_ATTACK[frameIndex];
+
+    if (!itsWorld->mainCharacter.previousDirection)
     {
-        key += "_reversed";
-        key = "main_sword_attack1_reversed";
-        aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
-        key = "main_sword_attack2_reversed";
-        aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
-        key = "main_sword_attack3_reversed";
-        aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
+        for (SpriteId reversedSprite : MAIN_ATTACK_REVERSED)
+        {
+            drawSprite(rect, reversedSprite);
+        }
+        sprite = MAIN_ATTACK_REVERSED[2];
         counterAttack = 0;
     }
     if (frameIndex == 3)
@@ -873,32 +784,24 @@ void GUI::drawAttackMC(QPainter *aPainter)
         attackFrameCounter = 0;
     }
 
-    aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
+    drawSprite(rect, sprite);
 
     attackFrameCounter++;
-
-
 }
 
 
 
 /**
      * @brief Draws the main character in the dead state.
-     *
-     * @param painter Pointer to the painter object used for drawing.
 */
-void GUI::drawDeadMainCharacter(QPainter *aPainter)
+void GUI::drawDeadMainCharacter()
 {
-    QString key;
-    key = "main_dead";
-    aPainter->drawPixmap(itsGame->getItsLevel()->getItsMainCharacter()->getRect(), characterPixmaps[key]);
+    drawSprite(itsWorld->mainCharacter.getInterpolatedRect(itsAlpha), MainDead);
 }
 /**
      * @brief Draws the differents boss character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawBoss(QPainter *aPainter)
+void GUI::drawBoss()
 {
 
         // Déclaration de la variable flyingAnimation comme static
@@ -907,25 +810,19 @@ void GUI::drawBoss(QPainter *aPainter)
         static int animationCounter = 0;
         const int animationDelay = 10; // Délai en nombre de frames entre chaque changement d'image
 
-        if(itsGame->getItsLevel()->getItsFinalBoss() != nullptr && itsGame->getItsLevel()->getItsFinalBoss()->getItsHP() >0 )
+        if(itsWorld->hasFinalBoss && itsWorld->finalBoss.hp >0 )
         {
-            if (itsGame->getItsLevel()->getItsFinalBoss()->getItsHP() > 16)
+            if (itsWorld->finalBoss.hp > 16)
             {
-                QString key = walkingAnimation ? "asterios_walk1" : "asterios_walk2";
-                if (!itsGame->getItsLevel()->getItsFinalBoss()->getPreviousDirection())
-                {
-                    key = walkingAnimation ? "asterios_walk1_reversed" : "asterios_walk2_reversed";
-                }
-                aPainter->drawPixmap(itsGame->getItsLevel()->getItsFinalBoss()->getRect(), characterPixmaps[key]);
+                bool reversed = !itsWorld->finalBoss.previousDirection;
+                SpriteId sprite = ASTERIOS_WALK[0][reversed ? 1 : 0][walkingAnimation ? 0 : 1];
+                drawSprite(itsWorld->finalBoss.getInterpolatedRect(itsAlpha), sprite);
             }
             else
             {
-                QString key = walkingAnimation ? "asterios_with_armor_walk1" : "asterios_with_armor_walk2";
-                if (!itsGame->getItsLevel()->getItsFinalBoss()->getPreviousDirection())
-                {
-                    key = walkingAnimation ? "asterios_with_armor_walk1_reversed" : "asterios_with_armor_walk2_reversed";
-                }
-                aPainter->drawPixmap(itsGame->getItsLevel()->getItsFinalBoss()->getRect(), characterPixmaps[key]);
+                bool reversed = !itsWorld->finalBoss.previousDirection;
+                SpriteId sprite = ASTERIOS_WALK[1][reversed ? 1 : 0][walkingAnimation ? 0 : 1];
+                drawSprite(itsWorld->finalBoss.getInterpolatedRect(itsAlpha), sprite);
             }
 
             if (animationCounter >= animationDelay)
@@ -938,66 +835,63 @@ void GUI::drawBoss(QPainter *aPainter)
                 animationCounter++;
             }
         }
-        if(itsGame->getItsLevel()->getItsFinalBoss() != nullptr && itsGame->getItsLevel()->getItsFinalBoss()->getItsHP() <=0)
+        if(itsWorld->hasFinalBoss && itsWorld->finalBoss.hp <=0)
         {
             QRect targetRect(0, 0, 1280, 720);
-            aPainter->drawPixmap(targetRect, elementPixmaps["victory"]);
+            drawFrame(targetRect, itsSprites[Victory]);
         }
-        if(itsGame->getItsLevel()->getItsBoss() != nullptr)
+        if(itsWorld->hasBoss)
         {
-        if (itsGame->getItsLevel()->getItsBoss()->getItsHP() <= 0 && itsGame->getItsLevel()->getItsNb() == 2)
+        bool knight = LevelManifest::instance().getLevel(itsWorld->levelNb).boss == BossStyle::Knight;
+        if (itsWorld->boss.hp <= 0 && knight)
         {
-            aPainter->drawPixmap(itsGame->getItsLevel()->getItsBoss()->getRect(), characterPixmaps["chevalry_dead"]);
+            drawSprite(itsWorld->boss.rect, ChevalryDead);
         }
-        else if (itsGame->getItsLevel()->getItsBoss()->getItsHP() <= 0 && itsGame->getItsLevel()->getItsNb() == 4)
+        else if (itsWorld->boss.hp <= 0)
         {
-            aPainter->drawPixmap(itsGame->getItsLevel()->getItsBoss()->getRect(), characterPixmaps["ghost_dead"]);
+            drawSprite(itsWorld->boss.rect, GhostDead);
         }
         else
         {
-            if (itsGame->getItsLevel()->getItsNb() == 2)
+            if (knight)
             {
-                aPainter->drawPixmap(itsGame->getItsLevel()->getItsBoss()->getRect(), characterPixmaps["chevalry"]);
+                drawSprite(itsWorld->boss.rect, Chevalry);
             }
             else
             {
                 if (animationCounter >= animationDelay)
                 {
                     // Alternance entre deux images pour l'animation de vol
-                    QString key = flyingAnimation ? "ghost_fly_1_reversed" : "ghost_fly_2_reversed";
-                    aPainter->drawPixmap(itsGame->getItsLevel()->getItsBoss()->getRect(), characterPixmaps[key]);
+                    drawSprite(itsWorld->boss.rect, GHOST_FLY[flyingAnimation]);
                     flyingAnimation = !flyingAnimation; // Inverser pour alterner les images à chaque appel
                     animationCounter = 0; // Réinitialiser le compteur après chaque changement d'image
                 }
                 else
                 {
                     // Si le délai n'est pas encore écoulé, dessiner l'image actuelle sans changement
-                    QString key = flyingAnimation ? "ghost_fly_1_reversed" : "ghost_fly_2_reversed";
-                    aPainter->drawPixmap(itsGame->getItsLevel()->getItsBoss()->getRect(), characterPixmaps[key]);
+                    drawSprite(itsWorld->boss.rect, GHOST_FLY[flyingAnimation]);
                     animationCounter++; // Incrémenter le compteur
                 }
             }
 
             // Affichage de la barre de vie
-            aPainter->setBrush(QBrush(Qt::gray));
-            aPainter->drawRect(360, 120, 600, 20);
+            itsSnapshot.fillRect(QRect(360, 120, 600, 20), Qt::gray);
             // Dessiner la barre de vie en rouge
-            aPainter->setBrush(QBrush(Qt::red));
-            aPainter->drawRect(360, 120, static_cast<int>((static_cast<float>(itsGame->getItsLevel()->getItsBoss()->getItsHP()) / 12) * 600), 20);
+            itsSnapshot.fillRect(QRect(360, 120, static_cast<int>((static_cast<float>(itsWorld->boss.hp) / 12) * 600), 20), Qt::red);
         }
 
         // Affichage des attaques du boss
-        for (QRect* summoning : *(itsGame->getItsLevel()->getItsBoss()->getItsSummoning()))
+        for (const QRect &summoning : itsWorld->summonings)
         {
-            if (itsGame->getItsLevel()->getItsNb() == 2)
+            if (knight)
             {
-                if (itsGame->getItsLevel()->getItsBoss()->getIsSwordVertical())
+                if (itsWorld->isSwordVertical)
                 {
-                    aPainter->drawPixmap(*summoning, characterPixmaps["sword_vertical"]);
+                    drawSprite(summoning, SwordVertical);
                 }
                 else
                 {
-                    aPainter->drawPixmap(*summoning, characterPixmaps["sword_horizontal"]);
+                    drawSprite(summoning, SwordHorizontal);
                 }
             }
             else
@@ -1005,16 +899,14 @@ void GUI::drawBoss(QPainter *aPainter)
                 if (animationCounter >= animationDelay)
                 {
                     // Alternance entre deux images pour l'animation de marche du fantôme
-                    QString key = flyingAnimation ? "little_fantome_walk_1" : "little_fantome_walk_2";
-                    aPainter->drawPixmap(*summoning, characterPixmaps[key]);
+                    drawSprite(summoning, LITTLE_FANTOME_WALK[flyingAnimation]);
                     flyingAnimation = !flyingAnimation; // Inverser pour alterner les images à chaque appel
                     animationCounter = 0; // Réinitialiser le compteur après chaque changement d'image
                 }
                 else
                 {
                     // Si le délai n'est pas encore écoulé, dessiner l'image actuelle sans changement
-                    QString key = flyingAnimation ? "little_fantome_walk_1" : "little_fantome_walk_2";
-                    aPainter->drawPixmap(*summoning, characterPixmaps[key]);
+                    drawSprite(summoning, LITTLE_FANTOME_WALK[flyingAnimation]);
                     animationCounter++; // Incrémenter le compteur
                 }
             }
@@ -1043,85 +935,35 @@ void GUI::displayGameOverScreen()
 */
 void GUI::updateBackground()
 {
-    QString imagePath;
-
-    int levelNumber = itsGame->getItsLevel()->getItsNb();
-
-    switch (levelNumber) {
-    case 0:
-        imagePath = "level_0";
-        break;
-    case 1:
-        itsGame->getItsLevel()->getPlayer()->stop();
-        imagePath = "level_1";
-        break;
-    case 2:
-        imagePath = "boss_1";
-        itsGame->getItsLevel()->getPlayer()->stop();
-        break;
-    case 3:
-        imagePath = "level_2";
-        itsGame->getItsLevel()->getPlayer()->stop();
-        break;
-    case 4:
-        imagePath = "boss_2";
-        itsGame->getItsLevel()->getPlayer()->stop();
-        break;
-    case 5:
-        imagePath = "level_3";
-        itsGame->getItsLevel()->getPlayer()->stop();
-        break;
-    case 6:
-        imagePath = "boss_3";
-        break;
-    default:
-        // Gérez d'autres cas si nécessaire
-        break;
-    }
-
-    backgroundPixmap = backgroundPixmaps.value(imagePath);
+    const WorldSnapshot &world = itsGame->getSnapshot();
+    QString imagePath = LevelManifest::instance().getLevel(world.levelNb).background;
+
+    // A background prefetched with the level only has to be cut into tiles
+    QSize levelSize(world.levelWidth, height());
+    if (!itsPendingAssets.background.isNull() && itsPendingAssets.backgroundPath == imagePath
+        && !itsBackground.holds(imagePath, levelSize, devicePixelRatioF()))
+    {
+        itsBackground.build(imagePath, itsPendingAssets.background, devicePixelRatioF());
+    }
+    else
+    {
+        itsBackground.build(imagePath, levelSize, devicePixelRatioF());
+    }
+    qDebug() << "Background" << imagePath << "cut into" << itsBackground.getItsTileNb() << "tiles,"
+             << itsBackground.getResidentBytes() << "bytes resident";
 
     update();
 }
 
 /**
      * @brief Draws the door in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
 */
-void GUI::drawDoor(QPainter *aPainter)
+void GUI::drawDoor()
 {
-    QString imagePath;
-
-    int levelNumber = itsGame->getItsLevel()->getItsNb();
-
-    switch (levelNumber) {
-    case 0:
-        imagePath = "portal_1";
-        break;
-    case 1:
-        imagePath = "door_1";
-        break;
-    case 2:
-        imagePath = "portal_1";
-        break;
-    case 3:
-        imagePath = "door_2";
-        break;
-    case 4:
-        imagePath = "portal_1";
-        break;
-    case 5:
-        imagePath = "door_3";
-    default:
-        // Gérez d'autres cas si nécessaire
-        break;
-    }
-
-    QPixmap doorPixmap = doorPixmaps.value(imagePath);
-
-    if (itsGame->getItsLevel()->getItsDoor()) {
-        aPainter->drawPixmap(itsGame->getItsLevel()->getItsDoor()->getRect(), doorPixmap);
+    SpriteId sprite = LevelManifest::instance().getLevel(itsWorld->levelNb).door;
+
+    if (itsWorld->hasDoor) {
+        drawSprite(itsWorld->door, sprite);
     }
 }
 /**
@@ -1129,8 +971,12 @@ void GUI::drawDoor(QPainter *aPainter)
 */
 void GUI::restartGame()
 {
+    // The game over screen stays if the level cannot be loaded again
+    if (!itsGame->restartLevel())
+    {
+        return;
+    }
     gameOverLabel->hide();
-    itsGame->restartLevel(); // Ajoutez cette méthode à votre classe Game pour réinitialiser l'état du jeu
     itsTimer->start();
 
     // Réinitialiser restartButtonRect pour désactiver le bouton de redémarrage
@@ -1143,7 +989,7 @@ void GUI::restartGame()
 void GUI::handleContinueGame()
 {
     itsGame->setIsPaused(false);
-    itsGame->getItsTimer()->start();
+    itsGame->start();
     pauseMenu->hide(); // Cacher le menu de pause
 }
 
@@ -1161,13 +1007,13 @@ void GUI::showOptionsMenu()
      * @brief Slot for drawing flashback text.
      *
      * @param aText The text to display in the flashback.
+     * @param aGameTimeMs Time the object was collected, on the game clock.
 */
-void GUI::drawFlashbackText(QString aText)
+void GUI::drawFlashbackText(QString aText, qint64 aGameTimeMs)
 {
     // Configure and show the background label
-    elementPixmaps["text_background"] = elementPixmaps["text_background"].scaled(450, 150);
     itsFlashbackBackground->move(1280/2-450/2, 720/2-150/2);
-    itsFlashbackBackground->setPixmap(elementPixmaps["text_background"]);
+    itsFlashbackBackground->setPixmap(itsSprites.pixmap(TextBackground));
     itsFlashbackBackground->show();
 
     // Configure and show the text label
@@ -1177,8 +1023,8 @@ void GUI::drawFlashbackText(QString aText)
     itsFlashbackText->setText(aText);
     itsFlashbackText->show();
 
-    // Hide the flashback text after 5 seconds
-    QTimer::singleShot(3500, this, [this]() { hideFlashbackText();});
+    // The next frames hide the text once the game clock has run for its duration
+    itsFlashbackHideMs = aGameTimeMs + FLASHBACK_TEXT_MS;
 }
 
 /**
@@ -1189,3 +1035,181 @@ void GUI::hideFlashbackText()
     itsFlashbackBackground->hide();
     itsFlashbackText->hide();
 }
+
+/**
+     * @brief Returns the number of world sprites drawn in the last frame.
+     *
+     * @return Number of sprites drawn.
+*/
+int GUI::getItsDrawnSprites() const
+{
+    return itsDrawnSprites;
+}
+
+/**
+     * @brief Returns the number of world sprites skipped in the last frame because off screen.
+     *
+     * @return Number of sprites culled.
+*/
+int GUI::getItsCulledSprites() const
+{
+    return itsCulledSprites;
+}
+
+/**
+     * @brief Selects the way the frames are drawn.
+     *
+     * @param aBackend Rendering backend.
+*/
+void GUI::setItsRenderBackend(RenderBackend aBackend)
+{
+    itsRenderBackend = aBackend;
+}
+
+/**
+     * @brief Returns the way the frames are drawn.
+     *
+     * @return Rendering backend.
+*/
+RenderBackend GUI::getItsRenderBackend() const
+{
+    return itsRenderBackend;
+}
+
+/**
+     * @brief Selects the kernel the software renderer and the render thread blend the sprites with.
+     *
+     * @param aKernel Kernel, the scalar one is used if the processor does not support it.
+*/
+void GUI::setBlitterKernel(SpriteBlitter::Kernel aKernel)
+{
+    itsSoftware.setItsKernel(aKernel);
+    itsRenderWorker.setItsKernel(aKernel);
+}
+
+/**
+     * @brief Enables the report of the sprites drawn and culled.
+     *
+     * @param isEnabled True to print the report every CULLING_REPORT_FRAMES frames.
+*/
+void GUI::setCullingReport(bool isEnabled)
+{
+    itsCullingReport = isEnabled;
+}
+
+/**
+     * @brief Renders frames offscreen with each backend and prints the time they took.
+     *
+     * The raster backend paints on an image of the size of the widget, the software backend composes
+     * its back buffer and draws it on that image, as it would on the widget, and the threaded backend
+     * has the render thread paint the frame, then presents it on that image. Each backend draws the
+     * same frames: the camera pans from the left to the right of the level, so that every entity is
+     * drawn, and the simulation does not run.
+     *
+     * @param aFrameNb Number of frames drawn by each backend.
+     * @return Exit code of the program.
+*/
+int GUI::benchmarkRender(int aFrameNb)
+{
+    struct Run
+    {
+        QString name;
+        RenderBackend backend;
+        SpriteBlitter::Kernel kernel;
+    };
+    QVector<Run> runs = {{"raster", RenderBackend::Raster, itsSoftware.getItsKernel()}};
+    for (int kernel = 0; kernel < static_cast<int>(SpriteBlitter::Kernel::KernelCount); ++kernel)
+    {
+        SpriteBlitter::Kernel candidate = static_cast<SpriteBlitter::Kernel>(kernel);
+        if (SpriteBlitter::isSupported(candidate))
+        {
+            runs.append({QString("software ") + SpriteBlitter::kernelName(candidate), RenderBackend::Software, candidate});
+        }
+    }
+    runs.append({QString("threaded ") + SpriteBlitter::kernelName(itsSoftware.getItsKernel()), RenderBackend::Threaded,
+                 itsSoftware.getItsKernel()});
+
+    // The simulation is stopped, every backend draws the same snapshot
+    itsGame->stop();
+    itsWorld = &itsGame->getSnapshot();
+    itsAlpha = 1.0;
+    RenderBackend previousBackend = itsRenderBackend;
+    SpriteBlitter::Kernel previousKernel = itsSoftware.getItsKernel();
+    qreal ratio = devicePixelRatioF();
+    QImage screen(size() * ratio, QImage::Format_ARGB32_Premultiplied);
+    screen.setDevicePixelRatio(ratio);
+    int levelWidth = itsWorld->levelWidth;
+
+    QTextStream out(stdout);
+    out << "Level " << itsWorld->levelNb << ": " << aFrameNb << " frames of " << width() << "x" << height()
+        << " at ratio " << ratio << " per backend, camera panned over " << levelWidth << " pixels" << Qt::endl;
+
+    for (const Run &run : runs)
+    {
+        itsRenderBackend = run.backend;
+        itsSoftware.setItsKernel(run.kernel);
+        itsRenderWorker.setItsKernel(run.kernel);
+        qint64 spriteNb = 0;
+        qint64 culledNb = 0;
+        qint64 batchNb = 0;
+        qint64 blitNb = 0;
+        qint64 fallbackNb = 0;
+
+        QElapsedTimer clock;
+        clock.start();
+        for (int frame = 0; frame < aFrameNb; ++frame)
+        {
+            int left = levelWidth > width() ? int(qint64(frame) * (levelWidth - width()) / std::max(aFrameNb - 1, 1)) : 0;
+            itsCamera = QRect(left, 0, width(), height());
+            record();
+            if (run.backend == RenderBackend::Threaded)
+            {
+                // Each frame is waited for, the time is the one of a frame, not of the overlap with the GUI thread
+                itsSnapshot.convertToImages();
+                itsRenderWorker.submit(std::move(itsSnapshot));
+                itsSnapshot = FrameSnapshot();
+                itsRenderWorker.waitForDone();
+                QPainter painter(&screen);
+                itsRenderWorker.present(&painter);
+                blitNb += itsRenderWorker.getItsBlitNb();
+                fallbackNb += itsRenderWorker.getItsFallbackNb();
+            }
+            else if (run.backend == RenderBackend::Software)
+            {
+                QImage *backBuffer = itsSoftware.backBuffer(size(), ratio);
+                QPainter painter(backBuffer);
+                replay(&painter, itsSnapshot);
+                painter.end();
+                QPainter(&screen).drawImage(0, 0, *backBuffer);
+                blitNb += itsSoftware.getItsBlitNb();
+                fallbackNb += itsSoftware.getItsFallbackNb();
+            }
+            else
+            {
+                QPainter painter(&screen);
+                replay(&painter, itsSnapshot);
+                batchNb += itsBatcher.getItsBatchNb();
+            }
+            spriteNb += itsDrawnSprites;
+            culledNb += itsCulledSprites;
+        }
+        qint64 elapsedNs = clock.nsecsElapsed();
+
+        out << "  " << run.name.leftJustified(16) << QString::number(elapsedNs / 1e6 / aFrameNb, 'f', 3).rightJustified(8)
+            << " ms/frame " << QString::number(aFrameNb / (elapsedNs / 1e9), 'f', 0).rightJustified(6) << " frames/s, "
+            << spriteNb / aFrameNb << " sprites/frame (" << culledNb / aFrameNb << " culled)";
+        if (run.backend != RenderBackend::Raster)
+        {
+            out << ", " << blitNb << " blended, " << fallbackNb << " drawn by the painter" << Qt::endl;
+        }
+        else
+        {
+            out << " in " << QString::number(double(batchNb) / aFrameNb, 'f', 1) << " batches" << Qt::endl;
+        }
+    }
+
+    itsRenderBackend = previousBackend;
+    itsSoftware.setItsKernel(previousKernel);
+    itsRenderWorker.setItsKernel(previousKernel);
+    return 0;
+}
@@ -11,6 +11,7 @@
 #include <QPainter>
 #include <QKeyEvent>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QPixmap>
 #include <QMap>
 #include <QString>
@@ -20,6 +21,26 @@
 #include "game.h"
 #include "optionsmenu.h"
 #include "pausemenu.h"
+#include "assetmanager.h"
+#include "framesnapshot.h"
+#include "renderworker.h"
+#include "spritebatcher.h"
+#include "softwarerenderer.h"
+#include "spriteregistry.h"
+#include "backgroundcache.h"
+#include "hudlayer.h"
+#include "levelmanifest.h"
+#include "levelprefetcher.h"
+
+/**
+ * @brief Way the frames are drawn.
+ */
+enum class RenderBackend
+{
+    Raster,   ///< QPainter on the widget, the sprites batched per atlas page
+    Software, ///< Composed in a back buffer, the sprites blended by the sprite blitter
+    Threaded  ///< Composed like Software by the render thread, the widget only presents the frames
+};
 
 /**
  * @brief Class representing the graphical user interface (GUI) for the game.
@@ -41,12 +62,14 @@ class GUI : public QWidget
     int counterCompanion = 0; /**< Counter for drawing the companion. */
     int gameOver = 0; /**< Game over state. */
     bool previousDirectionRightMC = false; /**< Flag indicating the previous direction of the main character. */
-    QPixmap backgroundPixmap; /**< Pixmap for the background image. */
     QPixmap gameOverPixmap; /**< Pixmap for the game over screen. */
-    QPixmap doorPixmap; /**< Pixmap for the door image. */
-    QMap<QString, QPixmap> characterPixmaps; /**< Map of character image file names to QPixmaps. */
-    QMap<QString, QPixmap> backgroundPixmaps; /**< Map of background image file names to QPixmaps. */
-    QMap<QString, QPixmap> elementPixmaps; /**< Map of element image file names to QPixmaps. */
+    AssetManager itsSprites = AssetManager(SpriteCount); /**< Pre-scaled sprites of the sets in use, indexed by SpriteId. */
+    SpriteBatcher itsBatcher; /**< Draws the world sprites of the same atlas page in one call. */
+    SoftwareRenderer itsSoftware; /**< Composes the frames in a back buffer when the software backend is selected. */
+    RenderBackend itsRenderBackend = RenderBackend::Threaded; /**< Way the frames are drawn. */
+    FrameSnapshot itsSnapshot; /**< Frame being recorded, then the last frame recorded when it is painted on the GUI thread. */
+    BackgroundCache itsBackground; /**< Background of the current level, pre-scaled into screen-wide tiles. */
+    HudLayer itsHud; /**< HUD composed from a glyph atlas, redrawn only when its values change. */
     QLabel* itsFlashbackBackground; /**< Pointer to the flashback background label. */
     QLabel* itsFlashbackText; /**< Pointer to the flashback text label. */
     QLabel* gameOverLabel; /**< Label for displaying the game over message. */
@@ -57,13 +80,35 @@ class GUI : public QWidget
     int attackFrameCounter; /**< Counter for attack animation frames. */
     bool isAttacking; /**< Flag indicating whether the main character is currently attacking. */
     QVector<QPixmap> loadingPixmaps; /**< Vector of loading animation frames. */
-    QMap<QString, QPixmap> doorPixmaps; /**< Map of door image file names to QPixmaps. */
     bool isLoading; /**< Flag indicating whether a loading animation is in progress. */
     int frameIndex; /**< Index of the current frame in the loading animation. */
     QTimer* loadingTimer; /**< Timer for controlling the loading animation. */
     int frameCounter = 0; /**< Counter for frame updates. */
     bool firstLoad; /**< Flag indicating whether it's the first load of the game. */
     bool actionInProgress; /**< Flag indicating whether an action is currently in progress. */
+    const WorldSnapshot *itsWorld = nullptr; /**< Snapshot of the world the current frame is drawn from, valid until the next Game::getSnapshot(). */
+    double itsAlpha = 1.0; /**< Interpolation factor between the last two ticks for the current frame. */
+    QRect itsCamera; /**< Rectangle of the level seen by the camera in the current frame. */
+    int itsDrawnSprites = 0; /**< Number of world sprites drawn in the current frame. */
+    int itsCulledSprites = 0; /**< Number of world sprites skipped in the current frame because off screen. */
+    bool itsCullingReport = false; /**< True to print the culling report, set from the command line. */
+    qint64 itsTotalDrawnSprites = 0; /**< Number of world sprites drawn since the last culling report. */
+    qint64 itsTotalCulledSprites = 0; /**< Number of world sprites culled since the last culling report. */
+    qint64 itsTotalBatches = 0; /**< Number of sprite batches sent since the last culling report. */
+    int itsCullingFrames = 0; /**< Number of frames painted, used to pace the culling report. */
+    static constexpr int CULLING_REPORT_FRAMES = 1000; /**< Number of frames between two culling reports. */
+    LevelPrefetcher itsPrefetcher{&itsSprites}; /**< Builds the next level and decodes its assets while the player reaches the door. */
+    PreparedAssets itsPendingAssets; /**< Prefetched assets of the level being swapped in, empty otherwise. */
+    Era itsSpriteEra = Era::None; /**< Era of the main character and enemy sprites bound in the asset manager. */
+    static constexpr const char *ERA_SET = "era"; /**< Asset set of the main character and enemy sprites. */
+    static constexpr const char *COMMON_SET = "common"; /**< Asset set of the sprites shared by every level. */
+    static constexpr const char *NEXT_SET = "next"; /**< Asset set of the sprites prefetched for the next level. */
+    QElapsedTimer itsLoadingClock; /**< Time spent in the current loading animation. */
+    static constexpr int LOADING_FRAME_MS = 500; /**< Duration of a frame of the loading animation. */
+    static constexpr int LOADING_POLL_MS = 50; /**< Interval between two checks of the prefetch while loading. */
+    static constexpr int FLASHBACK_TEXT_MS = 3500; /**< Time the text of a flashback object stays on screen, on the game clock. */
+    qint64 itsFlashbackHideMs = 0; /**< Time on the game clock at which the flashback text is hidden. */
+    RenderWorker itsRenderWorker{this}; /**< Paints the recorded frames on the render thread with the threaded backend. */
 
 public:
     /**
@@ -79,6 +124,56 @@ public:
      */
     ~GUI();
 
+    /**
+     * @brief Returns the number of world sprites drawn in the last frame.
+     *
+     * @return Number of sprites drawn.
+     */
+    int getItsDrawnSprites() const;
+
+    /**
+     * @brief Returns the number of world sprites skipped in the last frame because off screen.
+     *
+     * @return Number of sprites culled.
+     */
+    int getItsCulledSprites() const;
+
+    /**
+     * @brief Selects the way the frames are drawn.
+     *
+     * @param aBackend Rendering backend.
+     */
+    void setItsRenderBackend(RenderBackend aBackend);
+
+    /**
+     * @brief Returns the way the frames are drawn.
+     *
+     * @return Rendering backend.
+     */
+    RenderBackend getItsRenderBackend() const;
+
+    /**
+     * @brief Selects the kernel the software renderer and the render thread blend the sprites with.
+     *
+     * @param aKernel Kernel, the scalar one is used if the processor does not support it.
+     */
+    void setBlitterKernel(SpriteBlitter::Kernel aKernel);
+
+    /**
+     * @brief Enables the report of the sprites drawn and culled, printed every CULLING_REPORT_FRAMES frames.
+     *
+     * @param isEnabled True to print the report, it is off by default.
+     */
+    void setCullingReport(bool isEnabled);
+
+    /**
+     * @brief Renders frames offscreen with each backend and prints the time they took.
+     *
+     * @param aFrameNb Number of frames drawn by each backend.
+     * @return Exit code of the program.
+     */
+    int benchmarkRender(int aFrameNb);
+
 protected:
     /**
      * @brief Event handler for painting the GUI.
@@ -87,6 +182,19 @@ protected:
      */
     void paintEvent(QPaintEvent *event) override;
 
+    /**
+     * @brief Records the current frame in the snapshot.
+     */
+    void record();
+
+    /**
+     * @brief Paints a recorded frame on the GUI thread, with the raster or the software backend.
+     *
+     * @param aPainter Painter of the widget, or of the back buffer of the software renderer.
+     * @param aSnapshot Frame recorded, its pixmaps not converted.
+     */
+    void replay(QPainter *aPainter, const FrameSnapshot &aSnapshot);
+
     /**
      * @brief Event handler for key press events.
      *
@@ -110,79 +218,66 @@ protected:
 
 private:
     /**
-     * @brief Loads images used in the GUI.
+     * @brief Records a frame and has it painted, called by the timer of the GUI.
      */
-    void loadImages();
+    void nextFrame();
 
     /**
-     * @brief Draws the characters in the game.
+     * @brief Starts the prefetch of the next level once the main character is close to the door.
      *
-     * @param aPainter Pointer to the painter object used for drawing.
+     * Once the prefetch is done, the sprites of the next era are acquired in the asset manager.
      */
-    void drawCharacters(QPainter * aPainter);
+    void prefetchNextLevel();
+
+    /**
+     * @brief Draws the characters in the game.
+     */
+    void drawCharacters();
 
     /**
      * @brief Draws the main character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawMainCharacter(QPainter * aPainter);
+    void drawMainCharacter();
 
     /**
      * @brief Draws the obstacles in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawObstacles(QPainter * aPainter);
+    void drawObstacles();
 
     /**
      * @brief Draws the boss differents character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawBoss(QPainter *aPainter);
+    void drawBoss();
 
     /**
      * @brief Draws the companion character in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawCompanion(QPainter * aPainter);
+    void drawCompanion();
 
     /**
      * @brief Draws the flashback objects in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawFlashbackObjects(QPainter * aPainter);
+    void drawFlashbackObjects();
 
     /**
      * @brief Draws the collectible pieces in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawPieces(QPainter * aPainter);
+    void drawPieces();
 
     /**
      * @brief Draws the HUD (Heads-Up Display) in the game.
-     *
-     * @param aPainter Pointer to the painter object used for drawing.
      */
-    void drawHUD(QPainter * aPainter);
+    void drawHUD();
 
     /**
      * @brief Draws the main character's attack animation.
-     *
-     * @param painter Pointer to the painter object used for drawing.
      */
-    void drawAttackMC(QPainter *painter);
+    void drawAttackMC();
 
     /**
      * @brief Draws the main character in a dead state.
-     *
-     * @param painter Pointer to the painter object used for drawing.
      */
-    void drawDeadMainCharacter(QPainter *painter);
+    void drawDeadMainCharacter();
 
     /**
      * @brief Displays the game over screen.
@@ -190,21 +285,43 @@ private:
     void displayGameOverScreen();
 
     /**
-     * @brief Updates the background image.
+     * @brief Draws the door in the game.
      */
-    void updateBackground();
+    void drawDoor();
 
     /**
-     * @brief Draws the door in the game.
+     * @brief Restarts the game.
+     */
+    void restartGame();
+
+    /**
+     * @brief Updates the rectangle of the level seen by the camera.
+     */
+    void updateCamera();
+
+    /**
+     * @brief Checks whether a rectangle of the level is seen by the camera, and counts it as drawn or culled.
      *
-     * @param aPainter Pointer to the painter object used for drawing.
+     * @param aRect Rectangle in level coordinates.
+     * @return True if the rectangle must be drawn.
      */
-    void drawDoor(QPainter *aPainter);
+    bool isVisible(const QRect &aRect);
 
     /**
-     * @brief Restarts the game.
+     * @brief Draws a sprite of the level, unless it is outside of the camera.
+     *
+     * @param aRect Rectangle of the sprite in level coordinates.
+     * @param aSprite Sprite to draw.
      */
-    void restartGame();
+    void drawSprite(const QRect &aRect, SpriteId aSprite);
+
+    /**
+     * @brief Draws a frame with the backend in use, without culling.
+     *
+     * @param aRect Rectangle of the frame in level coordinates.
+     * @param aFrame Frame to draw.
+     */
+    void drawFrame(const QRect &aRect, const SpriteFrame &aFrame);
 
     /**
      * @brief Handles the action to continue the game.
@@ -217,12 +334,27 @@ private:
     void showOptionsMenu();
 
 private slots:
+    /**
+     * @brief Makes the sprites of the current level resident in the asset manager.
+     *
+     * Called once per level load, the sprites are only acquired again when the era changes.
+     */
+    void loadImages();
+
+    /**
+     * @brief Updates the background image and the music for the current level.
+     *
+     * Called once per level load, the background is scaled and cut into tiles here.
+     */
+    void updateBackground();
+
     /**
      * @brief Slot for drawing flashback text.
      *
      * @param aText The text to display in the flashback.
+     * @param aGameTimeMs Time the object was collected, on the game clock.
      */
-    void drawFlashbackText(QString aText);
+    void drawFlashbackText(QString aText, qint64 aGameTimeMs);
 
     /**
      * @brief Slot for hiding flashback text.
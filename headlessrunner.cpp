@@ -0,0 +1,176 @@
+/**
+ * @file headlessrunner.cpp
+ * @brief Implementation of the HeadlessRunner class methods.
+ */
+
+#include "headlessrunner.h"
+#include "fixedstepscheduler.h"
+#include "game.h"
+#include "levelmanifest.h"
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <cstring>
+
+/**
+ * @brief Checks whether the command line asks for the headless mode.
+ * @param argc Number of arguments passed to the program.
+ * @param argv Array of arguments passed to the program.
+ * @return True if --headless is one of the arguments.
+ */
+bool HeadlessRunner::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the options of the headless mode from the command line.
+ * @param arguments Arguments of the application, including the program name.
+ * @return True if the options are valid, false otherwise.
+ */
+bool HeadlessRunner::parseArguments(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Nova: The Temporal Explorer, headless simulation");
+    parser.addHelpOption();
+    parser.addOption({"headless", "Run the simulation without window, audio nor GUI."});
+    parser.addOption({"level", "Number of the level to simulate.", "N", "1"});
+    parser.addOption({"ticks", "Number of ticks to run.", "K", "100000"});
+    parser.addOption({"seed", "Seed of the gameplay random numbers.", "S", "0"});
+    parser.addOption({"tick-rate", "Simulation ticks per second: 60, 100, 120 or 240.", "Hz", "100"});
+    parser.addOption({"record", "Record the run into a replay file.", "file"});
+    parser.addOption({"replay", "Play a replay file, its level, seed, tick rate and ticks replace the options.", "file"});
+    parser.process(arguments);
+
+    bool levelOk = false;
+    bool ticksOk = false;
+    bool seedOk = false;
+    bool tickRateOk = false;
+    itsLevelNb = parser.value("level").toInt(&levelOk);
+    itsTicks = parser.value("ticks").toLongLong(&ticksOk);
+    itsSeed = parser.value("seed").toULongLong(&seedOk);
+    itsTickRate = parser.value("tick-rate").toInt(&tickRateOk);
+    itsRecordPath = parser.value("record");
+    itsReplayPath = parser.value("replay");
+
+    QTextStream err(stderr);
+    if (!levelOk || itsLevelNb < 0 || itsLevelNb >= LevelManifest::instance().getItsLevelNb())
+    {
+        err << "Invalid level number: " << parser.value("level") << Qt::endl;
+        return false;
+    }
+    if (!ticksOk || itsTicks <= 0)
+    {
+        err << "Invalid number of ticks: " << parser.value("ticks") << Qt::endl;
+        return false;
+    }
+    if (!seedOk)
+    {
+        err << "Invalid seed: " << parser.value("seed") << Qt::endl;
+        return false;
+    }
+    if (!tickRateOk || !FixedStepScheduler::isSupportedTickRate(itsTickRate))
+    {
+        err << "Invalid tick rate: " << parser.value("tick-rate") << Qt::endl;
+        return false;
+    }
+    if (!itsRecordPath.isEmpty() && !itsReplayPath.isEmpty())
+    {
+        err << "--record and --replay cannot be used together" << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs the simulation and prints the report.
+ * @return Exit code of the program.
+ */
+int HeadlessRunner::run()
+{
+    Game game(nullptr, itsLevelNb, true, itsSeed);
+    game.setTickRate(itsTickRate);
+    if (!itsReplayPath.isEmpty())
+    {
+        if (!game.startReplay(itsReplayPath) || game.getReplayTickNb() == 0)
+        {
+            QTextStream(stderr) << "Invalid or empty replay: " << itsReplayPath << Qt::endl;
+            return 1;
+        }
+        itsLevelNb = game.getItsLevel()->getItsNb();
+        itsSeed = game.getItsSeed();
+        itsTicks = game.getReplayTickNb();
+        itsTickRate = game.getTickRate();
+    }
+    else if (!game.getItsLevel()->isLoaded() || (!itsRecordPath.isEmpty() && !game.startRecording(itsRecordPath)))
+    {
+        QTextStream(stderr) << "Level " << itsLevelNb << " could not be loaded" << Qt::endl;
+        return 1;
+    }
+    game.setProfiling(true);
+
+    int deaths = 0;
+    QElapsedTimer clock;
+    clock.start();
+
+    for (qint64 tick = 0; tick < itsTicks; ++tick)
+    {
+        game.step();
+
+        // Reload the level outside of the game loop, which still uses it while it runs
+        if (game.getItsDead() && itsReplayPath.isEmpty())
+        {
+            deaths++;
+            if (!game.loadLevel(itsLevelNb))
+            {
+                QTextStream(stderr) << "Level " << itsLevelNb << " could not be loaded again" << Qt::endl;
+                return 1;
+            }
+        }
+    }
+
+    qint64 elapsedNs = clock.nsecsElapsed();
+    double elapsedMs = elapsedNs / 1e6;
+
+    QTextStream out(stdout);
+    out << "Level " << itsLevelNb << ": " << itsTicks << " ticks in "
+        << QString::number(elapsedMs, 'f', 1) << " ms ("
+        << QString::number(itsTicks / (elapsedNs / 1e9), 'f', 0) << " ticks/s, simulated at " << itsTickRate << " Hz), "
+        << deaths << " deaths, seed " << itsSeed << Qt::endl;
+
+    for (int phase = 0; phase < Game::PhaseCount; ++phase)
+    {
+        qint64 phaseNs = game.getPhaseNsecs(static_cast<Game::Phase>(phase));
+        out << "  " << Game::getPhaseName(static_cast<Game::Phase>(phase)).leftJustified(16)
+            << QString::number(phaseNs / 1e6, 'f', 2).rightJustified(10) << " ms "
+            << QString::number(phaseNs / 1e3 / itsTicks, 'f', 3).rightJustified(9) << " us/tick" << Qt::endl;
+    }
+
+    // Only the current level should be alive, whatever the number of reloads
+    out << "  Arena: " << LevelArena::getLiveObjectNb() << " live entities, "
+        << QString::number(LevelArena::getLiveBytes() / 1024.0, 'f', 1) << " KB live, current level "
+        << game.getItsLevel()->getItsArena()->getItsObjectNb() << " entities in "
+        << QString::number(game.getItsLevel()->getItsArena()->getItsBytesUsed() / 1024.0, 'f', 1) << " KB" << Qt::endl;
+
+    if (!itsRecordPath.isEmpty() && !game.stopRecording())
+    {
+        return 1;
+    }
+    if (!itsReplayPath.isEmpty())
+    {
+        if (game.getDivergentTick() >= 0)
+        {
+            out << "  Replay diverged at tick " << game.getDivergentTick() << Qt::endl;
+            return 2;
+        }
+        out << "  Replay identical to the recorded run" << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The HeadlessRunner class runs the simulation without GUI, audio nor window.
+ *
+ * It steps the game loop as fast as possible for a given number of ticks, then
+ * prints the tick rate reached and the time spent in each phase of the game loop.
+ * It is meant for benchmarks and soak tests on machines without display. It can
+ * record the run into a replay, or play a replay recorded with or without GUI
+ * and check that every tick reproduces the recorded state.
+ */
+class HeadlessRunner
+{
+    int itsLevelNb = 1; /**< Number of the level to simulate. */
+    qint64 itsTicks = 100000; /**< Number of ticks to run. */
+    quint64 itsSeed = 0; /**< Seed of the gameplay random numbers, fixed so the runs are comparable. */
+    int itsTickRate = 100; /**< Simulation ticks per second. */
+    QString itsRecordPath; /**< Replay file to record the run into, empty for none. */
+    QString itsReplayPath; /**< Replay file to play instead of the level, empty for none. */
+
+public:
+    /**
+     * @brief Checks whether the command line asks for the headless mode.
+     *
+     * Called before the application object exists, to avoid creating a GUI application.
+     *
+     * @param argc Number of arguments passed to the program
+     * @param argv Array of arguments passed to the program
+     * @return True if --headless is one of the arguments
+     */
+    static bool isRequested(int argc, char *argv[]);
+
+    /**
+     * @brief Reads the options of the headless mode from the command line.
+     *
+     * @param arguments Arguments of the application, including the program name
+     * @return True if the options are valid, false otherwise
+     */
+    bool parseArguments(const QStringList &arguments);
+
+    /**
+     * @brief Runs the simulation and prints the report on the standard output.
+     *
+     * When the player dies, the level is reloaded and the run goes on. A replay runs
+     * its own ticks, tick rate and level loads instead.
+     *
+     * @return Exit code of the program, 1 if the level cannot be loaded, 2 if the replay diverged
+     */
+    int run();
+};
+
+#endif // HEADLESSRUNNER_H
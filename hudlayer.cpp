@@ -0,0 +1,189 @@
+/**
+ * @file hudlayer.cpp
+ * @brief Implementation of the HudLayer class methods.
+ */
+
+#include "hudlayer.h"
+#include <QImage>
+#include <QDebug>
+#include <algorithm>
+
+/**
+ * @brief Decodes the HUD images and packs them into the glyph atlas.
+ *
+ * Each glyph is smooth-scaled to its draw size once, then copied next to the previous one.
+ *
+ * @param aDevicePixelRatio Device pixel ratio of the screen the HUD is drawn on.
+ */
+void HudLayer::loadAtlas(qreal aDevicePixelRatio)
+{
+    struct GlyphSource
+    {
+        QString path;
+        QSize size;
+    };
+
+    GlyphSource sources[GlyphCount];
+    for (int digit = 0; digit <= 9; ++digit)
+    {
+        sources[Digit0 + digit] = {":/hud/assets/hud_elements/font/" + QString::number(digit) + "_font.png", QSize(FONT_SIZE, FONT_SIZE)};
+    }
+    sources[Slash] = {":/hud/assets/hud_elements/font/slash.png", QSize(FONT_SIZE, FONT_SIZE)};
+    sources[Lvl] = {":/hud/assets/hud_elements/font/lvl.png", QSize(LVL_WIDTH, FONT_SIZE)};
+    sources[HeartFull] = {":/hud/assets/hud_elements/heart/heart_full.png", QSize(HEART_SIZE, HEART_SIZE)};
+    sources[HeartHalf] = {":/hud/assets/hud_elements/heart/heart_half.png", QSize(HEART_SIZE, HEART_SIZE)};
+    sources[HeartEmpty] = {":/hud/assets/hud_elements/heart/heart_empty.png", QSize(HEART_SIZE, HEART_SIZE)};
+    sources[Piece] = {":/hud/assets/hud_elements/piece/piece.png", QSize(PIECE_SIZE, PIECE_SIZE)};
+
+    itsDevicePixelRatio = aDevicePixelRatio;
+
+    // Every glyph goes on one row, one pixel apart so that smooth sampling does not bleed
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    for (int glyph = 0; glyph < GlyphCount; ++glyph)
+    {
+        QSize deviceSize = sources[glyph].size * aDevicePixelRatio;
+        itsGlyphRects[glyph] = QRect(QPoint(atlasWidth, 0), deviceSize);
+        atlasWidth += deviceSize.width() + 1;
+        atlasHeight = std::max(atlasHeight, deviceSize.height());
+    }
+
+    QImage atlas(atlasWidth, atlasHeight, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+
+    QPainter painter(&atlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int glyph = 0; glyph < GlyphCount; ++glyph)
+    {
+        QImage source(sources[glyph].path);
+        if (source.isNull())
+        {
+            qDebug() << "Failed to load HUD glyph" << sources[glyph].path;
+            continue;
+        }
+        painter.drawImage(itsGlyphRects[glyph].topLeft(),
+                          source.scaled(itsGlyphRects[glyph].size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+    painter.end();
+
+    itsAtlas = QPixmap::fromImage(atlas);
+
+    // Force the layer to be composed with the new glyphs
+    itsHP = -1;
+}
+
+/**
+ * @brief Updates the displayed values, the layer is only composed again if one changed.
+ * @param aWidth Width of the screen, in logical pixels.
+ * @param aHP Health points of the main character.
+ * @param aPieceNb Number of pieces of the main character.
+ * @param aObjectNb Number of flashback objects found in the level.
+ * @param aObjectTotal Number of flashback objects of the level.
+ * @param aLevelNb Level number shown to the player.
+ * @return True if the layer was composed again.
+ */
+bool HudLayer::update(int aWidth, int aHP, int aPieceNb, int aObjectNb, int aObjectTotal, int aLevelNb)
+{
+    if (aWidth == itsWidth && aHP == itsHP && aPieceNb == itsPieceNb && aObjectNb == itsObjectNb
+        && aObjectTotal == itsObjectTotal && aLevelNb == itsLevelNb)
+    {
+        return false;
+    }
+
+    itsWidth = aWidth;
+    itsHP = aHP;
+    itsPieceNb = aPieceNb;
+    itsObjectNb = aObjectNb;
+    itsObjectTotal = aObjectTotal;
+    itsLevelNb = aLevelNb;
+    redraw();
+    return true;
+}
+
+/**
+ * @brief Composes the layer for the current values.
+ */
+void HudLayer::redraw()
+{
+    itsLayer = QPixmap(QSize(itsWidth, LAYER_HEIGHT) * itsDevicePixelRatio);
+    itsLayer.setDevicePixelRatio(itsDevicePixelRatio);
+    itsLayer.fill(Qt::transparent);
+
+    QPainter painter(&itsLayer);
+
+    // Pieces number, then the piece icon
+    drawNumber(&painter, itsPieceNb, 30 + FONT_SIZE, 100, true);
+    drawGlyph(&painter, Piece, QRect(80, 95, PIECE_SIZE, PIECE_SIZE));
+
+    // Health, two points per heart
+    for (int heart = 0; heart < 3; ++heart)
+    {
+        int points = itsHP - 2 * heart;
+        Glyph glyph = points >= 2 ? HeartFull : (points == 1 ? HeartHalf : HeartEmpty);
+        drawGlyph(&painter, glyph, QRect(30 + 60 * heart, 30, HEART_SIZE, HEART_SIZE));
+    }
+
+    // Objects found, a slash in the middle of the screen, then the objects of the level
+    int slashX = itsWidth / 2 - FONT_SIZE / 2;
+    drawGlyph(&painter, Slash, QRect(slashX, 35, FONT_SIZE, FONT_SIZE));
+    drawNumber(&painter, itsObjectNb, slashX, 35, true);
+    drawNumber(&painter, itsObjectTotal, slashX + FONT_SIZE, 35, false);
+
+    // Level label and number, against the right edge
+    int levelX = drawNumber(&painter, itsLevelNb, itsWidth - 30, 35, true);
+    drawGlyph(&painter, Lvl, QRect(levelX - LVL_WIDTH - 10, 35, LVL_WIDTH, FONT_SIZE));
+
+    itsRedrawNb++;
+}
+
+/**
+ * @brief Draws a glyph of the atlas.
+ * @param aPainter Painter of the layer.
+ * @param aGlyph Glyph to draw.
+ * @param aTarget Rectangle to draw the glyph in, in logical pixels.
+ */
+void HudLayer::drawGlyph(QPainter *aPainter, Glyph aGlyph, const QRect &aTarget) const
+{
+    aPainter->drawPixmap(aTarget, itsAtlas, itsGlyphRects[aGlyph]);
+}
+
+/**
+ * @brief Draws a number with one digit glyph per digit.
+ * @param aPainter Painter of the layer.
+ * @param aNumber Number to draw, negative numbers are drawn as 0.
+ * @param aX Left of the number if aAlignRight is false, right of the number otherwise.
+ * @param aY Top of the number.
+ * @param aAlignRight True to end the number at aX instead of starting it there.
+ * @return Left of the drawn number.
+ */
+int HudLayer::drawNumber(QPainter *aPainter, int aNumber, int aX, int aY, bool aAlignRight) const
+{
+    QString digits = QString::number(std::max(aNumber, 0));
+    int left = aAlignRight ? aX - FONT_SIZE * digits.size() : aX;
+
+    for (int index = 0; index < digits.size(); ++index)
+    {
+        Glyph glyph = static_cast<Glyph>(Digit0 + digits.at(index).digitValue());
+        drawGlyph(aPainter, glyph, QRect(left + FONT_SIZE * index, aY, FONT_SIZE, FONT_SIZE));
+    }
+    return left;
+}
+
+/**
+ * @brief Records the cached layer in a frame.
+ * @param aSnapshot Snapshot of the frame.
+ * @param aTopLeft Position of the top left corner of the screen in the coordinates of the snapshot.
+ */
+void HudLayer::draw(FrameSnapshot *aSnapshot, const QPoint &aTopLeft) const
+{
+    aSnapshot->drawPixmap(aTopLeft, itsLayer);
+}
+
+/**
+ * @brief Returns the number of times the layer was composed.
+ * @return Number of redraws.
+ */
+int HudLayer::getItsRedrawNb() const
+{
+    return itsRedrawNb;
+}
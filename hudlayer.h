@@ -0,0 +1,117 @@
+#ifndef HUDLAYER_H
+#define HUDLAYER_H
+
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <QString>
+#include "framesnapshot.h"
+
+/**
+ * @brief The HudLayer class composes the HUD (Heads-Up Display) into a cached layer.
+ *
+ * The digits, slash, level label, hearts and piece icon are decoded and scaled once into
+ * a single glyph atlas. The layer is only redrawn from the atlas when one of the displayed
+ * values changes, so a frame that shows the same values just copies the cached layer.
+ */
+class HudLayer
+{
+public:
+    /**
+     * @brief Glyphs stored in the atlas, the digits come first so that a digit is its own glyph.
+     */
+    enum Glyph
+    {
+        Digit0, Digit1, Digit2, Digit3, Digit4, Digit5, Digit6, Digit7, Digit8, Digit9,
+        Slash,
+        Lvl,
+        HeartFull,
+        HeartHalf,
+        HeartEmpty,
+        Piece,
+        GlyphCount
+    };
+
+private:
+    QPixmap itsAtlas; /**< Every glyph, scaled to its draw size and packed on one row. */
+    QRect itsGlyphRects[GlyphCount]; /**< Rectangle of each glyph in the atlas, in device pixels. */
+    QPixmap itsLayer; /**< HUD composed for the last displayed values. */
+    qreal itsDevicePixelRatio = 1.0; /**< Device pixel ratio the atlas and the layer are rendered for. */
+    int itsWidth = 0; /**< Width of the layer, in logical pixels. */
+    int itsHP = -1; /**< Health points shown in the layer. */
+    int itsPieceNb = -1; /**< Number of pieces shown in the layer. */
+    int itsObjectNb = -1; /**< Number of flashback objects found shown in the layer. */
+    int itsObjectTotal = -1; /**< Number of flashback objects of the level shown in the layer. */
+    int itsLevelNb = -1; /**< Level number shown in the layer. */
+    int itsRedrawNb = 0; /**< Number of times the layer was composed. */
+
+    static constexpr int FONT_SIZE = 40; /**< Size of a digit and of the slash. */
+    static constexpr int PIECE_SIZE = 50; /**< Size of the piece icon. */
+    static constexpr int HEART_SIZE = 55; /**< Size of a heart. */
+    static constexpr int LVL_WIDTH = FONT_SIZE * 3 + 10; /**< Width of the level label. */
+    static constexpr int LAYER_HEIGHT = 150; /**< Height of the layer, it covers the top of the screen. */
+
+    /**
+     * @brief Draws a glyph of the atlas.
+     *
+     * @param aPainter Painter of the layer
+     * @param aGlyph Glyph to draw
+     * @param aTarget Rectangle to draw the glyph in, in logical pixels
+     */
+    void drawGlyph(QPainter *aPainter, Glyph aGlyph, const QRect &aTarget) const;
+
+    /**
+     * @brief Draws a number with one digit glyph per digit.
+     *
+     * @param aPainter Painter of the layer
+     * @param aNumber Number to draw, negative numbers are drawn as 0
+     * @param aX Left of the number if aAlignRight is false, right of the number otherwise
+     * @param aY Top of the number
+     * @param aAlignRight True to end the number at aX instead of starting it there
+     * @return Left of the drawn number
+     */
+    int drawNumber(QPainter *aPainter, int aNumber, int aX, int aY, bool aAlignRight) const;
+
+    /**
+     * @brief Composes the layer for the current values.
+     */
+    void redraw();
+
+public:
+    /**
+     * @brief Decodes the HUD images and packs them into the glyph atlas.
+     *
+     * @param aDevicePixelRatio Device pixel ratio of the screen the HUD is drawn on
+     */
+    void loadAtlas(qreal aDevicePixelRatio = 1.0);
+
+    /**
+     * @brief Updates the displayed values, the layer is only composed again if one changed.
+     *
+     * @param aWidth Width of the screen, in logical pixels
+     * @param aHP Health points of the main character
+     * @param aPieceNb Number of pieces of the main character
+     * @param aObjectNb Number of flashback objects found in the level
+     * @param aObjectTotal Number of flashback objects of the level
+     * @param aLevelNb Level number shown to the player
+     * @return True if the layer was composed again
+     */
+    bool update(int aWidth, int aHP, int aPieceNb, int aObjectNb, int aObjectTotal, int aLevelNb);
+
+    /**
+     * @brief Records the cached layer in a frame.
+     *
+     * @param aSnapshot Snapshot of the frame
+     * @param aTopLeft Position of the top left corner of the screen in the coordinates of the snapshot
+     */
+    void draw(FrameSnapshot *aSnapshot, const QPoint &aTopLeft) const;
+
+    /**
+     * @brief Returns the number of times the layer was composed.
+     *
+     * @return Number of redraws
+     */
+    int getItsRedrawNb() const;
+};
+
+#endif // HUDLAYER_H
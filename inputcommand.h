@@ -0,0 +1,31 @@
+#ifndef INPUTCOMMAND_H
+#define INPUTCOMMAND_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Actions of the player the simulation applies at the start of a tick.
+ */
+enum class InputAction
+{
+    Left,   ///< Move the main character and the companion to the left
+    Right,  ///< Move the main character and the companion to the right
+    Jump,   ///< Make the main character and the companion jump
+    Attack  ///< Attack with the main character, only on press
+};
+
+/**
+ * @brief The InputCommand struct is a key event turned into a value the simulation thread can read.
+ *
+ * The GUI thread posts the commands in a queue as the keys are pressed and released, the
+ * simulation drains the queue at the start of each tick, so every command applies to exactly
+ * one tick.
+ */
+struct InputCommand
+{
+    qint64 timeNs = 0; ///< Time the command was posted, on the clock of the game
+    InputAction action = InputAction::Left; ///< Action of the player
+    bool pressed = false; ///< True when the key was pressed, false when it was released
+};
+
+#endif // INPUTCOMMAND_H
@@ -1,6 +1,6 @@
 #include "level.h"
 #include "optionsmenu.h"
-#include <QTextStream>
+#include "levelmanifest.h"
 #include <QDebug>
 #include <QFile>
 #include <QMediaPlayer>
@@ -10,205 +10,188 @@
 /**
  * @brief Constructor of the Level class.
  *
- * Initializes a level by loading elements from a specific text file associated with the level.
+ * Initializes a level by loading elements from the compiled file the level manifest gives the level,
+ * or from its text file if the compiled one is missing or invalid.
  * Loads main characters, obstacles, enemies, pieces, flashback objects, and bosses based on the level number.
- * Also starts playing a default audio file in a loop.
+ * Also starts playing the music of the level in a loop, unless the level is built without audio.
+ * A level that cannot be loaded is left empty, isLoaded() tells it apart.
  *
  * @param aNumber Level number to load.
+ * @param withAudio False to skip the music player.
+ * @param aSeed Seed of the game, mixed with the level number to seed the generator of the level.
  */
-Level::Level(int aNumber) : itsNb(aNumber), itsMainCharacter(nullptr), itsDoor(nullptr)
+Level::Level(int aNumber, bool withAudio, quint64 aSeed) : itsNb(aNumber), itsMainCharacter(nullptr), itsDoor(nullptr)
 {
+    setSeed(aSeed);
+
     itsObstacles = new std::list<Obstacle*>;
     itsEnemies = new std::list<Character*>;
     itsPieces = new std::list<Piece *>;
     itsFlashbackObjects = new list<FlashbackObject *>;
 
-    QString levelFileName;
-    if (itsNb == 0)
-    {
-        levelFileName = ":/level/assets/level/level0.txt";
-        setItsLevelWidth(3840);
-    }
-    else if (itsNb == 2)
+    const LevelInfo &info = LevelManifest::instance().getLevel(itsNb);
+    if (info.file.isEmpty())
     {
-        levelFileName = ":/level/assets/level/boss1.txt";
-        setItsLevelWidth(1280);
+        qDebug() << "No level" << itsNb << "in the level manifest";
     }
-    else if (itsNb == 3)
+    setItsLevelWidth(info.width);
+    QString levelName = info.file;
+
+    LevelFormat::View view;
+    std::string error;
+    bool loaded = false;
+
+    // The compiled level is mapped in place when it is stored uncompressed, and read otherwise
+    QFile compiledFile(levelName + ".nlvl");
+    uchar *mapped = nullptr;
+    QByteArray content;
+    if (!levelName.isEmpty() && compiledFile.open(QIODevice::ReadOnly))
     {
-        levelFileName = ":/level/assets/level/level2.txt";
+        mapped = compiledFile.map(0, compiledFile.size());
+        if (mapped == nullptr)
+        {
+            content = compiledFile.readAll();
+        }
+        const uchar *data = mapped != nullptr ? mapped : reinterpret_cast<const uchar *>(content.constData());
+        size_t size = mapped != nullptr ? size_t(compiledFile.size()) : size_t(content.size());
+
+        loaded = LevelFormat::open(data, size, view, error);
+        if (!loaded)
+        {
+            qDebug() << "Invalid compiled level" << compiledFile.fileName() << ":" << QString::fromStdString(error);
+        }
     }
-    else if (itsNb == 4)
+
+    // Without a valid compiled level, the text level is compiled in memory
+    std::vector<unsigned char> compiled;
+    if (!loaded && !levelName.isEmpty())
     {
-        levelFileName = ":/level/assets/level/boss2.txt";
-        setItsLevelWidth(1280);
+        QFile textFile(levelName + ".txt");
+        if (textFile.open(QIODevice::ReadOnly))
+        {
+            QByteArray text = textFile.readAll();
+            loaded = LevelFormat::compile(std::string_view(text.constData(), size_t(text.size())), textFile.fileName().toStdString(), compiled, error)
+                     && LevelFormat::open(compiled.data(), compiled.size(), view, error);
+            if (!loaded)
+            {
+                qDebug() << "Invalid level" << QString::fromStdString(error);
+            }
+        }
+        else
+        {
+            qDebug() << "Failed to open file" << textFile.fileName();
+        }
     }
-    else if (itsNb == 5)
+
+    if (loaded)
     {
-        levelFileName = ":/level/assets/level/level3.txt";
+        buildEntities(view);
     }
-    else if (itsNb == 6)
+    itsLoaded = loaded;
+
+    // The manifest chooses the sprite set, the era line of the level file is only a fallback
+    if (info.era != Era::None)
     {
-        levelFileName = ":/level/assets/level/boss3.txt";
-        setItsLevelWidth(1280);
+        itsEra = info.era;
     }
-    else
+    if (mapped != nullptr)
     {
-        levelFileName = ":/level/assets/level/level1.txt";
+        compiledFile.unmap(mapped);
     }
 
-    QFile file(levelFileName);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        QTextStream in(&file);
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            QStringList parts = line.split(",");
-            QString type = parts[0];
-            if (type == "MainCharacter")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsMainCharacter = new MainCharacter(x, y, width, height);
-            }
-            else if (type == "Companion")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsCompanion = new Companion(x, y, width, height, itsMainCharacter);
-            }
-            else if (type == "Obstacle")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsObstacles->push_back(new Obstacle(x, y, width, height));
-            }
-            else if (type == "Enemy")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                int enemyType = parts[5].toInt();  // Assuming this indicates enemy type
-                itsEnemies->push_back(new ShortScope(x, y, width, height, enemyType));
-            }
-            else if (type == "Piece")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsPieces->push_back(new Piece(x, y, width, height));
-            }
-            else if (type == "Door")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsDoor = new Door(x, y, width, height);
-            }
-            else if (type == "FlashbackObject")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                QString nb = parts[5];
-                QString text = parts[6];
-                itsFlashbackObjects->push_back(new FlashbackObject(x, y, width, height, nb, text));
-            }
-            else if (type == "ClassicBoss")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsClassicBoss = new ClassicBoss(x, y, width, height);
-            }
-            else if (type == "FinalBoss")
-            {
-                int x = parts[1].toInt();
-                int y = parts[2].toInt();
-                int width = parts[3].toInt();
-                int height = parts[4].toInt();
-                itsFinalBoss = new FinalBoss(x, y, width, height);
-            }
-            else if (type == "ws" || type == "cs" || type == "nt")
-            {
-                itsEnemyType = type;
-            }
-            else
-            {
-                qDebug() << "Invalid type or incorrect format for line:" << line;
-            }
-        }
-        file.close();
-    }
-    else
+    if (withAudio && itsLoaded)
     {
-        qDebug() << "Failed to open file" << levelFileName;
+        startMusic();
     }
 
-    // Create a QMediaPlayer instance
-    player = new QMediaPlayer;
-    output = new QAudioOutput;
-
-    // Set audio source using URL
-    player->setSource(QUrl("qrc:/song/assets/audio/default_song.mp3"));
-
-    player->setAudioOutput(output);
-    output->setVolume(1);
-
-    player->setLoops(-1);
-
-    // Start playback
-    player->play();
+    // Index the static obstacles once, the movers only query the ones near them
+    itsObstacleGrid = new ObstacleGrid(*itsObstacles);
 
     itsFlashbackObjectNb = itsFlashbackObjects->size();
-    itsHUDNb = (itsNb + 1) / 2;
+    itsHUDNb = info.hudNb;
 }
 
 /**
  * @brief Destructor of the Level class.
  *
- * Frees dynamically allocated memory for various level elements.
+ * Frees the containers of the level, then releases the arena the entities live in.
  */
 Level::~Level()
 {
     delete output;
     delete player;
-    delete itsMainCharacter;
 
-    for (Obstacle* obstacle : *itsObstacles)
-    {
-        delete obstacle;
-    }
     delete itsObstacles;
+    delete itsObstacleGrid;
+    delete itsFlashbackObjects;
+    delete itsPieces;
+    delete itsEnemies;
 
-    for (auto it = itsFlashbackObjects->begin(); it != itsFlashbackObjects->end();)
+    // Every entity of the level goes at once, with the arena
+    itsArena.release();
+}
+
+/**
+ * @brief Creates the entities of a checked compiled level.
+ *
+ * @param aView View on the compiled level.
+ */
+void Level::buildEntities(const LevelFormat::View &aView)
+{
+    if (aView.header.era[0] != '\0')
     {
-        delete *it;
-        it = itsFlashbackObjects->erase(it);
+        itsEra = eraFromCode(QString::fromLatin1(aView.header.era, 2));
     }
-    delete itsFlashbackObjects;
 
-    for (Piece* piece : *itsPieces)
+    for (uint32_t index = 0; index < aView.header.recordNb; ++index)
     {
-        delete piece;
-    }
-    delete itsPieces;
+        LevelFormat::Record record = aView.record(index);
+        int x = record.x;
+        int y = record.y;
+        int width = record.width;
+        int height = record.height;
+
+        // Remember the size the level gives each kind of entity, the sprites are scaled to it
+        QString sizeKey = QString::fromStdString(LevelFormat::drawSizeKey(record));
+        if (!itsDrawSizes.contains(sizeKey))
+        {
+            itsDrawSizes[sizeKey] = QSize(width, height);
+        }
 
-    delete itsCompanion;
-    delete itsDoor;
-    delete itsClassicBoss;
-    delete itsFinalBoss;
+        switch (record.kind)
+        {
+        case LevelFormat::MainCharacter:
+            itsMainCharacter = itsArena.create<MainCharacter>(x, y, width, height);
+            break;
+        case LevelFormat::Companion:
+            itsCompanion = itsArena.create<Companion>(x, y, width, height, itsMainCharacter);
+            break;
+        case LevelFormat::Obstacle:
+            itsObstacles->push_back(itsArena.create<Obstacle>(x, y, width, height));
+            break;
+        case LevelFormat::Enemy:
+            itsEnemies->push_back(itsArena.create<ShortScope>(x, y, width, height, record.parameter));
+            break;
+        case LevelFormat::Piece:
+            itsPieces->push_back(itsArena.create<Piece>(x, y, width, height));
+            break;
+        case LevelFormat::Door:
+            itsDoor = itsArena.create<Door>(x, y, width, height);
+            break;
+        case LevelFormat::FlashbackObject:
+        {
+            QString text = QString::fromUtf8(aView.text + record.textOffset, record.textSize);
+            itsFlashbackObjects->push_back(itsArena.create<FlashbackObject>(x, y, width, height, record.parameter, text));
+            break;
+        }
+        case LevelFormat::ClassicBoss:
+            itsClassicBoss = itsArena.create<ClassicBoss>(x, y, width, height, &itsRandom);
+            break;
+        case LevelFormat::FinalBoss:
+            itsFinalBoss = itsArena.create<FinalBoss>(x, y, width, height);
+            break;
+        }
+    }
 }
 
 /**
@@ -221,6 +204,49 @@ std::list<Obstacle *> *Level::getItsObstacles() const
     return itsObstacles;
 }
 
+/**
+ * @brief Get the spatial index of the obstacles in the level.
+ *
+ * @return ObstacleGrid* Grid of the obstacles.
+ */
+ObstacleGrid *Level::getItsObstacleGrid() const
+{
+    return itsObstacleGrid;
+}
+
+/**
+ * @brief Get the arena the entities of the level are allocated from.
+ *
+ * @return LevelArena* Arena of the level.
+ */
+LevelArena *Level::getItsArena()
+{
+    return &itsArena;
+}
+
+/**
+ * @brief Get the generator of the gameplay random numbers.
+ *
+ * @return Prng* Generator of the level.
+ */
+Prng *Level::getItsRandom()
+{
+    return &itsRandom;
+}
+
+/**
+ * @brief Restart the generator of the level from the seed of the game.
+ *
+ * Each level derives its own sequence from the seed, so a level replays the same numbers
+ * whatever the levels played before it.
+ *
+ * @param aSeed Seed of the game.
+ */
+void Level::setSeed(quint64 aSeed)
+{
+    itsRandom.seed(Prng::deriveSeed(aSeed, static_cast<quint64>(itsNb)));
+}
+
 /**
  * @brief Get the list of pieces in the level.
  *
@@ -319,6 +345,8 @@ void Level::setItsEnemies(std::list<Character *> *enemies)
 void Level::setItsObstacles(std::list<Obstacle *> *obstacles)
 {
     itsObstacles = obstacles;
+    delete itsObstacleGrid;
+    itsObstacleGrid = new ObstacleGrid(*itsObstacles);
 }
 
 /**
@@ -401,6 +429,18 @@ Door *Level::getItsDoor() const
     return itsDoor;
 }
 
+/**
+ * @brief Checks whether the level was loaded.
+ *
+ * The checked level format guarantees one main character and one companion.
+ *
+ * @return True if the level has its entities.
+ */
+bool Level::isLoaded() const
+{
+    return itsLoaded;
+}
+
 /**
  * @brief Get the level number.
  *
@@ -412,23 +452,23 @@ int Level::getItsNb()
 }
 
 /**
- * @brief Set the enemy type for the level.
+ * @brief Set the era of the level.
  *
- * @param type Enemy type to set.
+ * @param anEra Era to set.
  */
-void Level::setItsEnemyType(QString type)
+void Level::setItsEra(Era anEra)
 {
-    itsEnemyType = type;
+    itsEra = anEra;
 }
 
 /**
- * @brief Get the enemy type for the level.
+ * @brief Get the era of the level.
  *
- * @return QString Enemy type.
+ * @return Era Era given by the level file, Era::None for the boss levels.
  */
-QString Level::getItsEnemyType()
+Era Level::getItsEra() const
 {
-    return itsEnemyType;
+    return itsEra;
 }
 
 /**
@@ -441,22 +481,77 @@ int Level::getItsHUDNb()
     return itsHUDNb;
 }
 
+/**
+ * @brief Get the size the level file gives a kind of entity.
+ *
+ * Enemies are looked up by type and enemy number, for example "Enemy2".
+ *
+ * @param aType Record type of the entity in the level file.
+ * @return QSize Size of the first entity of that kind, or an invalid size if there is none.
+ */
+QSize Level::getItsDrawSize(const QString &aType) const
+{
+    return itsDrawSizes.value(aType);
+}
+
+/**
+ * @brief Returns the size of the first entity of each kind in the level file.
+ * @return Draw sizes, by kind of entity.
+ */
+const QMap<QString, QSize> &Level::getItsDrawSizes() const
+{
+    return itsDrawSizes;
+}
+
 /**
  * @brief Get the QMediaPlayer instance used for level audio playback.
  *
- * @return QMediaPlayer* QMediaPlayer instance for audio playback.
+ * @return QMediaPlayer* QMediaPlayer instance for audio playback, nullptr if the level has no audio.
  */
 QMediaPlayer *Level::getPlayer()
 {
     return player;
 }
 
+/**
+ * @brief Creates the music player and starts the music of the level in a loop.
+ *
+ * Nothing is done if the player already exists or the manifest gives the level no music.
+ * The player is a QObject, so this must run on the GUI thread, even for a level built by a worker.
+ */
+void Level::startMusic()
+{
+    const QString &music = LevelManifest::instance().getLevel(itsNb).music;
+    if (player != nullptr || music.isEmpty())
+    {
+        return;
+    }
+
+    // Create a QMediaPlayer instance
+    player = new QMediaPlayer;
+    output = new QAudioOutput;
+
+    // Set audio source using URL
+    player->setSource(QUrl(music));
+
+    player->setAudioOutput(output);
+    output->setVolume(1);
+
+    player->setLoops(-1);
+
+    // Start playback
+    player->play();
+}
+
 /**
  * @brief Stop playing the level's song.
  */
 void Level::songMuted()
 {
-    player->stop();
+    if (player != nullptr)
+    {
+        player->stop();
+    }
 }
 
 /**
@@ -464,5 +559,8 @@ void Level::songMuted()
  */
 void Level::songStart()
 {
-    player->play();
+    if (player != nullptr)
+    {
+        player->play();
+    }
 }
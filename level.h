@@ -14,12 +14,19 @@
 #include "companion.h"
 #include "piece.h"
 #include <QString>
+#include <QMap>
+#include <QSize>
 #include <list>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <iostream>
 #include "door.h"
+#include "obstaclegrid.h"
+#include "spriteregistry.h"
+#include "levelarena.h"
+#include "levelformat.h"
+#include "prng.h"
 
 using namespace std;
 
@@ -34,34 +41,58 @@ class Level
     const QString itsLevelFile; /**< File path for level configuration. */
     const QString itsBackground; /**< Background image for the level. */
     const int itsNb; /**< Number identifier for the level. */
-    QString itsEnemyType;
+    bool itsLoaded = false; /**< True if the level file was read, the level then has its main character and companion. */
+    Era itsEra = Era::None; /**< Era of the level, it selects the sprites of the main character and enemies. */
     int itsFlashbackObjectNb = 0;
     list<Obstacle *> *itsObstacles; /**< List of obstacles in the level. */
+    ObstacleGrid *itsObstacleGrid = nullptr; /**< Spatial index of the obstacles, used by the movers. */
     list<Piece *> *itsPieces; /**< List of collectible pieces in the level. */
     list<FlashbackObject *> *itsFlashbackObjects; /**< List of flashback objects in the level. */
     list<Character *> *itsEnemies; /**< List of enemies in the level. */
     MainCharacter *itsMainCharacter; /**< Pointer to the main character of the level. */
-    Companion *itsCompanion; /**< Pointer to the companion character of the level. */
+    Companion *itsCompanion = nullptr; /**< Pointer to the companion character of the level. */
     Door* itsDoor;
-    QMediaPlayer *player;
-    QAudioOutput *output;
+    QMediaPlayer *player = nullptr; /**< Music player, null when the level has no audio. */
+    QAudioOutput *output = nullptr; /**< Audio output of the music player. */
     ClassicBoss *itsClassicBoss = nullptr;
     FinalBoss *itsFinalBoss = nullptr;
     int itsHUDNb;
+    QMap<QString, QSize> itsDrawSizes; /**< Size of the first entity of each kind in the level file. */
+    LevelArena itsArena; /**< Memory of every entity of the level, released with the level. */
+    Prng itsRandom; /**< Draws the random numbers of the gameplay, seeded from the seed of the game and the level number. */
+
+    /**
+     * @brief Creates the entities of a compiled level.
+     *
+     * @param aView Checked view on the compiled level
+     */
+    void buildEntities(const LevelFormat::View &aView);
 
 public:
     /**
      * @brief Constructor to initialize a level.
      *
      * @param aNumber Level number identifier.
+     * @param withAudio False to skip the music player, e.g. when running headless.
+     * @param aSeed Seed of the game, the generator of the level is seeded from it and from the level number.
      */
-    Level(int aNumber);
+    Level(int aNumber, bool withAudio = true, quint64 aSeed = 0);
 
     /**
      * @brief Destructor to clean up resources.
      */
     ~Level();
 
+    /**
+     * @brief Checks whether the level was loaded.
+     *
+     * A level missing from the manifest, or whose file is missing or invalid, has no entities
+     * and must not be played.
+     *
+     * @return True if the level has its main character and companion
+     */
+    bool isLoaded() const;
+
     /**
      * @brief Getter for the list of enemies in the level.
      *
@@ -76,6 +107,34 @@ public:
      */
     list<Obstacle *> *getItsObstacles() const;
 
+    /**
+     * @brief Getter for the spatial index of the obstacles in the level.
+     *
+     * @return Grid of the obstacles, to query the ones near a rectangle.
+     */
+    ObstacleGrid *getItsObstacleGrid() const;
+
+    /**
+     * @brief Getter for the arena the entities of the level are allocated from.
+     *
+     * @return Arena of the level, entities created in it must not be deleted.
+     */
+    LevelArena *getItsArena();
+
+    /**
+     * @brief Getter for the generator of the gameplay random numbers.
+     *
+     * @return Generator of the level, used by every entity that draws random numbers.
+     */
+    Prng *getItsRandom();
+
+    /**
+     * @brief Restarts the generator of the level from the seed of the game.
+     *
+     * @param aSeed Seed of the game, mixed with the level number.
+     */
+    void setSeed(quint64 aSeed);
+
     /**
      * @brief Getter for the list of collectible pieces in the level.
      *
@@ -134,6 +193,8 @@ public:
     /**
      * @brief Setter for the list of obstacles in the level.
      *
+     * Rebuilds the spatial index of the obstacles.
+     *
      * @param obstacles List of obstacles to set.
      */
     void setItsObstacles(list<Obstacle *> *obstacles);
@@ -179,15 +240,48 @@ public:
     void loadLevel();
     Door* getItsDoor() const;
     int getItsNb();
-    QString getItsEnemyType();
-    void setItsEnemyType(QString type);
+
+    /**
+     * @brief Getter for the era of the level.
+     *
+     * @return Era given by the level file, Era::None for the boss levels
+     */
+    Era getItsEra() const;
+
+    /**
+     * @brief Setter for the era of the level.
+     *
+     * @param anEra Era to set
+     */
+    void setItsEra(Era anEra);
+
     //void setSongVolume(int volume);
     void setItsLevelWidth(int width);
     void setItsBoss(ClassicBoss* boss);
     int getItsHUDNb();
 
+    /**
+     * @brief Getter for the size the level file gives a kind of entity.
+     *
+     * @param aType Record type, with the enemy number appended for enemies (e.g. "Enemy1")
+     * @return Size of that kind of entity, or an invalid size if the level has none
+     */
+    QSize getItsDrawSize(const QString &aType) const;
+
+    /**
+     * @brief Getter for the size of the first entity of each kind in the level file.
+     *
+     * @return Draw sizes, by record type as given to getItsDrawSize()
+     */
+    const QMap<QString, QSize> &getItsDrawSizes() const;
+
     QMediaPlayer *getPlayer();
 
+    /**
+     * @brief Creates the music player and starts the music of the level, on the GUI thread.
+     */
+    void startMusic();
+
     void songMuted();
 
     void songStart();
@@ -0,0 +1,124 @@
+/**
+ * @file levelarena.cpp
+ * @brief Implementation of the LevelArena class methods.
+ */
+
+#include "levelarena.h"
+#include <algorithm>
+
+atomic<long long> LevelArena::theLiveObjectNb(0);
+atomic<long long> LevelArena::theLiveBytes(0);
+
+/**
+ * @brief Constructor for LevelArena class.
+ * @param aChunkSize Size of a chunk, in bytes.
+ */
+LevelArena::LevelArena(size_t aChunkSize)
+    : itsChunkSize(aChunkSize)
+{}
+
+/**
+ * @brief Destructor for LevelArena class.
+ */
+LevelArena::~LevelArena()
+{
+    release();
+}
+
+/**
+ * @brief Reserves aligned memory for an object.
+ *
+ * The memory comes from the last chunk when it has room left, from a new chunk otherwise.
+ *
+ * @param aSize Size of the object, in bytes.
+ * @param anAlignment Alignment of the object, in bytes.
+ * @return Address of the memory.
+ */
+void *LevelArena::allocate(size_t aSize, size_t anAlignment)
+{
+    if (!itsChunks.empty())
+    {
+        Chunk &chunk = itsChunks.back();
+        size_t address = reinterpret_cast<size_t>(chunk.data.get()) + chunk.used;
+        size_t padding = (anAlignment - address % anAlignment) % anAlignment;
+        if (chunk.used + padding + aSize <= chunk.size)
+        {
+            chunk.used += padding + aSize;
+            itsBytesUsed += padding + aSize;
+            return reinterpret_cast<void *>(address + padding);
+        }
+    }
+
+    // The chunk memory is aligned for any fundamental type, the object goes at its start
+    size_t size = std::max(itsChunkSize, aSize);
+    itsChunks.push_back({unique_ptr<unsigned char[]>(new unsigned char[size]), size, aSize});
+    itsBytesReserved += size;
+    itsBytesUsed += aSize;
+    theLiveBytes += static_cast<long long>(size);
+    return itsChunks.back().data.get();
+}
+
+/**
+ * @brief Destroys every object, in reverse construction order, and frees the chunks.
+ */
+void LevelArena::release()
+{
+    for (auto it = itsDestructors.rbegin(); it != itsDestructors.rend(); ++it)
+    {
+        it->destroy(it->object);
+    }
+    itsDestructors.clear();
+
+    theLiveObjectNb -= itsObjectNb;
+    theLiveBytes -= static_cast<long long>(itsBytesReserved);
+
+    itsChunks.clear();
+    itsObjectNb = 0;
+    itsBytesUsed = 0;
+    itsBytesReserved = 0;
+}
+
+/**
+ * @brief Returns the number of objects constructed in the arena.
+ * @return Number of objects.
+ */
+int LevelArena::getItsObjectNb() const
+{
+    return itsObjectNb;
+}
+
+/**
+ * @brief Returns the bytes used by the objects of the arena.
+ * @return Number of bytes.
+ */
+size_t LevelArena::getItsBytesUsed() const
+{
+    return itsBytesUsed;
+}
+
+/**
+ * @brief Returns the bytes of all the chunks of the arena.
+ * @return Number of bytes.
+ */
+size_t LevelArena::getItsBytesReserved() const
+{
+    return itsBytesReserved;
+}
+
+/**
+ * @brief Returns the number of objects alive in every arena of the process.
+ * @return Number of objects.
+ */
+long long LevelArena::getLiveObjectNb()
+{
+    return theLiveObjectNb;
+}
+
+/**
+ * @brief Returns the bytes reserved by every arena of the process.
+ * @return Number of bytes.
+ */
+long long LevelArena::getLiveBytes()
+{
+    return theLiveBytes;
+}
@@ -0,0 +1,154 @@
+#ifndef LEVELARENA_H
+#define LEVELARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The LevelArena class allocates the entities of a level from a few large chunks.
+ *
+ * Objects are constructed in place, one after the other, in chunks owned by the arena.
+ * They are never freed one by one: the whole arena is released in one step when the
+ * level is destroyed, which runs the destructors in reverse order and frees the chunks.
+ * Process-wide counters give the number of live objects and bytes, so that a leak shows
+ * as a counter that keeps growing over level loads.
+ */
+class LevelArena
+{
+    /**
+     * @brief Block of memory the objects are constructed in.
+     */
+    struct Chunk
+    {
+        unique_ptr<unsigned char[]> data; /**< Memory of the chunk. */
+        size_t size; /**< Size of the chunk, in bytes. */
+        size_t used; /**< Bytes already handed out. */
+    };
+
+    /**
+     * @brief Object to destroy when the arena is released.
+     */
+    struct Destructor
+    {
+        void (*destroy)(void *); /**< Function calling the destructor of the object type. */
+        void *object; /**< Object to destroy. */
+    };
+
+    vector<Chunk> itsChunks; /**< Chunks, the last one receives the new objects. */
+    vector<Destructor> itsDestructors; /**< Objects with a destructor, in construction order. */
+    size_t itsChunkSize; /**< Size of a regular chunk, in bytes. */
+    int itsObjectNb = 0; /**< Number of objects constructed in the arena. */
+    size_t itsBytesUsed = 0; /**< Bytes used by the objects, padding included. */
+    size_t itsBytesReserved = 0; /**< Bytes of all the chunks. */
+
+    static atomic<long long> theLiveObjectNb; /**< Objects alive in every arena of the process. */
+    static atomic<long long> theLiveBytes; /**< Bytes reserved by every arena of the process. */
+
+    /**
+     * @brief Destroys an object of a given type.
+     *
+     * @param anObject Object to destroy
+     */
+    template <typename T>
+    static void destroy(void *anObject)
+    {
+        static_cast<T *>(anObject)->~T();
+    }
+
+    /**
+     * @brief Reserves aligned memory for an object.
+     *
+     * @param aSize Size of the object, in bytes
+     * @param anAlignment Alignment of the object, in bytes
+     * @return Address of the memory
+     */
+    void *allocate(size_t aSize, size_t anAlignment);
+
+public:
+    /**
+     * @brief Constructor to initialize an empty arena.
+     *
+     * @param aChunkSize Size of a chunk, in bytes, larger objects get a chunk of their own
+     */
+    explicit LevelArena(size_t aChunkSize = 16 * 1024);
+
+    /**
+     * @brief Destructor, releases every object of the arena.
+     */
+    ~LevelArena();
+
+    LevelArena(const LevelArena &) = delete;
+    LevelArena &operator=(const LevelArena &) = delete;
+
+    /**
+     * @brief Constructs an object in the arena.
+     *
+     * The object is owned by the arena and must not be deleted.
+     *
+     * @param someArguments Arguments of the constructor of T
+     * @return The new object
+     */
+    template <typename T, typename... Args>
+    T *create(Args &&...someArguments)
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Chunks are only aligned like operator new");
+        void *memory = allocate(sizeof(T), alignof(T));
+        T *object = new (memory) T(std::forward<Args>(someArguments)...);
+        if (!is_trivially_destructible<T>::value)
+        {
+            itsDestructors.push_back({&LevelArena::destroy<T>, object});
+        }
+        itsObjectNb++;
+        theLiveObjectNb++;
+        return object;
+    }
+
+    /**
+     * @brief Destroys every object, in reverse construction order, and frees the chunks.
+     */
+    void release();
+
+    /**
+     * @brief Returns the number of objects constructed in the arena.
+     *
+     * @return Number of objects
+     */
+    int getItsObjectNb() const;
+
+    /**
+     * @brief Returns the bytes used by the objects of the arena.
+     *
+     * @return Number of bytes
+     */
+    size_t getItsBytesUsed() const;
+
+    /**
+     * @brief Returns the bytes of all the chunks of the arena.
+     *
+     * @return Number of bytes
+     */
+    size_t getItsBytesReserved() const;
+
+    /**
+     * @brief Returns the number of objects alive in every arena of the process.
+     *
+     * @return Number of objects
+     */
+    static long long getLiveObjectNb();
+
+    /**
+     * @brief Returns the bytes reserved by every arena of the process.
+     *
+     * @return Number of bytes
+     */
+    static long long getLiveBytes();
+};
+
+#endif // LEVELARENA_H
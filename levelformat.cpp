@@ -0,0 +1,549 @@
+/**
+ * @file levelformat.cpp
+ * @brief Compilation and checking of the binary level format.
+ */
+
+#include "levelformat.h"
+#include <charconv>
+#include <cstring>
+
+namespace LevelFormat
+{
+
+namespace
+{
+
+/**
+ * @brief Number of fields of a text line, for each entity kind.
+ */
+const int FIELD_NB[EntityKindCount] = {5, 5, 5, 6, 5, 5, 7, 5, 5};
+
+/**
+ * @brief Cuts a line into its comma-separated fields, as views on the line.
+ */
+class Tokenizer
+{
+    std::string_view itsRest; ///< Part of the line not read yet.
+    bool itsAtEnd = false; ///< True once the last field was read.
+
+public:
+    explicit Tokenizer(std::string_view aLine) : itsRest(aLine) {}
+
+    /**
+     * @brief Reads the next field.
+     * @param aField Receives the field, an empty view at the end of the line.
+     * @return False if every field was already read.
+     */
+    bool next(std::string_view &aField)
+    {
+        if (itsAtEnd)
+        {
+            aField = itsRest.substr(itsRest.size());
+            return false;
+        }
+        size_t comma = itsRest.find(',');
+        aField = itsRest.substr(0, comma);
+        if (comma == std::string_view::npos)
+        {
+            itsAtEnd = true;
+            itsRest = itsRest.substr(itsRest.size());
+        }
+        else
+        {
+            itsRest = itsRest.substr(comma + 1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads the rest of the line as one field, commas included.
+     * @param aField Receives the field.
+     * @return False if every field was already read.
+     */
+    bool rest(std::string_view &aField)
+    {
+        aField = itsRest;
+        bool read = !itsAtEnd;
+        itsAtEnd = true;
+        itsRest = itsRest.substr(itsRest.size());
+        return read;
+    }
+};
+
+/**
+ * @brief Parses a whole field as a 32-bit integer.
+ * @param aField Field to parse.
+ * @param aValue Receives the value.
+ * @return True if the field is an integer in range.
+ */
+bool parseInt(std::string_view aField, int32_t &aValue)
+{
+    const char *end = aField.data() + aField.size();
+    std::from_chars_result result = std::from_chars(aField.data(), end, aValue);
+    return !aField.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+ * @brief Checks that a position or a size is within the bound of the format.
+ * @param aValue Value to check, wider than a record field so that sums can be checked.
+ * @return True if the value is within COORDINATE_LIMIT.
+ */
+bool inRange(int64_t aValue)
+{
+    return aValue >= -COORDINATE_LIMIT && aValue <= COORDINATE_LIMIT;
+}
+
+/**
+ * @brief Group of records defined once and placed several times.
+ */
+struct Prefab
+{
+    std::string_view name; ///< Name of the prefab, a view on the level text.
+    size_t first; ///< Index of the first record of the prefab in the prefab records.
+    size_t count; ///< Number of records of the prefab.
+    int line; ///< Line the prefab starts at.
+};
+
+}
+
+/**
+ * @brief Copies a record out of the file.
+ * @param anIndex Index of the record.
+ * @return The record.
+ */
+Record View::record(uint32_t anIndex) const
+{
+    Record record;
+    std::memcpy(&record, records + size_t(anIndex) * sizeof(Record), sizeof(Record));
+    return record;
+}
+
+/**
+ * @brief Returns the name of an entity kind.
+ * @param aKind Kind of entity.
+ * @return Name of the kind.
+ */
+const char *kindName(uint8_t aKind)
+{
+    static const char *const NAMES[EntityKindCount] = {"MainCharacter", "Companion", "Obstacle", "Enemy", "Piece",
+                                                       "Door", "FlashbackObject", "ClassicBoss", "FinalBoss"};
+    return aKind < EntityKindCount ? NAMES[aKind] : "";
+}
+
+/**
+ * @brief Returns the name under which the draw size of a record is remembered.
+ * @param aRecord Record of a compiled level.
+ * @return Name of the draw size.
+ */
+std::string drawSizeKey(const Record &aRecord)
+{
+    std::string key = kindName(aRecord.kind);
+    if (aRecord.kind == Enemy)
+    {
+        key += std::to_string(aRecord.parameter);
+    }
+    return key;
+}
+
+/**
+ * @brief Computes the FNV-1a hash of a block of memory.
+ * @param someData Memory to hash.
+ * @param aSize Size of the memory, in bytes.
+ * @return The hash.
+ */
+uint32_t checksum(const unsigned char *someData, size_t aSize)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t index = 0; index < aSize; ++index)
+    {
+        hash = (hash ^ someData[index]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compiles a text level into the binary format.
+ *
+ * The text is read in place, line by line, without copying any field. Empty lines and lines
+ * starting with '#' are skipped, any other line must be an era code, a known entity with the
+ * right number of integer fields, or a prefab directive:
+ *   Prefab,name     starts the definition of a prefab, the entities that follow belong to it
+ *   End             ends the definition of the prefab
+ *   Place,name,x,y  adds the entities of the prefab, moved by (x, y)
+ * The level must have exactly one MainCharacter, and one Companion placed after it.
+ *
+ * @param aText Content of the text level.
+ * @param aName Name of the level, used in the error messages.
+ * @param aBlob Receives the compiled level.
+ * @param anError Receives the error message.
+ * @return True if the text was compiled.
+ */
+bool compile(std::string_view aText, const std::string &aName, std::vector<unsigned char> &aBlob, std::string &anError)
+{
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+
+    // A record line is at least a dozen characters, which bounds the number of records
+    std::vector<Record> records;
+    records.reserve(aText.size() / 12 + 1);
+    std::string text;
+
+    std::vector<Prefab> prefabs;
+    std::vector<Record> prefabRecords;
+    bool inPrefab = false;
+
+    size_t lineStart = 0;
+    int lineNb = 0;
+    std::string_view line;
+
+    // Reports an error at the start of a field of the current line
+    auto fail = [&](std::string_view aField, const std::string &aMessage)
+    {
+        size_t column = size_t(aField.data() - line.data()) + 1;
+        anError = aName + ":" + std::to_string(lineNb) + ":" + std::to_string(column) + ": " + aMessage;
+        return false;
+    };
+
+    // The level is played by one main character, and the companion follows the one before it
+    int mainCharacterLine = 0;
+    int companionLine = 0;
+    auto addCharacter = [&](uint8_t aKind, std::string_view aField)
+    {
+        if (aKind == MainCharacter)
+        {
+            if (mainCharacterLine != 0)
+            {
+                return fail(aField, "second MainCharacter, the first one is at line " + std::to_string(mainCharacterLine));
+            }
+            mainCharacterLine = lineNb;
+        }
+        else if (aKind == Companion)
+        {
+            if (companionLine != 0)
+            {
+                return fail(aField, "second Companion, the first one is at line " + std::to_string(companionLine));
+            }
+            if (mainCharacterLine == 0)
+            {
+                return fail(aField, "Companion before the MainCharacter");
+            }
+            companionLine = lineNb;
+        }
+        return true;
+    };
+
+    while (lineStart < aText.size())
+    {
+        size_t lineEnd = aText.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos)
+        {
+            lineEnd = aText.size();
+        }
+        line = aText.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        lineNb++;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+
+        std::vector<Record> &target = inPrefab ? prefabRecords : records;
+        Tokenizer fields(line);
+        std::string_view type;
+        fields.next(type);
+        std::string_view field;
+
+        if (type == "ws" || type == "cs" || type == "nt")
+        {
+            if (fields.next(field))
+            {
+                return fail(field, "unexpected field after the era code");
+            }
+            if (inPrefab)
+            {
+                return fail(type, "era code inside a prefab");
+            }
+            header.era[0] = type[0];
+            header.era[1] = type[1];
+            continue;
+        }
+
+        if (type == "Prefab")
+        {
+            if (inPrefab)
+            {
+                return fail(type, "prefab inside a prefab, missing End");
+            }
+            std::string_view name;
+            if (!fields.next(name) || name.empty())
+            {
+                return fail(name, "Prefab needs a name");
+            }
+            for (const Prefab &prefab : prefabs)
+            {
+                if (prefab.name == name)
+                {
+                    return fail(name, "prefab \"" + std::string(name) + "\" already defined at line " + std::to_string(prefab.line));
+                }
+            }
+            if (fields.next(field))
+            {
+                return fail(field, "unexpected field after the prefab name");
+            }
+            prefabs.push_back({name, prefabRecords.size(), 0, lineNb});
+            inPrefab = true;
+            continue;
+        }
+
+        if (type == "End")
+        {
+            if (!inPrefab)
+            {
+                return fail(type, "End without Prefab");
+            }
+            prefabs.back().count = prefabRecords.size() - prefabs.back().first;
+            inPrefab = false;
+            continue;
+        }
+
+        if (type == "Place")
+        {
+            std::string_view name;
+            fields.next(name);
+            const Prefab *placed = nullptr;
+            for (const Prefab &prefab : prefabs)
+            {
+                if (prefab.name == name && !(inPrefab && &prefab == &prefabs.back()))
+                {
+                    placed = &prefab;
+                }
+            }
+            if (placed == nullptr)
+            {
+                return fail(name, "unknown prefab \"" + std::string(name) + "\"");
+            }
+
+            int32_t offset[2];
+            std::string_view offsetFields[2];
+            for (int axis = 0; axis < 2; ++axis)
+            {
+                if (!fields.next(offsetFields[axis]) || !parseInt(offsetFields[axis], offset[axis]))
+                {
+                    return fail(offsetFields[axis], "Place needs an integer offset: \"" + std::string(offsetFields[axis]) + "\"");
+                }
+            }
+            if (fields.next(field))
+            {
+                return fail(field, "unexpected field after the offset");
+            }
+
+            // The prefab records may move when a prefab is placed inside another one
+            size_t first = placed->first;
+            size_t count = placed->count;
+            for (size_t index = first; index < first + count; ++index)
+            {
+                // The offset comes from the text, the sums are checked before they are stored
+                Record record = prefabRecords[index];
+                int64_t placed[2] = {int64_t(record.x) + offset[0], int64_t(record.y) + offset[1]};
+                for (int axis = 0; axis < 2; ++axis)
+                {
+                    if (!inRange(placed[axis]))
+                    {
+                        return fail(offsetFields[axis], "placed entity out of range, coordinates are within +/-" + std::to_string(COORDINATE_LIMIT));
+                    }
+                }
+                record.x = int32_t(placed[0]);
+                record.y = int32_t(placed[1]);
+                if (!inPrefab && !addCharacter(record.kind, name))
+                {
+                    return false;
+                }
+                target.push_back(record);
+            }
+            continue;
+        }
+
+        uint8_t kind = 0;
+        while (kind < EntityKindCount && type != kindName(kind))
+        {
+            kind++;
+        }
+        if (kind == EntityKindCount)
+        {
+            return fail(type, "unknown entity \"" + std::string(type) + "\"");
+        }
+
+        // Every field but the name and the text of a flashback object is an integer
+        int32_t values[5] = {};
+        int intNb = FIELD_NB[kind] - (kind == FlashbackObject ? 2 : 1);
+        for (int index = 0; index < intNb; ++index)
+        {
+            if (!fields.next(field))
+            {
+                return fail(field, std::string(type) + " needs " + std::to_string(FIELD_NB[kind]) + " fields, found " + std::to_string(index + 1));
+            }
+            if (!parseInt(field, values[index]))
+            {
+                return fail(field, "not an integer: \"" + std::string(field) + "\"");
+            }
+            if (index < 2 && !inRange(values[index]))
+            {
+                return fail(field, "coordinate out of range, coordinates are within +/-" + std::to_string(COORDINATE_LIMIT));
+            }
+            if ((index == 2 || index == 3) && values[index] < 0)
+            {
+                return fail(field, "negative size");
+            }
+            if ((index == 2 || index == 3) && values[index] > COORDINATE_LIMIT)
+            {
+                return fail(field, "size out of range, sizes are at most " + std::to_string(COORDINATE_LIMIT));
+            }
+            if (index == 4 && (values[index] < 0 || values[index] > UINT16_MAX))
+            {
+                return fail(field, "parameter out of range");
+            }
+        }
+
+        Record record = {};
+        record.kind = kind;
+        record.parameter = uint16_t(values[4]);
+        record.x = values[0];
+        record.y = values[1];
+        record.width = values[2];
+        record.height = values[3];
+        if (kind == FlashbackObject)
+        {
+            if (!fields.rest(field))
+            {
+                return fail(field, "FlashbackObject needs a text");
+            }
+            record.textOffset = uint32_t(text.size());
+            record.textSize = uint32_t(field.size());
+            text += field;
+        }
+        else if (fields.next(field))
+        {
+            return fail(field, "unexpected field, " + std::string(type) + " has " + std::to_string(FIELD_NB[kind]) + " fields");
+        }
+        if (!inPrefab && !addCharacter(kind, type))
+        {
+            return false;
+        }
+        target.push_back(record);
+    }
+
+    if (inPrefab)
+    {
+        anError = aName + ":" + std::to_string(prefabs.back().line) + ":1: prefab \"" + std::string(prefabs.back().name) + "\" has no End";
+        return false;
+    }
+    if (mainCharacterLine == 0 || companionLine == 0)
+    {
+        anError = aName + ":" + std::to_string(lineNb + 1) + ":1: level has no " + (mainCharacterLine == 0 ? "MainCharacter" : "Companion");
+        return false;
+    }
+
+    header.recordNb = uint32_t(records.size());
+    header.textSize = uint32_t(text.size());
+
+    aBlob.assign(sizeof(Header) + records.size() * sizeof(Record) + text.size(), 0);
+    unsigned char *payload = aBlob.data() + sizeof(Header);
+    if (!records.empty())
+    {
+        std::memcpy(payload, records.data(), records.size() * sizeof(Record));
+    }
+    std::memcpy(payload + records.size() * sizeof(Record), text.data(), text.size());
+
+    header.checksum = checksum(payload, aBlob.size() - sizeof(Header));
+    std::memcpy(aBlob.data(), &header, sizeof(Header));
+    return true;
+}
+
+/**
+ * @brief Checks a compiled level and makes a view on it.
+ * @param someData Compiled level.
+ * @param aSize Size of the compiled level, in bytes.
+ * @param aView Receives the view.
+ * @param anError Receives the reason if the level is refused.
+ * @return True if the level is valid.
+ */
+bool open(const unsigned char *someData, size_t aSize, View &aView, std::string &anError)
+{
+    if (someData == nullptr || aSize < sizeof(Header))
+    {
+        anError = "file too short for a header";
+        return false;
+    }
+
+    Header &header = aView.header;
+    std::memcpy(&header, someData, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        anError = "not a compiled level";
+        return false;
+    }
+    if (header.version != VERSION || header.recordSize != sizeof(Record))
+    {
+        anError = "unsupported version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION);
+        return false;
+    }
+
+    uint64_t expectedSize = sizeof(Header) + uint64_t(header.recordNb) * sizeof(Record) + header.textSize;
+    if (expectedSize != aSize)
+    {
+        anError = "size is " + std::to_string(aSize) + " bytes, expected " + std::to_string(expectedSize);
+        return false;
+    }
+    if (checksum(someData + sizeof(Header), aSize - sizeof(Header)) != header.checksum)
+    {
+        anError = "checksum mismatch";
+        return false;
+    }
+
+    aView.records = someData + sizeof(Header);
+    aView.text = reinterpret_cast<const char *>(aView.records + size_t(header.recordNb) * sizeof(Record));
+
+    uint32_t mainCharacterNb = 0;
+    uint32_t companionNb = 0;
+    for (uint32_t index = 0; index < header.recordNb; ++index)
+    {
+        Record record = aView.record(index);
+        if (record.kind >= EntityKindCount || !inRange(record.x) || !inRange(record.y)
+            || record.width < 0 || record.width > COORDINATE_LIMIT || record.height < 0 || record.height > COORDINATE_LIMIT
+            || uint64_t(record.textOffset) + record.textSize > header.textSize)
+        {
+            anError = "invalid record " + std::to_string(index);
+            return false;
+        }
+
+        // The companion is built with the main character it follows
+        if (record.kind == MainCharacter)
+        {
+            mainCharacterNb++;
+        }
+        else if (record.kind == Companion)
+        {
+            if (mainCharacterNb == 0)
+            {
+                anError = "companion record " + std::to_string(index) + " before the main character";
+                return false;
+            }
+            companionNb++;
+        }
+    }
+    if (mainCharacterNb != 1 || companionNb != 1)
+    {
+        anError = std::to_string(mainCharacterNb) + " main characters and " + std::to_string(companionNb) + " companions, expected one of each";
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,155 @@
+#ifndef LEVELFORMAT_H
+#define LEVELFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file levelformat.h
+ * @brief Binary level format, shared by the game and the level compiler.
+ *
+ * A compiled level (.nlvl) is a header, followed by fixed-size entity records, followed by
+ * the UTF-8 texts of the flashback objects. Every field is little-endian. The checksum covers
+ * everything after the header, so that a truncated or damaged file is refused instead of loaded.
+ * This file only depends on the standard library, the level compiler does not link Qt.
+ */
+
+namespace LevelFormat
+{
+
+const char MAGIC[4] = {'N', 'L', 'V', 'L'}; ///< First bytes of every compiled level.
+const uint16_t VERSION = 1; ///< Version of the format, bumped on any layout change.
+const int32_t COORDINATE_LIMIT = 1 << 24; ///< Bound of the positions and sizes, so that adding them never overflows.
+
+/**
+ * @brief Kind of entity a record describes.
+ */
+enum EntityKind : uint8_t
+{
+    MainCharacter,
+    Companion,
+    Obstacle,
+    Enemy,
+    Piece,
+    Door,
+    FlashbackObject,
+    ClassicBoss,
+    FinalBoss,
+    EntityKindCount
+};
+
+/**
+ * @brief Header at the start of a compiled level.
+ */
+struct Header
+{
+    char magic[4]; ///< Always MAGIC.
+    uint16_t version; ///< Always VERSION.
+    uint16_t recordSize; ///< Size of a record, in bytes.
+    uint32_t recordNb; ///< Number of entity records.
+    uint32_t textSize; ///< Size of the text block, in bytes.
+    uint32_t checksum; ///< FNV-1a hash of the records and the text block.
+    char era[2]; ///< Era code of the level ("ws", "cs" or "nt"), zeros for a boss level.
+    uint16_t reserved; ///< Always zero.
+};
+
+/**
+ * @brief Entity of a compiled level.
+ */
+struct Record
+{
+    uint8_t kind; ///< EntityKind of the entity.
+    uint8_t reserved; ///< Always zero.
+    uint16_t parameter; ///< Type of an enemy, number of a flashback object, zero otherwise.
+    int32_t x; ///< Left of the entity.
+    int32_t y; ///< Top of the entity.
+    int32_t width; ///< Width of the entity.
+    int32_t height; ///< Height of the entity.
+    uint32_t textOffset; ///< Offset of the text of a flashback object in the text block.
+    uint32_t textSize; ///< Size of the text of a flashback object, in bytes.
+};
+
+static_assert(sizeof(Header) == 24, "The header layout is part of the file format");
+static_assert(sizeof(Record) == 28, "The record layout is part of the file format");
+
+/**
+ * @brief Read-only view on a compiled level, pointing into the caller's memory.
+ */
+struct View
+{
+    Header header; ///< Copy of the header.
+    const unsigned char *records = nullptr; ///< First record, not necessarily aligned.
+    const char *text = nullptr; ///< Text block.
+
+    /**
+     * @brief Copies a record out of the file, the records may not be aligned in memory.
+     *
+     * @param anIndex Index of the record, lower than header.recordNb
+     * @return The record
+     */
+    Record record(uint32_t anIndex) const;
+};
+
+/**
+ * @brief Returns the name of an entity kind, as written in the text levels.
+ *
+ * @param aKind Kind of entity
+ * @return Name of the kind, "" if it is out of range
+ */
+const char *kindName(uint8_t aKind);
+
+/**
+ * @brief Returns the name under which the draw size of a record is remembered.
+ *
+ * The enemies are told apart by their type, "Enemy1" or "Enemy2", the other records by their kind.
+ *
+ * @param aRecord Record of a compiled level
+ * @return Name of the draw size
+ */
+std::string drawSizeKey(const Record &aRecord);
+
+/**
+ * @brief Computes the FNV-1a hash of a block of memory.
+ *
+ * @param someData Memory to hash
+ * @param aSize Size of the memory, in bytes
+ * @return The hash
+ */
+uint32_t checksum(const unsigned char *someData, size_t aSize);
+
+/**
+ * @brief Compiles a text level into the binary format.
+ *
+ * Besides the entities and the era code, the text may define prefabs, groups of entities
+ * placed several times: "Prefab,name" ... "End", then "Place,name,x,y". The level must have
+ * exactly one MainCharacter, followed by one Companion. Positions, placed ones included, and
+ * sizes must be within COORDINATE_LIMIT.
+ *
+ * @param aText Content of the text level, read in place
+ * @param aName Name of the level, used in the error messages
+ * @param aBlob Receives the compiled level
+ * @param anError Receives "name:line:column: message" if the text is invalid
+ * @return True if the text was compiled
+ */
+bool compile(std::string_view aText, const std::string &aName, std::vector<unsigned char> &aBlob, std::string &anError);
+
+/**
+ * @brief Checks a compiled level and makes a view on it.
+ *
+ * Every record is checked, so that the level can be built from the view without further checks.
+ * A level without exactly one main character, followed by one companion, is refused.
+ *
+ * @param someData Compiled level
+ * @param aSize Size of the compiled level, in bytes
+ * @param aView Receives the view, valid as long as someData is
+ * @param anError Receives the reason if the level is refused
+ * @return True if the level is valid
+ */
+bool open(const unsigned char *someData, size_t aSize, View &aView, std::string &anError);
+
+}
+
+#endif // LEVELFORMAT_H
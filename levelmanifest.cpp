@@ -0,0 +1,158 @@
+/**
+ * @file levelmanifest.cpp
+ * @brief Implementation of the LevelManifest class methods.
+ */
+
+#include "levelmanifest.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+/**
+ * @brief Returns the manifest of the game, parsed on the first call.
+ * @return The manifest.
+ */
+const LevelManifest &LevelManifest::instance()
+{
+    static const LevelManifest manifest = []()
+    {
+        LevelManifest parsed;
+        parsed.load(":/level/assets/level/levels.json");
+        return parsed;
+    }();
+    return manifest;
+}
+
+/**
+ * @brief Parses a manifest.
+ *
+ * Unknown door names, boss styles and era codes are reported and ignored, the level keeps
+ * no door, the ghost boss or the previous sprite set.
+ *
+ * @param aPath Path of the JSON manifest.
+ */
+void LevelManifest::load(const QString &aPath)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qDebug() << "Failed to open level manifest" << aPath;
+        return;
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (document.isNull())
+    {
+        qDebug() << "Invalid level manifest" << aPath << "at offset" << error.offset << ":" << error.errorString();
+        return;
+    }
+
+    const struct
+    {
+        const char *name;
+        SpriteId sprite;
+    } doors[] = {{"door1", Door1}, {"door2", Door2}, {"door3", Door3}, {"portal1", Portal1}, {"portal2", Portal2}};
+
+    QJsonObject root = document.object();
+    itsPrefetchDistance = root.value("prefetchDistance").toInt(itsPrefetchDistance);
+    for (const QJsonValue &frame : root.value("loadingFrames").toArray())
+    {
+        itsLoadingFrames.append(frame.toString());
+    }
+
+    const QJsonArray levels = root.value("levels").toArray();
+    for (int number = 0; number < levels.size(); ++number)
+    {
+        QJsonObject entry = levels.at(number).toObject();
+        LevelInfo level;
+        level.file = entry.value("file").toString();
+        level.width = entry.value("width").toInt(level.width);
+        level.background = entry.value("background").toString();
+        level.music = entry.value("music").toString();
+        level.hudNb = entry.value("hud").toInt();
+
+        QString door = entry.value("door").toString();
+        for (const auto &known : doors)
+        {
+            if (door == QLatin1String(known.name))
+            {
+                level.door = known.sprite;
+            }
+        }
+        if (!door.isEmpty() && level.door == NoSprite)
+        {
+            qDebug() << "Level" << number << "of the manifest has an unknown door" << door;
+        }
+
+        QString boss = entry.value("boss").toString("ghost");
+        level.boss = boss == "knight" ? BossStyle::Knight : BossStyle::Ghost;
+        if (boss != "knight" && boss != "ghost")
+        {
+            qDebug() << "Level" << number << "of the manifest has an unknown boss" << boss;
+        }
+
+        QString era = entry.value("era").toString();
+        level.era = eraFromCode(era);
+        if (!era.isEmpty() && level.era == Era::None)
+        {
+            qDebug() << "Level" << number << "of the manifest has an unknown era" << era;
+        }
+
+        QJsonObject loading = entry.value("loading").toObject();
+        level.transition.firstFrame = loading.value("firstFrame").toInt();
+        level.transition.frameNb = loading.value("frameNb").toInt();
+        level.transition.duration = loading.value("duration").toInt();
+        if (level.transition.frameNb > 0 && level.transition.firstFrame + level.transition.frameNb > itsLoadingFrames.size())
+        {
+            qDebug() << "Level" << number << "of the manifest uses missing loading frames";
+            level.transition = LevelTransition();
+        }
+
+        if (level.file.isEmpty())
+        {
+            qDebug() << "Level" << number << "of the manifest has no file";
+        }
+        itsLevels.append(level);
+    }
+}
+
+/**
+ * @brief Returns the number of levels.
+ * @return Number of levels.
+ */
+int LevelManifest::getItsLevelNb() const
+{
+    return itsLevels.size();
+}
+
+/**
+ * @brief Returns the description of a level.
+ * @param aNumber Level number.
+ * @return The level, or an entry with an empty file if there is no such level.
+ */
+const LevelInfo &LevelManifest::getLevel(int aNumber) const
+{
+    static const LevelInfo noLevel;
+    return aNumber >= 0 && aNumber < itsLevels.size() ? itsLevels.at(aNumber) : noLevel;
+}
+
+/**
+ * @brief Returns the frames of the loading animations.
+ * @return Resource paths of the frames.
+ */
+const QStringList &LevelManifest::getItsLoadingFrames() const
+{
+    return itsLoadingFrames;
+}
+
+/**
+ * @brief Returns the distance to the door at which the next level is prefetched.
+ * @return Horizontal distance, in pixels.
+ */
+int LevelManifest::getItsPrefetchDistance() const
+{
+    return itsPrefetchDistance;
+}
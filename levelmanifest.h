@@ -0,0 +1,101 @@
+#ifndef LEVELMANIFEST_H
+#define LEVELMANIFEST_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "spriteregistry.h"
+
+/**
+ * @brief Loading animation played when leaving a level for the next one.
+ */
+struct LevelTransition
+{
+    int firstFrame = 0; ///< First frame of the animation in the loading frames.
+    int frameNb = 0; ///< Number of frames of the animation, 0 to go to the next level at once.
+    int duration = 0; ///< Minimum duration of the animation, in milliseconds, it also waits for the prefetch.
+};
+
+/**
+ * @brief Sprites of the classic boss of a level.
+ */
+enum class BossStyle
+{
+    Knight, ///< Mounted knight throwing swords.
+    Ghost ///< Flying ghost summoning little ghosts.
+};
+
+/**
+ * @brief Everything the game needs to know about a level besides its entities.
+ */
+struct LevelInfo
+{
+    QString file; ///< Resource path of the level, without the .nlvl or .txt extension.
+    int width = 1280; ///< Width of the level, in pixels.
+    QString background; ///< Resource path of the background image.
+    SpriteId door = NoSprite; ///< Sprite of the door, NoSprite if the level has none.
+    QString music; ///< URL of the music played in the level, empty for silence.
+    Era era = Era::None; ///< Sprite set of the main character and enemies, None to keep the previous one.
+    BossStyle boss = BossStyle::Ghost; ///< Sprites of the classic boss, if the level has one.
+    int hudNb = 0; ///< Level number shown in the HUD, also selects the flashback object sprites.
+    LevelTransition transition; ///< Animation played when leaving the level.
+};
+
+/**
+ * @brief The LevelManifest class lists the levels of the game and their assets.
+ *
+ * The manifest is a JSON resource parsed once, the first time it is needed. Levels are
+ * numbered by their position in it, so adding a level only means adding an entry.
+ */
+class LevelManifest
+{
+    QVector<LevelInfo> itsLevels; /**< Levels, by level number. */
+    QStringList itsLoadingFrames; /**< Resource paths of the frames of the loading animations. */
+    int itsPrefetchDistance = 1500; /**< Distance to the door, in pixels, at which the next level is prefetched. */
+
+    /**
+     * @brief Parses a manifest, errors are reported and the faulty entries skipped.
+     *
+     * @param aPath Path of the JSON manifest
+     */
+    void load(const QString &aPath);
+
+public:
+    /**
+     * @brief Returns the manifest of the game, parsed on the first call.
+     *
+     * @return The manifest
+     */
+    static const LevelManifest &instance();
+
+    /**
+     * @brief Returns the number of levels.
+     *
+     * @return Number of levels
+     */
+    int getItsLevelNb() const;
+
+    /**
+     * @brief Returns the description of a level.
+     *
+     * @param aNumber Level number
+     * @return The level, or an entry with an empty file if there is no such level
+     */
+    const LevelInfo &getLevel(int aNumber) const;
+
+    /**
+     * @brief Returns the frames of the loading animations.
+     *
+     * @return Resource paths of the frames
+     */
+    const QStringList &getItsLoadingFrames() const;
+
+    /**
+     * @brief Returns the distance to the door at which the next level is prefetched.
+     *
+     * @return Horizontal distance, in pixels
+     */
+    int getItsPrefetchDistance() const;
+};
+
+#endif // LEVELMANIFEST_H
@@ -0,0 +1,159 @@
+/**
+ * @file levelprefetcher.cpp
+ * @brief Implementation of the LevelPrefetcher class methods.
+ */
+
+#include "levelprefetcher.h"
+#include "backgroundcache.h"
+#include "levelmanifest.h"
+#include <QDebug>
+#include <QElapsedTimer>
+
+/**
+ * @brief Constructor for LevelPrefetcher class.
+ *
+ * One worker is enough, the prefetch has the whole approach to the door to run.
+ *
+ * @param anAssetManager Asset manager loading the sprites.
+ */
+LevelPrefetcher::LevelPrefetcher(const AssetManager *anAssetManager)
+    : itsAssetManager(anAssetManager)
+{
+    itsPool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief Destructor for LevelPrefetcher class.
+ */
+LevelPrefetcher::~LevelPrefetcher()
+{
+    cancel();
+}
+
+/**
+ * @brief Waits for the worker and drops its result.
+ */
+void LevelPrefetcher::cancel()
+{
+    itsCancelled = true;
+    itsPool.waitForDone();
+    delete itsLevel;
+    itsLevel = nullptr;
+    itsAssets = PreparedAssets();
+    itsLevelNb = -1;
+    itsReady = false;
+    itsCancelled = false;
+}
+
+/**
+ * @brief Starts building a level and preparing its assets.
+ * @param aLevelNb Number of the level to prefetch.
+ * @param aLoadedEra Era of the sprites the GUI holds.
+ * @param aDevicePixelRatio Device pixel ratio of the screen.
+ * @param aScreenHeight Height of the screen.
+ */
+void LevelPrefetcher::start(int aLevelNb, Era aLoadedEra, qreal aDevicePixelRatio, int aScreenHeight)
+{
+    cancel();
+    itsLevelNb = aLevelNb;
+    itsStepNb = 0;
+    itsStepTotal = 1;
+
+    itsPool.start([this, aLevelNb, aLoadedEra, aDevicePixelRatio, aScreenHeight]()
+    {
+        QElapsedTimer clock;
+        clock.start();
+
+        // The level is built without audio, the music player is a QObject of the GUI thread
+        Level *level = new Level(aLevelNb, false);
+        bool newEra = level->getItsEra() != Era::None && level->getItsEra() != aLoadedEra;
+        int spriteNb = newEra ? int(std::size(ERA_SPRITES[0]) + std::size(COMMON_SPRITES)) : 0;
+        itsStepTotal = 2 + spriteNb;
+        itsStepNb = 1;
+
+        PreparedAssets assets;
+        assets.backgroundPath = LevelManifest::instance().getLevel(aLevelNb).background;
+        if (!itsCancelled)
+        {
+            assets.background = BackgroundCache::prepare(assets.backgroundPath,
+                                                         QSize(level->getItsLevelWidth(), aScreenHeight), aDevicePixelRatio);
+        }
+        itsStepNb++;
+
+        if (newEra)
+        {
+            AssetManager::spriteRequests(level->getItsDrawSizes(), level->getItsEra(), assets.eraSprites, assets.commonSprites);
+            itsAssetManager->loadAll(assets.eraSprites, aDevicePixelRatio, &itsStepNb, &itsCancelled);
+            itsAssetManager->loadAll(assets.commonSprites, aDevicePixelRatio, &itsStepNb, &itsCancelled);
+            assets.era = level->getItsEra();
+        }
+
+        // The result is only read by the GUI thread once itsReady is set
+        itsLevel = level;
+        itsAssets = std::move(assets);
+        itsReady = true;
+        qDebug() << "Level" << aLevelNb << "prefetched in" << clock.elapsed() << "ms," << spriteNb << "sprites";
+    });
+}
+
+/**
+ * @brief Returns the level being prefetched.
+ * @return Level number, -1 if none.
+ */
+int LevelPrefetcher::getItsLevelNb() const
+{
+    return itsLevelNb;
+}
+
+/**
+ * @brief Returns whether the worker is done.
+ * @return True if take() will not wait.
+ */
+bool LevelPrefetcher::isReady() const
+{
+    return itsReady;
+}
+
+/**
+ * @brief Returns the progress of the prefetch.
+ * @return Fraction of the work done, from 0 to 1.
+ */
+qreal LevelPrefetcher::getProgress() const
+{
+    if (itsReady)
+    {
+        return 1.0;
+    }
+    return qreal(itsStepNb) / qreal(std::max(1, int(itsStepTotal)));
+}
+
+/**
+ * @brief Returns the assets prepared by the worker, without taking them.
+ * @return The assets, only meaningful once isReady() returns true.
+ */
+const PreparedAssets &LevelPrefetcher::getItsAssets() const
+{
+    return itsAssets;
+}
+
+/**
+ * @brief Takes the result of the prefetch, waiting for the worker if needed.
+ * @param aLevelNb Level expected.
+ * @param someAssets Receives the prepared assets.
+ * @return The level, owned by the caller, or nullptr if that level was not prefetched.
+ */
+Level *LevelPrefetcher::take(int aLevelNb, PreparedAssets &someAssets)
+{
+    if (itsLevelNb != aLevelNb)
+    {
+        cancel();
+        return nullptr;
+    }
+
+    itsPool.waitForDone();
+    Level *level = itsLevel;
+    someAssets = std::move(itsAssets);
+    itsLevel = nullptr;
+    cancel();
+    return level;
+}
@@ -0,0 +1,118 @@
+#ifndef LEVELPREFETCHER_H
+#define LEVELPREFETCHER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <iterator>
+#include "assetmanager.h"
+#include "level.h"
+#include "spriteregistry.h"
+
+/**
+ * @brief Assets of a level decoded and scaled ahead, ready to be committed to the GUI caches.
+ *
+ * Only QImage is used, so the assets can be prepared on a worker thread.
+ */
+struct PreparedAssets
+{
+    Era era = Era::None; /**< Era of the sprites prepared, None if the sprites were not prepared. */
+    QVector<SpriteRequest> eraSprites; /**< Sprites of the era of the level. */
+    QVector<SpriteRequest> commonSprites; /**< Sprites shared by every level, at the sizes of the level. */
+    QString backgroundPath; /**< Resource path of the background. */
+    QImage background; /**< Background scaled to the level size, null if not prepared. */
+};
+
+/**
+ * @brief The LevelPrefetcher class builds the next level and decodes its assets on a worker thread.
+ *
+ * The GUI starts the prefetch when the player gets close to the door. The worker builds the
+ * Level without audio, scales its background, and decodes the era sprites when the era changes.
+ * When the player goes through the door, the GUI takes the result and the game swaps its level
+ * pointer, the loading animation only waits for the part of the work not done yet.
+ */
+class LevelPrefetcher
+{
+    QThreadPool itsPool; /**< Single worker thread of the prefetcher. */
+    int itsLevelNb = -1; /**< Level being prefetched, -1 if none. */
+    Level *itsLevel = nullptr; /**< Level built by the worker, owned until taken. */
+    PreparedAssets itsAssets; /**< Assets prepared by the worker. */
+    std::atomic<int> itsStepNb{0}; /**< Steps done by the worker, the level counts as one step. */
+    std::atomic<int> itsStepTotal{1}; /**< Steps of the prefetch, known once the level is built. */
+    std::atomic<bool> itsReady{false}; /**< True once the worker is done. */
+    std::atomic<bool> itsCancelled{false}; /**< Asks the worker to stop between two steps. */
+    const AssetManager *itsAssetManager; /**< Loads the sprites, from its sprite pack when it has one. */
+
+    /**
+     * @brief Waits for the worker and drops its result.
+     */
+    void cancel();
+
+public:
+    /**
+     * @brief Constructor to initialize an idle prefetcher.
+     *
+     * @param anAssetManager Asset manager loading the sprites, only read by the worker
+     */
+    explicit LevelPrefetcher(const AssetManager *anAssetManager);
+
+    /**
+     * @brief Destructor, waits for the worker and frees a level not taken.
+     */
+    ~LevelPrefetcher();
+
+    LevelPrefetcher(const LevelPrefetcher &) = delete;
+    LevelPrefetcher &operator=(const LevelPrefetcher &) = delete;
+
+    /**
+     * @brief Starts building a level and preparing its assets, a previous prefetch is dropped.
+     *
+     * @param aLevelNb Number of the level to prefetch
+     * @param aLoadedEra Era of the sprites the GUI holds, the sprites are only prepared for another era
+     * @param aDevicePixelRatio Device pixel ratio of the screen
+     * @param aScreenHeight Height of the screen, the height of the background
+     */
+    void start(int aLevelNb, Era aLoadedEra, qreal aDevicePixelRatio, int aScreenHeight);
+
+    /**
+     * @brief Returns the level being prefetched.
+     *
+     * @return Level number, -1 if none
+     */
+    int getItsLevelNb() const;
+
+    /**
+     * @brief Returns whether the worker is done.
+     *
+     * @return True if take() will not wait
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Returns the progress of the prefetch.
+     *
+     * @return Fraction of the work done, from 0 to 1
+     */
+    qreal getProgress() const;
+
+    /**
+     * @brief Returns the assets prepared by the worker, without taking them.
+     *
+     * @return The assets, only meaningful once isReady() returns true
+     */
+    const PreparedAssets &getItsAssets() const;
+
+    /**
+     * @brief Takes the result of the prefetch, waiting for the worker if needed.
+     *
+     * @param aLevelNb Level expected, a prefetch of another level is dropped
+     * @param someAssets Receives the prepared assets
+     * @return The level, owned by the caller, or nullptr if that level was not prefetched
+     */
+    Level *take(int aLevelNb, PreparedAssets &someAssets);
+};
+
+#endif // LEVELPREFETCHER_H
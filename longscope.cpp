@@ -4,7 +4,7 @@ LongScope::LongScope(int aX, int aY, int aWidth, int aHeight): Character(aX, aY,
 {}
 
 
-void LongScope::updatePosition(list<Obstacle *>* obstacles)
+void LongScope::updatePosition(ObstacleGrid* obstacles)
 {
 
 }
@@ -11,7 +11,7 @@ class LongScope : public Character
     int itsRange;
 public:
     LongScope(int aX, int aY, int aWidth, int aHeight);
-    void updatePosition(list<Obstacle *>* obstacles);
+    void updatePosition(ObstacleGrid* obstacles);
     void attack();
     bool getPreviousDirection();
 };
@@ -1,6 +1,12 @@
 #include "gui.h"
 #include <QApplication>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QTextStream>
 #include "launchmenu.h"
+#include "headlessrunner.h"
 
 /**
  * @brief Function to restart music playback.
@@ -22,6 +28,12 @@ void restartMusic(QMediaPlayer *player)
  * @brief Main function of the program.
  *
  * Initializes the application and launches the game's startup menu.
+ * With --headless, runs the simulation without window instead (see HeadlessRunner).
+ * --renderer and --blitter select how the frames are drawn, by default on the render thread
+ * with the fastest blitter kernel. --bench-render times each way of drawing them instead of
+ * launching the game, --culling-report prints the sprites drawn and culled while it runs. --seed
+ * makes the gameplay random numbers reproducible, --record saves the inputs of the run into a
+ * replay and --replay plays one. --tick-rate sets the simulation rate.
  *
  * @param argc Number of arguments passed to the program.
  * @param argv Array of arguments passed to the program.
@@ -29,9 +41,115 @@ void restartMusic(QMediaPlayer *player)
  */
 int main(int argc, char *argv[])
 {
+    // The headless mode must not create a QApplication, which needs a display
+    if (HeadlessRunner::isRequested(argc, argv))
+    {
+        QCoreApplication app(argc, argv);
+        HeadlessRunner runner;
+        if (!runner.parseArguments(app.arguments()))
+        {
+            return 1;
+        }
+        return runner.run();
+    }
+
     QApplication a(argc, argv);
-    Game nova;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Nova: The Temporal Explorer");
+    parser.addHelpOption();
+    parser.addOption({"headless", "Run the simulation without window, audio nor GUI, see --headless --help."});
+    parser.addOption({"renderer", "Way the frames are drawn: threaded, software or raster.", "backend", "threaded"});
+    parser.addOption({"blitter", "Kernel of the software renderer: scalar, sse4.1 or avx2, the fastest by default.", "kernel"});
+    parser.addOption({"bench-render", "Draw N frames offscreen with each renderer, print the timings and quit.", "N"});
+    parser.addOption({"culling-report", "Print the number of sprites drawn and culled every 1000 frames."});
+    parser.addOption({"seed", "Seed of the gameplay random numbers, a random one by default.", "S"});
+    parser.addOption({"tick-rate", "Simulation ticks per second: 60, 100, 120 or 240.", "Hz", "100"});
+    parser.addOption({"record", "Record the inputs of the run into a replay file, written on exit.", "file"});
+    parser.addOption({"replay", "Play a replay file, its seed, level and tick rate replace the options.", "file"});
+    parser.process(a);
+
+    QTextStream err(stderr);
+    RenderBackend backend = RenderBackend::Threaded;
+    if (parser.value("renderer") == "software")
+    {
+        backend = RenderBackend::Software;
+    }
+    else if (parser.value("renderer") == "raster")
+    {
+        backend = RenderBackend::Raster;
+    }
+    else if (parser.value("renderer") != "threaded")
+    {
+        err << "Invalid renderer: " << parser.value("renderer") << Qt::endl;
+        return 1;
+    }
+    SpriteBlitter::Kernel kernel = SpriteBlitter::bestKernel();
+    if (parser.isSet("blitter")
+        && (!SpriteBlitter::kernelFromName(parser.value("blitter").toStdString(), kernel) || !SpriteBlitter::isSupported(kernel)))
+    {
+        err << "Blitter kernel not available: " << parser.value("blitter") << Qt::endl;
+        return 1;
+    }
+    bool frameNbOk = false;
+    int benchFrameNb = parser.value("bench-render").toInt(&frameNbOk);
+    if (parser.isSet("bench-render") && (!frameNbOk || benchFrameNb <= 0))
+    {
+        err << "Invalid number of frames: " << parser.value("bench-render") << Qt::endl;
+        return 1;
+    }
+
+    // Without seed the runs differ, the seed is printed so a run can be played again
+    quint64 seed = QRandomGenerator::global()->generate64();
+    if (parser.isSet("seed"))
+    {
+        bool seedOk = false;
+        seed = parser.value("seed").toULongLong(&seedOk);
+        if (!seedOk)
+        {
+            err << "Invalid seed: " << parser.value("seed") << Qt::endl;
+            return 1;
+        }
+    }
+    qDebug() << "Seed" << seed;
+    bool tickRateOk = false;
+    int tickRate = parser.value("tick-rate").toInt(&tickRateOk);
+    if (!tickRateOk || !FixedStepScheduler::isSupportedTickRate(tickRate))
+    {
+        err << "Invalid tick rate: " << parser.value("tick-rate") << Qt::endl;
+        return 1;
+    }
+
+    Game nova(nullptr, 0, false, seed);
+    if (!nova.getItsLevel()->isLoaded())
+    {
+        err << "The first level could not be loaded" << Qt::endl;
+        return 1;
+    }
+    nova.setTickRate(tickRate);
+    if (parser.isSet("replay"))
+    {
+        if (!nova.startReplay(parser.value("replay")))
+        {
+            err << "Invalid replay: " << parser.value("replay") << Qt::endl;
+            return 1;
+        }
+    }
+    else if (parser.isSet("record"))
+    {
+        if (!nova.startRecording(parser.value("record")))
+        {
+            err << "Cannot record: the first level could not be loaded again" << Qt::endl;
+            return 1;
+        }
+    }
     GUI myGUI(&nova);
+    myGUI.setItsRenderBackend(backend);
+    myGUI.setBlitterKernel(kernel);
+    myGUI.setCullingReport(parser.isSet("culling-report"));
+    if (parser.isSet("bench-render"))
+    {
+        return myGUI.benchmarkRender(benchFrameNb);
+    }
     LaunchMenu menu;
 
     // Connect startGameRequested signal from LaunchMenu to show GUI and close menu
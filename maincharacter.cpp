@@ -1,4 +1,5 @@
 #include "maincharacter.h"
+#include <cmath>
 
 /**
  * @brief Constructor for MainCharacter class.
@@ -25,59 +26,79 @@ MainCharacter::~MainCharacter(){}
 /**
  * @brief Updates the position of the main character based on its speed and obstacles.
  *
- * Checks for collisions with obstacles and adjusts position accordingly.
+ * The move is swept against the obstacles around it: the character stops at the first
+ * contact, loses the speed along the contact normal and slides with the rest of the move.
+ * Each sweep costs the same whatever the speed, and the number of slides is bounded.
  *
- * @param obstacles List of obstacles in the level.
+ * @param obstacles Grid of the obstacles in the level.
  */
-void MainCharacter::updatePosition(list<Obstacle *>* obstacles)
+void MainCharacter::updatePosition(ObstacleGrid* obstacles)
 {
     int speedFactor = 3;
     itsXSpeed = speedFactor * (itsRight - itsLeft);
 
-    itsYSpeed += 1;
+    // The speeds are tuned for 100 Hz, the gravity and the moves are scaled to the tick rate
+    itsYSpeed += scaleMove(1, itsGravityRemainder);
 
-    itsYSpeed = std::min(itsYSpeed, 10);
+    itsYSpeed = std::min(itsYSpeed, MAX_FALL_SPEED);
 
-    for (Obstacle* obstacle : *obstacles)
-    {
-        QRect fictiveCharacter = itsCharacter;
-        fictiveCharacter.translate(itsXSpeed, itsYSpeed);
+    int remainingX = scaleMove(itsXSpeed, itsXRemainder);
+    int remainingY = scaleMove(itsYSpeed, itsYRemainder);
+
+    // Only the obstacles around the move can stop it, with room for a jump impulse
+    int jumpReach = static_cast<int>(std::ceil(JUMP_IMPULSE * getStepScale()));
+    QRect reach = itsCharacter.united(itsCharacter.translated(remainingX, remainingY)).adjusted(-1, -jumpReach - 1, 1, 1);
+    const vector<Obstacle*>& candidates = obstacles->query(reach);
 
-        QRect intersection = fictiveCharacter.intersected(obstacle->getRect());
-        while (!intersection.isEmpty())
+    // A wall, a floor and a ceiling contact at most
+    for (int slide = 0; slide < MAX_SLIDES && (remainingX != 0 || remainingY != 0); ++slide)
+    {
+        SweepHit firstHit;
+        bool hasHit = false;
+        for (Obstacle* obstacle : candidates)
         {
-            if (std::abs(itsYSpeed / intersection.height()) >= std::abs(itsXSpeed / intersection.width()))
-            {
-                if (itsYSpeed > 0)
-                {
-                    if (itsJump)
-                    {
-                        itsYSpeed -= 17;
-                    }
-                    else
-                    {
-                        itsYSpeed -= intersection.height();
-                    }
-                }
-                else if (itsYSpeed < 0)
-                    itsYSpeed += intersection.height();
-            }
-            else
+            SweepHit hit;
+            if (sweepRect(itsCharacter, remainingX, remainingY, obstacle->getRect(), hit)
+                && (!hasHit || hit.itsTime < firstHit.itsTime))
             {
-                if (itsXSpeed > 0)
-                    itsXSpeed -= intersection.width();
-                else if (itsXSpeed < 0)
-                    itsXSpeed += intersection.width();
+                firstHit = hit;
+                hasHit = true;
             }
+        }
+
+        if (!hasHit)
+        {
+            itsCharacter.translate(remainingX, remainingY);
+            return;
+        }
 
-            fictiveCharacter = itsCharacter;
-            fictiveCharacter.translate(itsXSpeed, itsYSpeed);
+        // Exact move along the normal, rounded towards the start along the tangent
+        int stepX = firstHit.itsNormalX != 0 ? firstHit.itsDistance : static_cast<int>(remainingX * firstHit.itsTime);
+        int stepY = firstHit.itsNormalY != 0 ? firstHit.itsDistance : static_cast<int>(remainingY * firstHit.itsTime);
+        itsCharacter.translate(stepX, stepY);
+        remainingX -= stepX;
+        remainingY -= stepY;
 
-            intersection = fictiveCharacter.intersected(obstacle->getRect());
+        if (firstHit.itsNormalX != 0)
+        {
+            itsXSpeed = 0;
+            itsXRemainder = 0;
+            remainingX = 0;
+        }
+        else if (firstHit.itsNormalY < 0 && itsJump)
+        {
+            // Landing with the jump key held bounces straight away
+            itsYSpeed -= JUMP_IMPULSE;
+            itsYRemainder = 0;
+            remainingY = scaleMove(itsYSpeed, itsYRemainder);
+        }
+        else
+        {
+            itsYSpeed = 0;
+            itsYRemainder = 0;
+            remainingY = 0;
         }
     }
-
-    itsCharacter.translate(itsXSpeed, itsYSpeed);
 }
 
 /**
@@ -209,23 +230,25 @@ int MainCharacter::getItsPieceNb()
  * @brief Sets the invulnerability state of the character.
  *
  * @param state True to set invulnerable, false otherwise.
+ * @param aNowMs Current time on the game clock, in milliseconds.
  */
-void MainCharacter::setInvulnerable(bool state)
+void MainCharacter::setInvulnerable(bool state, qint64 aNowMs)
 {
     itsInvulnerable = state;
-    lastHitTime = QDateTime::currentDateTime();
+    lastHitTime = aNowMs;
 }
 
 /**
  * @brief Checks if the character is currently invulnerable and updates its state if necessary.
  *
+ * @param aNowMs Current time on the game clock, in milliseconds.
  * @return bool True if invulnerable, false otherwise.
  */
-bool MainCharacter::checkInvulnerability()
+bool MainCharacter::checkInvulnerability(qint64 aNowMs)
 {
     if (itsInvulnerable)
     {
-        qint64 msSinceLastHit = lastHitTime.msecsTo(QDateTime::currentDateTime());
+        qint64 msSinceLastHit = aNowMs - lastHitTime;
         if (msSinceLastHit > 1000)
         {
             itsInvulnerable = false;
@@ -237,9 +260,9 @@ bool MainCharacter::checkInvulnerability()
 /**
  * @brief Sets the time of the last hit received by the character.
  *
- * @param time QDateTime representing the time of the last hit.
+ * @param time Time of the last hit on the game clock, in milliseconds.
  */
-void MainCharacter::setLastHitTime(const QDateTime& time)
+void MainCharacter::setLastHitTime(qint64 time)
 {
     lastHitTime = time;
 }
@@ -247,20 +270,22 @@ void MainCharacter::setLastHitTime(const QDateTime& time)
 /**
  * @brief Getter for the time of the last hit received by the character.
  *
- * @return const QDateTime& QDateTime object representing the time of the last hit.
+ * @return qint64 Time of the last hit on the game clock, in milliseconds.
  */
-const QDateTime& MainCharacter::getLastHitTime() const
+qint64 MainCharacter::getLastHitTime() const
 {
     return lastHitTime;
 }
 
 /**
  * @brief Starts the collision detection process.
+ *
+ * @param aNowMs Current time on the game clock, in milliseconds.
  */
-void MainCharacter::startCollision()
+void MainCharacter::startCollision(qint64 aNowMs)
 {
     if (!isCollisionActive) {
-        collisionStartTime = QDateTime::currentDateTime();
+        collisionStartTime = aNowMs;
         isCollisionActive = true;
     }
 }
@@ -276,11 +301,12 @@ void MainCharacter::endCollision()
 /**
  * @brief Checks if the collision duration has reached its limit.
  *
+ * @param aNowMs Current time on the game clock, in milliseconds.
  * @return bool True if collision duration limit exceeded, false otherwise.
  */
-bool MainCharacter::checkCollisionDuration()
+bool MainCharacter::checkCollisionDuration(qint64 aNowMs)
 {
-    if (isCollisionActive && collisionStartTime.msecsTo(QDateTime::currentDateTime()) >= 400)
+    if (isCollisionActive && aNowMs - collisionStartTime >= 400)
     {
         endCollision();
         return true;
@@ -2,7 +2,7 @@
 #define MAINCHARACTER_H
 
 #include "character.h"
-#include <QDateTime>
+#include "sweptaabb.h"
 #include <list>
 
 /**
@@ -20,8 +20,13 @@ class MainCharacter : public Character
     bool itsPreviousDirection = false;
     int itsFlashBackObjectNb = 0; /**< Number of flashback objects collected by the main character. */
     bool itsInvulnerable = false; /**< Flag indicating whether the main character is invulnerable. */
-    QDateTime lastHitTime; /**< Timestamp of the last hit taken by the main character. */
-    QDateTime collisionStartTime; /**< Timestamp when the collision starts. */
+    qint64 lastHitTime = 0; /**< Time of the last hit taken by the main character, on the game clock, in milliseconds. */
+    qint64 collisionStartTime = 0; /**< Time the collision started, on the game clock, in milliseconds. */
+    double itsGravityRemainder = 0; /**< Fraction of the gravity not yet added to the falling speed. */
+
+    static constexpr int MAX_FALL_SPEED = 10; /**< Terminal falling speed, in pixels per tick at 100 Hz. */
+    static constexpr int JUMP_IMPULSE = 17; /**< Upward speed given by a jump, in pixels per tick at 100 Hz. */
+    static constexpr int MAX_SLIDES = 3; /**< Number of contacts resolved in one tick. */
 
 public:
     /**
@@ -42,9 +47,9 @@ public:
     /**
      * @brief Updates the position of the MainCharacter.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
      */
-    void updatePosition(list<Obstacle *>* obstacles);
+    void updatePosition(ObstacleGrid* obstacles);
 
     /**
      * @brief Enables or disables the movement of the MainCharacter to the right.
@@ -118,34 +123,38 @@ public:
      * @brief Sets the invulnerability state of the MainCharacter.
      *
      * @param state True to set as invulnerable, false otherwise
+     * @param aNowMs Current time on the game clock, in milliseconds
      */
-    void setInvulnerable(bool state);
+    void setInvulnerable(bool state, qint64 aNowMs);
 
     /**
      * @brief Checks if the MainCharacter is currently invulnerable.
      *
+     * @param aNowMs Current time on the game clock, in milliseconds
      * @return True if invulnerable, false otherwise
      */
-    bool checkInvulnerability();
+    bool checkInvulnerability(qint64 aNowMs);
 
     /**
-     * @brief Getter for the timestamp of the last hit taken by the MainCharacter.
+     * @brief Getter for the time of the last hit taken by the MainCharacter.
      *
-     * @return Timestamp of the last hit
+     * @return Time of the last hit on the game clock, in milliseconds
      */
-    const QDateTime& getLastHitTime() const;
+    qint64 getLastHitTime() const;
 
     /**
-     * @brief Sets the timestamp of the last hit taken by the MainCharacter.
+     * @brief Sets the time of the last hit taken by the MainCharacter.
      *
-     * @param time Timestamp of the last hit
+     * @param time Time of the last hit on the game clock, in milliseconds
      */
-    void setLastHitTime(const QDateTime& time);
+    void setLastHitTime(qint64 time);
 
     /**
      * @brief Marks the start of a collision with an obstacle or enemy.
+     *
+     * @param aNowMs Current time on the game clock, in milliseconds
      */
-    void startCollision();
+    void startCollision(qint64 aNowMs);
 
     /**
      * @brief Marks the end of a collision with an obstacle or enemy.
@@ -155,11 +164,12 @@ public:
     /**
      * @brief Checks if the duration of collision is within the specified limit.
      *
+     * @param aNowMs Current time on the game clock, in milliseconds
      * @return True if collision duration is within limit, false otherwise
      */
-    bool checkCollisionDuration();
+    bool checkCollisionDuration(qint64 aNowMs);
 
-    bool isCollisionActive; /**< Flag indicating whether collision is currently active. */
+    bool isCollisionActive = false; /**< Flag indicating whether collision is currently active. */
 
     void addFlashbackObject();
 };
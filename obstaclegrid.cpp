@@ -0,0 +1,112 @@
+/**
+ * @file obstaclegrid.cpp
+ * @brief Implementation of the ObstacleGrid class methods.
+ */
+
+#include "obstaclegrid.h"
+#include <algorithm>
+
+/**
+ * @brief Constructor for ObstacleGrid class.
+ *
+ * Computes the bounds of the obstacles, then registers each obstacle in every cell it overlaps.
+ *
+ * @param obstacles Obstacles of the level.
+ * @param aCellSize Width and height of a cell, in pixels.
+ */
+ObstacleGrid::ObstacleGrid(const list<Obstacle *> &obstacles, int aCellSize)
+    : itsCellSize(aCellSize), itsObstacles(obstacles.begin(), obstacles.end())
+{
+    for (Obstacle* obstacle : itsObstacles)
+    {
+        itsBounds = itsBounds.united(obstacle->getRect());
+    }
+
+    if (itsBounds.isEmpty())
+    {
+        return;
+    }
+
+    itsColumns = (itsBounds.width() + itsCellSize - 1) / itsCellSize;
+    itsRows = (itsBounds.height() + itsCellSize - 1) / itsCellSize;
+    itsCells.resize(itsColumns * itsRows);
+    itsVisitStamps.assign(itsObstacles.size(), 0);
+
+    for (int index = 0; index < static_cast<int>(itsObstacles.size()); ++index)
+    {
+        QRect rect = itsObstacles[index]->getRect();
+        int firstColumn = (rect.left() - itsBounds.left()) / itsCellSize;
+        int lastColumn = (rect.right() - itsBounds.left()) / itsCellSize;
+        int firstRow = (rect.top() - itsBounds.top()) / itsCellSize;
+        int lastRow = (rect.bottom() - itsBounds.top()) / itsCellSize;
+
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+            {
+                itsCells[row * itsColumns + column].push_back(index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the obstacles that may intersect a rectangle.
+ * @param aRect Rectangle to test, in level coordinates.
+ * @return Obstacles whose cells overlap the rectangle, in the order of the level file.
+ */
+const vector<Obstacle *> &ObstacleGrid::query(const QRect &aRect) const
+{
+    itsResult.clear();
+    itsFoundIndices.clear();
+
+    QRect area = aRect.intersected(itsBounds);
+    if (area.isEmpty())
+    {
+        return itsResult;
+    }
+
+    // A new stamp marks the obstacles already found by this query
+    itsQueryStamp++;
+    if (itsQueryStamp == 0)
+    {
+        std::fill(itsVisitStamps.begin(), itsVisitStamps.end(), 0);
+        itsQueryStamp = 1;
+    }
+
+    int firstColumn = (area.left() - itsBounds.left()) / itsCellSize;
+    int lastColumn = (area.right() - itsBounds.left()) / itsCellSize;
+    int firstRow = (area.top() - itsBounds.top()) / itsCellSize;
+    int lastRow = (area.bottom() - itsBounds.top()) / itsCellSize;
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = firstColumn; column <= lastColumn; ++column)
+        {
+            for (int index : itsCells[row * itsColumns + column])
+            {
+                if (itsVisitStamps[index] != itsQueryStamp)
+                {
+                    itsVisitStamps[index] = itsQueryStamp;
+                    itsFoundIndices.push_back(index);
+                }
+            }
+        }
+    }
+
+    std::sort(itsFoundIndices.begin(), itsFoundIndices.end());
+    for (int index : itsFoundIndices)
+    {
+        itsResult.push_back(itsObstacles[index]);
+    }
+    return itsResult;
+}
+
+/**
+ * @brief Returns the number of obstacles in the grid.
+ * @return Number of obstacles.
+ */
+int ObstacleGrid::getItsObstacleNb() const
+{
+    return static_cast<int>(itsObstacles.size());
+}
@@ -0,0 +1,59 @@
+#ifndef OBSTACLEGRID_H
+#define OBSTACLEGRID_H
+
+#include "obstacle.h"
+#include <list>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The ObstacleGrid class is a uniform grid index over the static obstacles of a level.
+ *
+ * The level is cut into square cells and each cell lists the obstacles overlapping it.
+ * A rectangle query then only visits the cells the rectangle covers, so the cost of
+ * a collision test does not grow with the size of the level.
+ */
+class ObstacleGrid
+{
+    QRect itsBounds; /**< Rectangle covering every obstacle. */
+    int itsCellSize; /**< Width and height of a cell, in pixels. */
+    int itsColumns = 0; /**< Number of cells along X. */
+    int itsRows = 0; /**< Number of cells along Y. */
+    vector<Obstacle *> itsObstacles; /**< Obstacles, in the order of the level file. */
+    vector<vector<int>> itsCells; /**< Indices of the obstacles overlapping each cell. */
+    mutable vector<unsigned int> itsVisitStamps; /**< Last query each obstacle was returned by. */
+    mutable unsigned int itsQueryStamp = 0; /**< Number of the current query. */
+    mutable vector<int> itsFoundIndices; /**< Scratch buffer of the current query. */
+    mutable vector<Obstacle *> itsResult; /**< Result of the last query. */
+
+public:
+    /**
+     * @brief Constructor to build the grid over a list of obstacles.
+     *
+     * @param obstacles Obstacles of the level, they must not move afterwards
+     * @param aCellSize Width and height of a cell, in pixels
+     */
+    ObstacleGrid(const list<Obstacle *> &obstacles, int aCellSize = 256);
+
+    /**
+     * @brief Returns the obstacles that may intersect a rectangle.
+     *
+     * The obstacles are returned once each, in the order of the level file, so that
+     * collision resolution gives the same result as a walk over the whole list.
+     * The returned vector is reused by the next query.
+     *
+     * @param aRect Rectangle to test, in level coordinates
+     * @return Obstacles whose cells overlap the rectangle
+     */
+    const vector<Obstacle *> &query(const QRect &aRect) const;
+
+    /**
+     * @brief Returns the number of obstacles in the grid.
+     *
+     * @return Number of obstacles
+     */
+    int getItsObstacleNb() const;
+};
+
+#endif // OBSTACLEGRID_H
@@ -0,0 +1,114 @@
+/**
+ * @file prng.cpp
+ * @brief Implementation of the Prng class methods.
+ */
+
+#include "prng.h"
+
+namespace
+{
+const std::uint64_t MULTIPLIER = 6364136223846793005ULL; ///< Multiplier of the PCG32 reference implementation
+const std::uint64_t INCREMENT = 1442695040888963407ULL; ///< Increment of the PCG32 reference implementation, odd
+}
+
+/**
+ * @brief Constructor of the Prng class.
+ * @param aSeed Seed of the sequence.
+ */
+Prng::Prng(std::uint64_t aSeed)
+{
+    seed(aSeed);
+}
+
+/**
+ * @brief Restarts the sequence from a seed.
+ *
+ * The seed is added between two steps, as in the reference implementation, so close seeds
+ * still start far apart.
+ *
+ * @param aSeed Seed of the sequence.
+ */
+void Prng::seed(std::uint64_t aSeed)
+{
+    itsSeed = aSeed;
+    itsState = 0;
+    next();
+    itsState += aSeed;
+    next();
+}
+
+/**
+ * @brief Draws the next number of the sequence.
+ *
+ * Advances the linear congruential state, then outputs its high bits shifted by a xorshift and
+ * rotated by an amount taken from the top bits (PCG XSH RR).
+ *
+ * @return Number uniformly distributed over the 32-bit range.
+ */
+std::uint32_t Prng::next()
+{
+    std::uint64_t state = itsState;
+    itsState = state * MULTIPLIER + INCREMENT;
+    std::uint32_t xorShifted = static_cast<std::uint32_t>(((state >> 18) ^ state) >> 27);
+    std::uint32_t rotation = static_cast<std::uint32_t>(state >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+/**
+ * @brief Draws a number between two bounds.
+ *
+ * The 32-bit number is multiplied by the size of the range and the high half is kept; the few
+ * products that would favor some numbers are drawn again (Lemire's method).
+ *
+ * @param aMin Smallest number drawn.
+ * @param aMax Largest number drawn, not smaller than aMin.
+ * @return Number between aMin and aMax, both included.
+ */
+int Prng::bounded(int aMin, int aMax)
+{
+    std::uint32_t range = static_cast<std::uint32_t>(static_cast<std::int64_t>(aMax) - aMin + 1);
+    if (range == 0)
+    {
+        // The range covers every 32-bit number
+        return static_cast<int>(next());
+    }
+
+    std::uint64_t product = static_cast<std::uint64_t>(next()) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if (low < range)
+    {
+        std::uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            product = static_cast<std::uint64_t>(next()) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<int>(aMin + static_cast<std::int64_t>(product >> 32));
+}
+
+/**
+ * @brief Getter for the seed.
+ * @return Seed given to the constructor or to seed().
+ */
+std::uint64_t Prng::getItsSeed() const
+{
+    return itsSeed;
+}
+
+/**
+ * @brief Mixes a seed with a number.
+ *
+ * Uses the SplitMix64 finalizer, so consecutive numbers give unrelated seeds.
+ *
+ * @param aSeed Seed to derive from.
+ * @param aNumber Number of the derived seed.
+ * @return Derived seed.
+ */
+std::uint64_t Prng::deriveSeed(std::uint64_t aSeed, std::uint64_t aNumber)
+{
+    std::uint64_t mixed = aSeed + (aNumber + 1) * 0x9E3779B97F4A7C15ULL;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+    return mixed ^ (mixed >> 31);
+}
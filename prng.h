@@ -0,0 +1,66 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <cstdint>
+
+/**
+ * @file prng.h
+ * @brief Seeded pseudo-random generator for the gameplay.
+ *
+ * A PCG32 generator: 64 bits of state, one multiplication and one rotation per 32-bit number, so
+ * drawing a number costs a few nanoseconds and never calls the system. The same seed always gives
+ * the same sequence on every platform, which makes the runs reproducible for benchmarks and
+ * replays. This file only depends on the standard library.
+ */
+
+/**
+ * @brief The Prng class draws the random numbers of the gameplay.
+ */
+class Prng
+{
+    std::uint64_t itsState = 0; /**< State of the generator. */
+    std::uint64_t itsSeed = 0; /**< Seed the state was derived from. */
+
+public:
+    /**
+     * @brief Constructor to initialize the generator.
+     * @param aSeed Seed of the sequence.
+     */
+    explicit Prng(std::uint64_t aSeed = 0);
+
+    /**
+     * @brief Restarts the sequence from a seed.
+     * @param aSeed Seed of the sequence.
+     */
+    void seed(std::uint64_t aSeed);
+
+    /**
+     * @brief Draws the next number of the sequence.
+     * @return Number uniformly distributed over the 32-bit range.
+     */
+    std::uint32_t next();
+
+    /**
+     * @brief Draws a number between two bounds, without the bias of a modulo.
+     * @param aMin Smallest number drawn.
+     * @param aMax Largest number drawn, not smaller than aMin.
+     * @return Number uniformly distributed between aMin and aMax, both included.
+     */
+    int bounded(int aMin, int aMax);
+
+    /**
+     * @brief Getter for the seed.
+     * @return Seed given to the constructor or to seed().
+     */
+    std::uint64_t getItsSeed() const;
+
+    /**
+     * @brief Mixes a seed with a number, to derive independent seeds from one seed.
+     * @param aSeed Seed to derive from.
+     * @param aNumber Number of the derived seed, e.g. a level number.
+     * @return Derived seed.
+     */
+    static std::uint64_t deriveSeed(std::uint64_t aSeed, std::uint64_t aNumber);
+};
+
+#endif // PRNG_H
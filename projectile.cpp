@@ -5,7 +5,7 @@ Projectile::Projectile(int aX, int aY, int aWidth, int aHeight)
 
 }
 
-void Projectile::updatePosition(list<Obstacle *>* obstacles)
+void Projectile::updatePosition(ObstacleGrid* obstacles)
 {
 
 }
@@ -2,6 +2,7 @@
 #define PROJECTILE_H
 
 #include "obstacle.h"
+#include "obstaclegrid.h"
 #include <list>
 #include <QRect>
 
@@ -28,9 +29,9 @@ public:
     /**
      * @brief Updates the position of the projectile.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
      */
-    void updatePosition(list<Obstacle *>* obstacles);
+    void updatePosition(ObstacleGrid* obstacles);
 
     /**
      * @brief Gets the rectangle representing the projectile.
@@ -0,0 +1,220 @@
+/**
+ * @file renderworker.cpp
+ * @brief Implementation of the RenderWorker class methods.
+ */
+
+#include "renderworker.h"
+#include <QMetaObject>
+#include <QMutexLocker>
+
+/**
+ * @brief Constructor for RenderWorker class.
+ *
+ * One worker is enough, a frame is presented before the next one is needed.
+ *
+ * @param aWidget Widget the frames are presented on.
+ */
+RenderWorker::RenderWorker(QWidget *aWidget)
+    : itsWidget(aWidget)
+{
+    itsPool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief Destructor for RenderWorker class.
+ */
+RenderWorker::~RenderWorker()
+{
+    itsCancelled = true;
+    {
+        QMutexLocker locker(&itsMutex);
+        itsPending = FrameSnapshot();
+        itsHasPending = false;
+    }
+    itsPool.waitForDone();
+}
+
+/**
+ * @brief Paints the submitted snapshots until none is left, runs on the worker thread.
+ *
+ * The frame is painted into the image that is not presented. If the GUI is still drawing that
+ * image, from before the last frame was finished, the worker waits for it.
+ */
+void RenderWorker::run()
+{
+    while (true)
+    {
+        FrameSnapshot snapshot;
+        int target = 0;
+        {
+            QMutexLocker locker(&itsMutex);
+            if (!itsHasPending || itsCancelled)
+            {
+                itsBusy = false;
+                return;
+            }
+            snapshot = std::move(itsPending);
+            itsPending = FrameSnapshot();
+            itsHasPending = false;
+            target = itsFront == 0 ? 1 : 0;
+            while (itsPresented == target)
+            {
+                itsPresentDone.wait(&itsMutex);
+            }
+        }
+
+        paint(snapshot, itsFrames[target]);
+        {
+            QMutexLocker locker(&itsMutex);
+            itsFront = target;
+        }
+        itsFrameNb++;
+
+        // The widget is repainted on the GUI thread, which only draws the finished image
+        QMetaObject::invokeMethod(itsWidget, "update", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Paints a snapshot into an image.
+ *
+ * The sprites are blended by the software renderer, the background tiles, the HUD and the other
+ * images are drawn by the painter of the image.
+ *
+ * @param aSnapshot Snapshot converted to images.
+ * @param aFrame Image painted.
+ */
+void RenderWorker::paint(const FrameSnapshot &aSnapshot, QImage &aFrame)
+{
+    qreal ratio = aSnapshot.getItsDevicePixelRatio();
+    QSize deviceSize = aSnapshot.getItsSize() * ratio;
+    if (aFrame.size() != deviceSize || aFrame.devicePixelRatio() != ratio)
+    {
+        aFrame = QImage(deviceSize, QImage::Format_ARGB32_Premultiplied);
+        aFrame.setDevicePixelRatio(ratio);
+    }
+
+    QPainter painter(&aFrame);
+    itsRenderer.setItsKernel(itsKernel);
+    itsRenderer.begin(&painter);
+    for (const FrameSnapshot::Command &command : aSnapshot.getItsCommands())
+    {
+        if (command.source < 0)
+        {
+            painter.fillRect(command.target, command.color);
+        }
+        else if (command.isSprite)
+        {
+            itsRenderer.draw(command.target, aSnapshot.image(command.source), command.sourceRect);
+        }
+        else
+        {
+            painter.drawImage(QRectF(command.target), aSnapshot.image(command.source), QRectF(command.sourceRect));
+        }
+    }
+    itsRenderer.end();
+    itsBlitNb = itsRenderer.getItsBlitNb();
+    itsFallbackNb = itsRenderer.getItsFallbackNb();
+}
+
+/**
+ * @brief Hands a snapshot to the worker, replacing the one still waiting if any.
+ * @param aSnapshot Snapshot converted to images.
+ */
+void RenderWorker::submit(FrameSnapshot aSnapshot)
+{
+    QMutexLocker locker(&itsMutex);
+    if (itsHasPending)
+    {
+        itsDroppedNb++;
+    }
+    itsPending = std::move(aSnapshot);
+    itsHasPending = true;
+    if (!itsBusy)
+    {
+        itsBusy = true;
+        itsPool.start([this]() { run(); });
+    }
+}
+
+/**
+ * @brief Draws the last finished frame.
+ *
+ * The image is drawn without lock, the worker does not paint into it until it is released.
+ *
+ * @param aPainter Painter of the widget.
+ * @return False if no frame is finished yet.
+ */
+bool RenderWorker::present(QPainter *aPainter)
+{
+    int front = -1;
+    {
+        QMutexLocker locker(&itsMutex);
+        front = itsFront;
+        if (front < 0)
+        {
+            return false;
+        }
+        itsPresented = front;
+    }
+
+    aPainter->drawImage(0, 0, itsFrames[front]);
+
+    QMutexLocker locker(&itsMutex);
+    itsPresented = -1;
+    itsPresentDone.wakeAll();
+    return true;
+}
+
+/**
+ * @brief Waits until every submitted snapshot is painted.
+ */
+void RenderWorker::waitForDone()
+{
+    itsPool.waitForDone();
+}
+
+/**
+ * @brief Selects the kernel blending the sprites, from the next frame.
+ * @param aKernel Kernel, the scalar one is used if the processor does not support it.
+ */
+void RenderWorker::setItsKernel(SpriteBlitter::Kernel aKernel)
+{
+    itsKernel = SpriteBlitter::isSupported(aKernel) ? aKernel : SpriteBlitter::Kernel::Scalar;
+}
+
+/**
+ * @brief Returns the number of frames painted.
+ * @return Number of frames.
+ */
+int RenderWorker::getItsFrameNb() const
+{
+    return itsFrameNb;
+}
+
+/**
+ * @brief Returns the number of snapshots replaced by a newer one before being painted.
+ * @return Number of snapshots.
+ */
+int RenderWorker::getItsDroppedNb() const
+{
+    return itsDroppedNb;
+}
+
+/**
+ * @brief Returns the number of sprites blended by the kernel in the last frame.
+ * @return Number of sprites.
+ */
+int RenderWorker::getItsBlitNb() const
+{
+    return itsBlitNb;
+}
+
+/**
+ * @brief Returns the number of sprites drawn by the painter in the last frame.
+ * @return Number of sprites.
+ */
+int RenderWorker::getItsFallbackNb() const
+{
+    return itsFallbackNb;
+}
@@ -0,0 +1,128 @@
+#ifndef RENDERWORKER_H
+#define RENDERWORKER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QPainter>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QWidget>
+#include <atomic>
+#include "framesnapshot.h"
+#include "softwarerenderer.h"
+#include "spriteblitter.h"
+
+/**
+ * @brief The RenderWorker class paints the frames on a worker thread, the GUI thread only presents them.
+ *
+ * After each frame is recorded, the GUI hands its snapshot to the worker, which paints it into one
+ * of two images with the software renderer, then asks the widget to repaint. The paint event only
+ * draws the last finished image. When the GUI submits a snapshot while the worker is busy, the
+ * snapshot waits and a newer one replaces it: the worker always paints the latest frame.
+ */
+class RenderWorker
+{
+    QThreadPool itsPool; /**< Single worker thread of the renderer. */
+    QWidget *itsWidget; /**< Widget the frames are presented on, repainted when a frame is done. */
+    QMutex itsMutex; /**< Guards the pending snapshot and the state of the images. */
+    QWaitCondition itsPresentDone; /**< Wakes the worker waiting for the GUI to stop drawing an image. */
+    FrameSnapshot itsPending; /**< Latest snapshot submitted, not painted yet. */
+    bool itsHasPending = false; /**< True if itsPending holds a snapshot. */
+    bool itsBusy = false; /**< True while a task of the pool paints the submitted snapshots. */
+    QImage itsFrames[2]; /**< Images the frames are painted into, one is presented while the other is painted. */
+    int itsFront = -1; /**< Image holding the last finished frame, -1 before the first one. */
+    int itsPresented = -1; /**< Image being drawn on the widget, -1 if none. */
+    SoftwareRenderer itsRenderer; /**< Blends the sprites, only used by the worker. */
+    std::atomic<SpriteBlitter::Kernel> itsKernel{SpriteBlitter::bestKernel()}; /**< Kernel blending the sprites. */
+    std::atomic<bool> itsCancelled{false}; /**< Asks the worker to stop before the next frame. */
+    std::atomic<int> itsFrameNb{0}; /**< Frames painted. */
+    std::atomic<int> itsDroppedNb{0}; /**< Snapshots replaced by a newer one before being painted. */
+    std::atomic<int> itsBlitNb{0}; /**< Sprites blended by the kernel in the last frame. */
+    std::atomic<int> itsFallbackNb{0}; /**< Sprites drawn by the painter in the last frame. */
+
+    /**
+     * @brief Paints the submitted snapshots until none is left, runs on the worker thread.
+     */
+    void run();
+
+    /**
+     * @brief Paints a snapshot into an image.
+     *
+     * @param aSnapshot Snapshot converted to images
+     * @param aFrame Image painted, reallocated if the size of the frame changed
+     */
+    void paint(const FrameSnapshot &aSnapshot, QImage &aFrame);
+
+public:
+    /**
+     * @brief Constructor to initialize an idle worker.
+     *
+     * @param aWidget Widget the frames are presented on
+     */
+    explicit RenderWorker(QWidget *aWidget);
+
+    /**
+     * @brief Destructor, drops the pending snapshot and waits for the frame being painted.
+     */
+    ~RenderWorker();
+
+    RenderWorker(const RenderWorker &) = delete;
+    RenderWorker &operator=(const RenderWorker &) = delete;
+
+    /**
+     * @brief Hands a snapshot to the worker, replacing the one still waiting if any.
+     *
+     * @param aSnapshot Snapshot converted to images with FrameSnapshot::convertToImages()
+     */
+    void submit(FrameSnapshot aSnapshot);
+
+    /**
+     * @brief Draws the last finished frame.
+     *
+     * @param aPainter Painter of the widget
+     * @return False if no frame is finished yet
+     */
+    bool present(QPainter *aPainter);
+
+    /**
+     * @brief Waits until every submitted snapshot is painted.
+     */
+    void waitForDone();
+
+    /**
+     * @brief Selects the kernel blending the sprites, from the next frame.
+     *
+     * @param aKernel Kernel, the scalar one is used if the processor does not support it
+     */
+    void setItsKernel(SpriteBlitter::Kernel aKernel);
+
+    /**
+     * @brief Returns the number of frames painted.
+     *
+     * @return Number of frames
+     */
+    int getItsFrameNb() const;
+
+    /**
+     * @brief Returns the number of snapshots replaced by a newer one before being painted.
+     *
+     * @return Number of snapshots
+     */
+    int getItsDroppedNb() const;
+
+    /**
+     * @brief Returns the number of sprites blended by the kernel in the last frame.
+     *
+     * @return Number of sprites
+     */
+    int getItsBlitNb() const;
+
+    /**
+     * @brief Returns the number of sprites drawn by the painter in the last frame.
+     *
+     * @return Number of sprites
+     */
+    int getItsFallbackNb() const;
+};
+
+#endif // RENDERWORKER_H
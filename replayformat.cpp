@@ -0,0 +1,197 @@
+/**
+ * @file replayformat.cpp
+ * @brief Writing and checking of the binary replay format.
+ */
+
+#include "replayformat.h"
+#include "levelformat.h"
+#include <cstring>
+
+namespace ReplayFormat
+{
+
+/**
+ * @brief Adds a value to the hash of a state, byte by byte from the least significant one.
+ * @param aHash Hash of the values added before.
+ * @param aValue Value to add.
+ * @return The new hash.
+ */
+uint32_t hashValue(uint32_t aHash, int32_t aValue)
+{
+    uint32_t bits = static_cast<uint32_t>(aValue);
+    for (int byte = 0; byte < 4; ++byte)
+    {
+        aHash = (aHash ^ (bits & 0xFF)) * 16777619u;
+        bits >>= 8;
+    }
+    return aHash;
+}
+
+namespace
+{
+
+/**
+ * @brief Stores the low bytes of a value, from the least significant one.
+ * @param aValue Value to store.
+ * @param aSize Number of bytes to store.
+ * @param someBytes Receives the bytes, advanced past them.
+ */
+void putBytes(uint64_t aValue, int aSize, unsigned char *&someBytes)
+{
+    for (int byte = 0; byte < aSize; ++byte)
+    {
+        *someBytes++ = static_cast<unsigned char>(aValue >> (8 * byte));
+    }
+}
+
+/**
+ * @brief Loads a value stored from its least significant byte.
+ * @param aSize Number of bytes of the value.
+ * @param someBytes Bytes of the value, advanced past them.
+ * @return The value.
+ */
+uint64_t getBytes(int aSize, const unsigned char *&someBytes)
+{
+    uint64_t value = 0;
+    for (int byte = 0; byte < aSize; ++byte)
+    {
+        value |= uint64_t(*someBytes++) << (8 * byte);
+    }
+    return value;
+}
+
+}
+
+/**
+ * @brief Writes a replay into the binary format.
+ *
+ * Each field is stored byte by byte, so the file is little-endian whatever the host.
+ *
+ * @param aReplay Replay to write.
+ * @param aBlob Receives the replay.
+ */
+void write(const Replay &aReplay, std::vector<unsigned char> &aBlob)
+{
+    size_t recordBytes = aReplay.records.size() * sizeof(Record);
+    size_t hashBytes = aReplay.hashes.size() * sizeof(uint32_t);
+    aBlob.assign(sizeof(Header) + recordBytes + hashBytes, 0);
+
+    unsigned char *bytes = aBlob.data() + sizeof(Header);
+    for (const Record &record : aReplay.records)
+    {
+        putBytes(record.tick, 4, bytes);
+        putBytes(record.kind, 1, bytes);
+        putBytes(record.parameter, 1, bytes);
+        putBytes(0, 2, bytes);
+        putBytes(uint32_t(record.value), 4, bytes);
+    }
+    for (uint32_t hash : aReplay.hashes)
+    {
+        putBytes(hash, 4, bytes);
+    }
+
+    const unsigned char *payload = aBlob.data() + sizeof(Header);
+    bytes = aBlob.data();
+    std::memcpy(bytes, MAGIC, sizeof(MAGIC));
+    bytes += sizeof(MAGIC);
+    putBytes(VERSION, 2, bytes);
+    putBytes(sizeof(Record), 2, bytes);
+    putBytes(aReplay.seed, 8, bytes);
+    putBytes(uint32_t(aReplay.levelNb), 4, bytes);
+    putBytes(aReplay.tickRate, 4, bytes);
+    putBytes(aReplay.hashes.size(), 4, bytes);
+    putBytes(aReplay.records.size(), 4, bytes);
+    putBytes(LevelFormat::checksum(payload, recordBytes + hashBytes), 4, bytes);
+    putBytes(0, 4, bytes);
+}
+
+/**
+ * @brief Checks a replay and reads it.
+ * @param someData Replay in the binary format.
+ * @param aSize Size of the replay, in bytes.
+ * @param aReplay Receives the content of the replay.
+ * @param anError Receives the reason if the replay is refused.
+ * @return True if the replay is valid.
+ */
+bool read(const unsigned char *someData, size_t aSize, Replay &aReplay, std::string &anError)
+{
+    if (someData == nullptr || aSize < sizeof(Header))
+    {
+        anError = "file too short for a header";
+        return false;
+    }
+
+    Header header;
+    const unsigned char *bytes = someData;
+    std::memcpy(header.magic, bytes, sizeof(MAGIC));
+    bytes += sizeof(MAGIC);
+    header.version = uint16_t(getBytes(2, bytes));
+    header.recordSize = uint16_t(getBytes(2, bytes));
+    header.seed = getBytes(8, bytes);
+    header.levelNb = int32_t(uint32_t(getBytes(4, bytes)));
+    header.tickRate = uint32_t(getBytes(4, bytes));
+    header.tickNb = uint32_t(getBytes(4, bytes));
+    header.recordNb = uint32_t(getBytes(4, bytes));
+    header.checksum = uint32_t(getBytes(4, bytes));
+    header.reserved = uint32_t(getBytes(4, bytes));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        anError = "not a replay";
+        return false;
+    }
+    if (header.version != VERSION || header.recordSize != sizeof(Record))
+    {
+        anError = "unsupported version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION);
+        return false;
+    }
+
+    uint64_t recordBytes = uint64_t(header.recordNb) * sizeof(Record);
+    uint64_t hashBytes = uint64_t(header.tickNb) * sizeof(uint32_t);
+    uint64_t expectedSize = sizeof(Header) + recordBytes + hashBytes;
+    if (expectedSize != aSize)
+    {
+        anError = "size is " + std::to_string(aSize) + " bytes, expected " + std::to_string(expectedSize);
+        return false;
+    }
+    const unsigned char *payload = someData + sizeof(Header);
+    if (LevelFormat::checksum(payload, aSize - sizeof(Header)) != header.checksum)
+    {
+        anError = "checksum mismatch";
+        return false;
+    }
+
+    aReplay.seed = header.seed;
+    aReplay.levelNb = header.levelNb;
+    aReplay.tickRate = header.tickRate;
+    aReplay.records.resize(header.recordNb);
+    aReplay.hashes.resize(header.tickNb);
+    bytes = payload;
+    for (Record &record : aReplay.records)
+    {
+        record.tick = uint32_t(getBytes(4, bytes));
+        record.kind = uint8_t(getBytes(1, bytes));
+        record.parameter = uint8_t(getBytes(1, bytes));
+        record.reserved = uint16_t(getBytes(2, bytes));
+        record.value = int32_t(uint32_t(getBytes(4, bytes)));
+    }
+    for (uint32_t &hash : aReplay.hashes)
+    {
+        hash = uint32_t(getBytes(4, bytes));
+    }
+
+    // A level load may follow the last tick, nothing else may be out of the recorded ticks
+    uint32_t previousTick = 0;
+    for (uint32_t index = 0; index < header.recordNb; ++index)
+    {
+        const Record &record = aReplay.records[index];
+        if (record.kind >= EventKindCount || record.tick < previousTick || record.tick > header.tickNb)
+        {
+            anError = "invalid record " + std::to_string(index);
+            return false;
+        }
+        previousTick = record.tick;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef REPLAYFORMAT_H
+#define REPLAYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file replayformat.h
+ * @brief Binary replay format, written while playing and read to play a run again.
+ *
+ * A replay (.nrpl) is a header, followed by fixed-size event records sorted by tick, followed by
+ * one 32-bit hash of the state of the world per tick. The header gives the seed of the gameplay
+ * random numbers and the first level, the events give every input command and every level load
+ * with the tick it was applied at, so the simulation runs the same ticks again. The hashes detect
+ * the first tick at which a replay diverges from the recorded run. Every field is little-endian
+ * and written byte by byte, so a replay plays on any host. The checksum covers everything after
+ * the header, with LevelFormat::checksum(). This file only depends on the standard library.
+ */
+
+namespace ReplayFormat
+{
+
+const char MAGIC[4] = {'N', 'R', 'P', 'L'}; ///< First bytes of every replay.
+const uint16_t VERSION = 1; ///< Version of the format, bumped on any layout change.
+const uint32_t HASH_START = 2166136261u; ///< Hash of a state before any value is added, the FNV-1a offset basis.
+
+/**
+ * @brief Kind of event a record describes.
+ */
+enum EventKind : uint8_t
+{
+    Input, ///< Input command: parameter is the InputAction, value is 1 on press and 0 on release.
+    LoadLevel, ///< Level load before the tick: value is the level number, parameter is 1 if the death is reset.
+    EventKindCount
+};
+
+/**
+ * @brief Header at the start of a replay.
+ */
+struct Header
+{
+    char magic[4]; ///< Always MAGIC.
+    uint16_t version; ///< Always VERSION.
+    uint16_t recordSize; ///< Size of a record, in bytes.
+    uint64_t seed; ///< Seed of the gameplay random numbers.
+    int32_t levelNb; ///< Number of the level the replay starts in.
+    uint32_t tickRate; ///< Ticks per second of the recorded run.
+    uint32_t tickNb; ///< Number of ticks recorded, and of hashes.
+    uint32_t recordNb; ///< Number of event records.
+    uint32_t checksum; ///< FNV-1a hash of the records and the hashes.
+    uint32_t reserved; ///< Always zero.
+};
+
+/**
+ * @brief Event of a replay.
+ */
+struct Record
+{
+    uint32_t tick; ///< Number of the tick the event is applied at, counted from the start of the replay.
+    uint8_t kind; ///< EventKind of the event.
+    uint8_t parameter; ///< Depends on the kind.
+    uint16_t reserved; ///< Always zero.
+    int32_t value; ///< Depends on the kind.
+};
+
+static_assert(sizeof(Header) == 40, "The header layout is part of the file format");
+static_assert(sizeof(Record) == 12, "The record layout is part of the file format");
+
+/**
+ * @brief Content of a replay.
+ */
+struct Replay
+{
+    uint64_t seed = 0; ///< Seed of the gameplay random numbers.
+    int32_t levelNb = 0; ///< Number of the level the replay starts in.
+    uint32_t tickRate = 100; ///< Ticks per second of the recorded run.
+    std::vector<Record> records; ///< Events, sorted by tick.
+    std::vector<uint32_t> hashes; ///< Hash of the state after each tick.
+};
+
+/**
+ * @brief Adds a value to the hash of a state.
+ *
+ * @param aHash Hash of the values added before, HASH_START for the first one
+ * @param aValue Value to add
+ * @return The new hash
+ */
+uint32_t hashValue(uint32_t aHash, int32_t aValue);
+
+/**
+ * @brief Writes a replay into the binary format.
+ *
+ * @param aReplay Replay to write, its records sorted by tick
+ * @param aBlob Receives the replay
+ */
+void write(const Replay &aReplay, std::vector<unsigned char> &aBlob);
+
+/**
+ * @brief Checks a replay and reads it.
+ *
+ * @param someData Replay in the binary format
+ * @param aSize Size of the replay, in bytes
+ * @param aReplay Receives the content of the replay
+ * @param anError Receives the reason if the replay is refused
+ * @return True if the replay is valid
+ */
+bool read(const unsigned char *someData, size_t aSize, Replay &aReplay, std::string &anError);
+
+}
+
+#endif // REPLAYFORMAT_H
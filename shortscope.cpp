@@ -21,19 +21,19 @@ ShortScope::ShortScope(int aX, int aY, int aWidth, int aHeight, int type)
 
 /**
  * @brief Updates the position of the character based on obstacles.
- * @param obstacles A pointer to a list of obstacles to check against.
+ * @param obstacles A pointer to the grid of obstacles to check against.
  *
  * This function checks if there is an obstacle below the character and changes its movement direction accordingly.
  * It also handles collisions with obstacles to avoid getting stuck.
  */
-void ShortScope::updatePosition(std::list<Obstacle *>* obstacles)
+void ShortScope::updatePosition(ObstacleGrid* obstacles)
 {
     // Check if there is an obstacle below
     bool obstacleBelow = false;
     QRect fictiveCharacter = itsCharacter;
     fictiveCharacter.translate(itsXSpeed * 60, itsCharacter.height() / 4 + 1); // One pixel below the character
 
-    for (Obstacle* obstacle : *obstacles)
+    for (Obstacle* obstacle : obstacles->query(fictiveCharacter))
     {
         if (fictiveCharacter.intersects(obstacle->getRect()))
         {
@@ -46,19 +46,21 @@ void ShortScope::updatePosition(std::list<Obstacle *>* obstacles)
     if (!obstacleBelow)
     {
         itsXSpeed = -itsXSpeed;
+        itsXRemainder = 0;
         previousDirection = !previousDirection;
     }
 
     // Create a fictive rectangle for the new position
     QRect newCharacterRect = itsCharacter;
-    newCharacterRect.translate(itsXSpeed, 0);
+    newCharacterRect.translate(scaleMove(itsXSpeed, itsXRemainder), 0);
 
-    for (Obstacle* obstacle : *obstacles)
+    for (Obstacle* obstacle : obstacles->query(newCharacterRect))
     {
         if (newCharacterRect.intersects(obstacle->getRect()))
         {
             // Reverse direction in case of collision
             itsXSpeed = -itsXSpeed;
+            itsXRemainder = 0;
             previousDirection = !previousDirection;
             newCharacterRect.translate(2 * itsXSpeed, 0); // Adjust position to avoid blocking
             break;
@@ -28,9 +28,9 @@ public:
     /**
      * @brief Updates the position of the ShortScope.
      *
-     * @param obstacles List of obstacles present in the game
+     * @param obstacles Grid of the obstacles present in the game
      */
-    void updatePosition(list<Obstacle *>* obstacles);
+    void updatePosition(ObstacleGrid* obstacles);
 
     /**
      * @brief Performs an attack action using the ShortScope.
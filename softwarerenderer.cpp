@@ -0,0 +1,187 @@
+/**
+ * @file softwarerenderer.cpp
+ * @brief Implementation of the SoftwareRenderer class methods.
+ */
+
+#include "softwarerenderer.h"
+#include <QTransform>
+#include <cmath>
+#include <iterator>
+
+/**
+ * @brief Returns the pixels of an atlas page.
+ * @param aPage Atlas page.
+ * @return The page as a premultiplied ARGB32 image.
+ */
+const QImage &SoftwareRenderer::pageImage(const QPixmap &aPage)
+{
+    qint64 key = aPage.cacheKey();
+    itsUsedPages.insert(key);
+    auto cached = itsPageImages.find(key);
+    if (cached == itsPageImages.end())
+    {
+        QImage image = aPage.toImage();
+        if (image.format() != QImage::Format_ARGB32_Premultiplied)
+        {
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        }
+        cached = itsPageImages.insert(key, image);
+    }
+    return cached.value();
+}
+
+/**
+ * @brief Returns the back buffer, reallocated if the size of the widget changed.
+ * @param aSize Size of the widget, in logical pixels.
+ * @param aDevicePixelRatio Device pixel ratio of the screen of the widget.
+ * @return Image to paint the frame on.
+ */
+QImage *SoftwareRenderer::backBuffer(const QSize &aSize, qreal aDevicePixelRatio)
+{
+    QSize deviceSize = aSize * aDevicePixelRatio;
+    if (itsBackBuffer.size() != deviceSize || itsBackBuffer.devicePixelRatio() != aDevicePixelRatio)
+    {
+        itsBackBuffer = QImage(deviceSize, QImage::Format_ARGB32_Premultiplied);
+        itsBackBuffer.setDevicePixelRatio(aDevicePixelRatio);
+    }
+    return &itsBackBuffer;
+}
+
+/**
+ * @brief Starts a frame, the counters are reset.
+ *
+ * The image the painter paints on is cleared, the parts of the screen the frame does not cover
+ * stay black. The blitter only draws on an image, on another device every sprite is drawn by the
+ * painter.
+ *
+ * @param aPainter Painter active on the image the frame is composed in.
+ */
+void SoftwareRenderer::begin(QPainter *aPainter)
+{
+    itsPainter = aPainter;
+    itsTarget = nullptr;
+    if (aPainter->device() != nullptr && aPainter->device()->devType() == QInternal::Image)
+    {
+        itsTarget = static_cast<QImage *>(aPainter->device());
+        itsTarget->fill(Qt::black);
+    }
+    itsBlitNb = 0;
+    itsFallbackNb = 0;
+}
+
+/**
+ * @brief Draws a sprite, with the blitter when its device rectangle matches its frame.
+ * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter.
+ * @param aFrame Sprite, nothing is drawn if it has no frame.
+ */
+void SoftwareRenderer::draw(const QRect &aTarget, const SpriteFrame &aFrame)
+{
+    if (itsPainter == nullptr || aFrame.page.isNull() || aFrame.source.isEmpty())
+    {
+        return;
+    }
+    draw(aTarget, pageImage(aFrame.page), aFrame.source);
+}
+
+/**
+ * @brief Draws part of a premultiplied image, with the blitter when its device rectangle matches that part.
+ *
+ * The target is mapped to device pixels with the transform of the painter. The blitter takes the
+ * sprite when the transform only translates and scales, when the mapped rectangle has the size of
+ * the source and starts on a whole pixel, and when the painter blends as usual: full opacity, source
+ * over and no clipping. The sprite is then clipped to the image painted on and blended.
+ *
+ * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter.
+ * @param aPage Image holding the sprite, an atlas page.
+ * @param aSource Part of the page drawn, in its device pixels.
+ */
+void SoftwareRenderer::draw(const QRect &aTarget, const QImage &aPage, const QRect &aSource)
+{
+    if (itsPainter == nullptr || aPage.isNull() || aSource.isEmpty())
+    {
+        return;
+    }
+
+    QTransform transform = itsPainter->deviceTransform();
+    QRectF device = transform.mapRect(QRectF(aTarget));
+    QPoint topLeft(qRound(device.left()), qRound(device.top()));
+    bool blittable = itsTarget != nullptr && itsTarget->format() == QImage::Format_ARGB32_Premultiplied
+                     && transform.type() <= QTransform::TxScale && std::abs(device.left() - topLeft.x()) < 0.01
+                     && std::abs(device.top() - topLeft.y()) < 0.01 && qRound(device.width()) == aSource.width()
+                     && qRound(device.height()) == aSource.height() && itsPainter->opacity() == 1.0
+                     && itsPainter->compositionMode() == QPainter::CompositionMode_SourceOver && !itsPainter->hasClipping()
+                     && aPage.format() == QImage::Format_ARGB32_Premultiplied;
+    if (!blittable)
+    {
+        itsPainter->drawImage(QRectF(aTarget), aPage, QRectF(aSource));
+        itsFallbackNb++;
+        return;
+    }
+
+    QRect destination = QRect(topLeft, aSource.size()).intersected(itsTarget->rect());
+    if (destination.isEmpty())
+    {
+        return;
+    }
+    QPoint source = aSource.topLeft() + (destination.topLeft() - topLeft);
+
+    // The painter does not hold a reference on the image it paints on, scanLine() does not detach it
+    auto *destinationPixels = reinterpret_cast<uint32_t *>(itsTarget->scanLine(destination.y())) + destination.x();
+    auto *sourcePixels = reinterpret_cast<const uint32_t *>(aPage.constScanLine(source.y())) + source.x();
+    SpriteBlitter::blend(itsKernel, destinationPixels, size_t(itsTarget->bytesPerLine()) / 4, sourcePixels,
+                         size_t(aPage.bytesPerLine()) / 4, destination.width(), destination.height());
+    itsBlitNb++;
+}
+
+/**
+ * @brief Ends a frame, the pages not drawn in it are released.
+ *
+ * The images share the pixels of the pages, a page evicted by the asset manager is only freed
+ * once no image holds it.
+ */
+void SoftwareRenderer::end()
+{
+    for (auto page = itsPageImages.begin(); page != itsPageImages.end();)
+    {
+        page = itsUsedPages.contains(page.key()) ? std::next(page) : itsPageImages.erase(page);
+    }
+    itsUsedPages.clear();
+    itsPainter = nullptr;
+    itsTarget = nullptr;
+}
+
+/**
+ * @brief Selects the kernel blending the sprites.
+ * @param aKernel Kernel, it must be supported by the processor.
+ */
+void SoftwareRenderer::setItsKernel(SpriteBlitter::Kernel aKernel)
+{
+    itsKernel = SpriteBlitter::isSupported(aKernel) ? aKernel : SpriteBlitter::Kernel::Scalar;
+}
+
+/**
+ * @brief Returns the kernel blending the sprites.
+ * @return The kernel.
+ */
+SpriteBlitter::Kernel SoftwareRenderer::getItsKernel() const
+{
+    return itsKernel;
+}
+
+/**
+ * @brief Returns the number of sprites blended by the kernel since begin().
+ * @return Number of sprites.
+ */
+int SoftwareRenderer::getItsBlitNb() const
+{
+    return itsBlitNb;
+}
+
+/**
+ * @brief Returns the number of sprites drawn by the painter since begin().
+ * @return Number of sprites.
+ */
+int SoftwareRenderer::getItsFallbackNb() const
+{
+    return itsFallbackNb;
+}
@@ -0,0 +1,114 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+#include <QSet>
+#include <QSize>
+#include "assetmanager.h"
+#include "spriteblitter.h"
+
+/**
+ * @brief The SoftwareRenderer class composes a frame into a back buffer, the sprites with the sprite blitter.
+ *
+ * The frame is painted into a QImage::Format_ARGB32_Premultiplied image, the back buffer of the
+ * widget or a frame of the render thread, which is then drawn with a single drawImage(). The sprites
+ * drawn at their pre-scaled size on whole device pixels, which is nearly all of them, are blended
+ * straight into the image by a SpriteBlitter kernel. The other ones, and everything that is not a
+ * sprite, go through the painter of the image. The raster paint engine writes to the image as it
+ * draws, so both can be interleaved. The renderer is used by one thread at a time.
+ */
+class SoftwareRenderer
+{
+    QImage itsBackBuffer; /**< Frame being composed. */
+    QPainter *itsPainter = nullptr; /**< Painter of the frame, used for the sprites the blitter cannot draw. */
+    QImage *itsTarget = nullptr; /**< Image the painter paints on, nullptr if it paints on another device. */
+    SpriteBlitter::Kernel itsKernel = SpriteBlitter::bestKernel(); /**< Kernel blending the sprites. */
+    QHash<qint64, QImage> itsPageImages; /**< Pixels of the atlas pages drawn, by cache key of their pixmap. */
+    QSet<qint64> itsUsedPages; /**< Atlas pages drawn in the current frame. */
+    int itsBlitNb = 0; /**< Sprites blended by the kernel since begin(). */
+    int itsFallbackNb = 0; /**< Sprites drawn by the painter since begin(). */
+
+    /**
+     * @brief Returns the pixels of an atlas page.
+     *
+     * On the raster platform, a pixmap holds an image and the conversion shares it without copy.
+     *
+     * @param aPage Atlas page
+     * @return The page as a premultiplied ARGB32 image
+     */
+    const QImage &pageImage(const QPixmap &aPage);
+
+public:
+    /**
+     * @brief Returns the back buffer, reallocated if the size of the widget changed.
+     *
+     * @param aSize Size of the widget, in logical pixels
+     * @param aDevicePixelRatio Device pixel ratio of the screen of the widget
+     * @return Image to paint the frame on
+     */
+    QImage *backBuffer(const QSize &aSize, qreal aDevicePixelRatio);
+
+    /**
+     * @brief Starts a frame, the counters are reset and the image painted on is cleared.
+     *
+     * @param aPainter Painter active on the back buffer, or on another image
+     */
+    void begin(QPainter *aPainter);
+
+    /**
+     * @brief Draws a sprite, with the blitter when its device rectangle matches its frame.
+     *
+     * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter
+     * @param aFrame Sprite, nothing is drawn if it has no frame
+     */
+    void draw(const QRect &aTarget, const SpriteFrame &aFrame);
+
+    /**
+     * @brief Draws part of a premultiplied image, with the blitter when its device rectangle matches that part.
+     *
+     * Used by the render thread, which cannot use the pixmaps of the atlas pages.
+     *
+     * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter
+     * @param aPage Image holding the sprite, an atlas page
+     * @param aSource Part of the page drawn, in its device pixels
+     */
+    void draw(const QRect &aTarget, const QImage &aPage, const QRect &aSource);
+
+    /**
+     * @brief Ends a frame, the pages not drawn in it are released.
+     */
+    void end();
+
+    /**
+     * @brief Selects the kernel blending the sprites.
+     *
+     * @param aKernel Kernel, it must be supported by the processor
+     */
+    void setItsKernel(SpriteBlitter::Kernel aKernel);
+
+    /**
+     * @brief Returns the kernel blending the sprites.
+     *
+     * @return The kernel
+     */
+    SpriteBlitter::Kernel getItsKernel() const;
+
+    /**
+     * @brief Returns the number of sprites blended by the kernel since begin().
+     *
+     * @return Number of sprites
+     */
+    int getItsBlitNb() const;
+
+    /**
+     * @brief Returns the number of sprites drawn by the painter since begin().
+     *
+     * @return Number of sprites
+     */
+    int getItsFallbackNb() const;
+};
+
+#endif // SOFTWARERENDERER_H
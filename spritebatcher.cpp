@@ -0,0 +1,80 @@
+/**
+ * @file spritebatcher.cpp
+ * @brief Implementation of the SpriteBatcher class methods.
+ */
+
+#include "spritebatcher.h"
+
+/**
+ * @brief Starts drawing with a painter, the counters are reset.
+ * @param aPainter Painter the batches are sent to.
+ */
+void SpriteBatcher::begin(QPainter *aPainter)
+{
+    itsPainter = aPainter;
+    itsPage = QPixmap();
+    itsFragments.clear();
+    itsBatchNb = 0;
+    itsSpriteNb = 0;
+}
+
+/**
+ * @brief Queues a sprite, the pending batch is sent first if the sprite is on another page.
+ *
+ * A fragment is placed by its center and scaled from the frame size, in device pixels, to the
+ * target size. The pages have a device pixel ratio of 1, so the frames pre-scaled for the screen
+ * come out at their size in device pixels.
+ *
+ * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter.
+ * @param aFrame Sprite, nothing is drawn if it has no frame.
+ */
+void SpriteBatcher::draw(const QRect &aTarget, const SpriteFrame &aFrame)
+{
+    if (aFrame.page.isNull() || aFrame.source.isEmpty())
+    {
+        return;
+    }
+    if (aFrame.page.cacheKey() != itsPage.cacheKey())
+    {
+        flush();
+        itsPage = aFrame.page;
+    }
+
+    QRectF target(aTarget);
+    itsFragments.append(QPainter::PixmapFragment::create(target.center(), QRectF(aFrame.source),
+                                                         target.width() / aFrame.source.width(),
+                                                         target.height() / aFrame.source.height()));
+    itsSpriteNb++;
+}
+
+/**
+ * @brief Sends the queued sprites in one call.
+ */
+void SpriteBatcher::flush()
+{
+    if (itsFragments.isEmpty() || itsPainter == nullptr)
+    {
+        return;
+    }
+    itsPainter->drawPixmapFragments(itsFragments.constData(), static_cast<int>(itsFragments.size()), itsPage);
+    itsFragments.clear();
+    itsBatchNb++;
+}
+
+/**
+ * @brief Returns the number of batches sent since begin().
+ * @return Number of drawPixmapFragments() calls.
+ */
+int SpriteBatcher::getItsBatchNb() const
+{
+    return itsBatchNb;
+}
+
+/**
+ * @brief Returns the number of sprites drawn since begin().
+ * @return Number of sprites.
+ */
+int SpriteBatcher::getItsSpriteNb() const
+{
+    return itsSpriteNb;
+}
@@ -0,0 +1,63 @@
+#ifndef SPRITEBATCHER_H
+#define SPRITEBATCHER_H
+
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <QVector>
+#include "assetmanager.h"
+
+/**
+ * @brief The SpriteBatcher class groups the sprites drawn from the same atlas page into one call.
+ *
+ * The sprites are queued as pixmap fragments while they come from the page of the previous
+ * sprite, and sent with a single QPainter::drawPixmapFragments() when the page changes or when
+ * the batch is flushed. The draw order is kept, so the sprites overlap as if drawn one by one.
+ * The painter state, its transform included, is read when a batch is sent: the batch must be
+ * flushed before the state changes or anything is drawn without the batcher.
+ */
+class SpriteBatcher
+{
+    QPainter *itsPainter = nullptr; /**< Painter the batches are sent to. */
+    QPixmap itsPage; /**< Atlas page of the queued fragments. */
+    QVector<QPainter::PixmapFragment> itsFragments; /**< Sprites queued since the last batch. */
+    int itsBatchNb = 0; /**< Number of batches sent since begin(). */
+    int itsSpriteNb = 0; /**< Number of sprites drawn since begin(). */
+
+public:
+    /**
+     * @brief Starts drawing with a painter, the counters are reset.
+     *
+     * @param aPainter Painter the batches are sent to
+     */
+    void begin(QPainter *aPainter);
+
+    /**
+     * @brief Queues a sprite, the pending batch is sent first if the sprite is on another page.
+     *
+     * @param aTarget Rectangle the sprite is stretched to, in the coordinates of the painter
+     * @param aFrame Sprite, nothing is drawn if it has no frame
+     */
+    void draw(const QRect &aTarget, const SpriteFrame &aFrame);
+
+    /**
+     * @brief Sends the queued sprites in one call.
+     */
+    void flush();
+
+    /**
+     * @brief Returns the number of batches sent since begin().
+     *
+     * @return Number of drawPixmapFragments() calls
+     */
+    int getItsBatchNb() const;
+
+    /**
+     * @brief Returns the number of sprites drawn since begin().
+     *
+     * @return Number of sprites
+     */
+    int getItsSpriteNb() const;
+};
+
+#endif // SPRITEBATCHER_H
@@ -0,0 +1,310 @@
+/**
+ * @file spriteblitter.cpp
+ * @brief Scalar, SSE4.1 and AVX2 kernels of the sprite blitter.
+ */
+
+#include "spriteblitter.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || (defined(_M_IX86) && !defined(_M_ARM64EC))
+#define SPRITEBLITTER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SPRITEBLITTER_TARGET(isa)
+#else
+#define SPRITEBLITTER_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace SpriteBlitter
+{
+
+namespace
+{
+
+/**
+ * @brief Blends one pixel, two channels per 32-bit multiplication.
+ * @param aSource Premultiplied sprite pixel.
+ * @param aDestination Premultiplied back buffer pixel.
+ * @return The blended pixel.
+ */
+inline uint32_t blendPixel(uint32_t aSource, uint32_t aDestination)
+{
+    if (aSource == 0)
+    {
+        return aDestination;
+    }
+    uint32_t inverse = 255 - (aSource >> 24);
+    uint32_t redBlue = (aDestination & 0x00ff00ff) * inverse + 0x00800080;
+    redBlue = ((redBlue + ((redBlue >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+    uint32_t alphaGreen = ((aDestination >> 8) & 0x00ff00ff) * inverse + 0x00800080;
+    alphaGreen = (alphaGreen + ((alphaGreen >> 8) & 0x00ff00ff)) & 0xff00ff00;
+    return aSource + (redBlue | alphaGreen);
+}
+
+/**
+ * @brief Blends the pixels of a line left over by a vector kernel.
+ * @param aDestination Back buffer line.
+ * @param aSource Sprite line.
+ * @param aFrom First pixel to blend.
+ * @param aWidth Width of the line.
+ */
+inline void blendTail(uint32_t *aDestination, const uint32_t *aSource, int aFrom, int aWidth)
+{
+    for (int x = aFrom; x < aWidth; ++x)
+    {
+        aDestination[x] = blendPixel(aSource[x], aDestination[x]);
+    }
+}
+
+/**
+ * @brief Scalar kernel, see blend().
+ */
+void blendScalar(uint32_t *aDestination, size_t aDestinationStride, const uint32_t *aSource, size_t aSourceStride,
+                 int aWidth, int aHeight)
+{
+    for (int y = 0; y < aHeight; ++y)
+    {
+        blendTail(aDestination + y * aDestinationStride, aSource + y * aSourceStride, 0, aWidth);
+    }
+}
+
+#ifdef SPRITEBLITTER_X86
+
+/**
+ * @brief Multiplies 16-bit channels by 255 - alpha of their pixel, divided by 255 and rounded.
+ * @param aChannels Two pixels of the back buffer, one channel per 16-bit lane.
+ * @param aSource The two sprite pixels over them, one channel per 16-bit lane.
+ * @return The scaled channels.
+ */
+SPRITEBLITTER_TARGET("sse4.1")
+inline __m128i scaleSse41(__m128i aChannels, __m128i aSource)
+{
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(aSource, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i product = _mm_add_epi16(_mm_mullo_epi16(aChannels, _mm_sub_epi16(_mm_set1_epi16(255), alpha)), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+/**
+ * @brief SSE4.1 kernel, four pixels at a time, see blend().
+ *
+ * Groups of fully transparent pixels are skipped and groups of opaque pixels are copied, which
+ * covers most of a sprite.
+ */
+SPRITEBLITTER_TARGET("sse4.1")
+void blendSse41(uint32_t *aDestination, size_t aDestinationStride, const uint32_t *aSource, size_t aSourceStride,
+                int aWidth, int aHeight)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(int(0xff000000));
+    for (int y = 0; y < aHeight; ++y)
+    {
+        uint32_t *destination = aDestination + y * aDestinationStride;
+        const uint32_t *source = aSource + y * aSourceStride;
+        int x = 0;
+        for (; x + 4 <= aWidth; x += 4)
+        {
+            __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x));
+            if (_mm_testz_si128(sourcePixels, sourcePixels))
+            {
+                continue;
+            }
+            __m128i *target = reinterpret_cast<__m128i *>(destination + x);
+            if (_mm_testc_si128(sourcePixels, alphaMask))
+            {
+                _mm_storeu_si128(target, sourcePixels);
+                continue;
+            }
+            __m128i pixels = _mm_loadu_si128(target);
+            __m128i low = scaleSse41(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(sourcePixels, zero));
+            __m128i high = scaleSse41(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(sourcePixels, zero));
+            _mm_storeu_si128(target, _mm_add_epi8(sourcePixels, _mm_packus_epi16(low, high)));
+        }
+        blendTail(destination, source, x, aWidth);
+    }
+}
+
+/**
+ * @brief Multiplies 16-bit channels by 255 - alpha of their pixel, divided by 255 and rounded.
+ * @param aChannels Four pixels of the back buffer, one channel per 16-bit lane.
+ * @param aSource The four sprite pixels over them, one channel per 16-bit lane.
+ * @return The scaled channels.
+ */
+SPRITEBLITTER_TARGET("avx2")
+inline __m256i scaleAvx2(__m256i aChannels, __m256i aSource)
+{
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(aSource, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(aChannels, _mm256_sub_epi16(_mm256_set1_epi16(255), alpha)),
+                                       _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+/**
+ * @brief AVX2 kernel, eight pixels at a time, see blendSse41().
+ *
+ * The unpacking and the packing both work within each 128-bit half, so the pixels keep their order.
+ */
+SPRITEBLITTER_TARGET("avx2")
+void blendAvx2(uint32_t *aDestination, size_t aDestinationStride, const uint32_t *aSource, size_t aSourceStride,
+               int aWidth, int aHeight)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaMask = _mm256_set1_epi32(int(0xff000000));
+    for (int y = 0; y < aHeight; ++y)
+    {
+        uint32_t *destination = aDestination + y * aDestinationStride;
+        const uint32_t *source = aSource + y * aSourceStride;
+        int x = 0;
+        for (; x + 8 <= aWidth; x += 8)
+        {
+            __m256i sourcePixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x));
+            if (_mm256_testz_si256(sourcePixels, sourcePixels))
+            {
+                continue;
+            }
+            __m256i *target = reinterpret_cast<__m256i *>(destination + x);
+            if (_mm256_testc_si256(sourcePixels, alphaMask))
+            {
+                _mm256_storeu_si256(target, sourcePixels);
+                continue;
+            }
+            __m256i pixels = _mm256_loadu_si256(target);
+            __m256i low = scaleAvx2(_mm256_unpacklo_epi8(pixels, zero), _mm256_unpacklo_epi8(sourcePixels, zero));
+            __m256i high = scaleAvx2(_mm256_unpackhi_epi8(pixels, zero), _mm256_unpackhi_epi8(sourcePixels, zero));
+            _mm256_storeu_si256(target, _mm256_add_epi8(sourcePixels, _mm256_packus_epi16(low, high)));
+        }
+        blendTail(destination, source, x, aWidth);
+    }
+}
+
+/**
+ * @brief Reads the instruction sets of the processor, and whether the system saves the AVX registers.
+ * @param aSse41 Receives whether SSE4.1 is available.
+ * @param anAvx2 Receives whether AVX2 is available.
+ */
+void detect(bool &aSse41, bool &anAvx2)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    aSse41 = (info[2] & (1 << 19)) != 0;
+    bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    anAvx2 = osSavesAvx && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    aSse41 = __builtin_cpu_supports("sse4.1");
+    anAvx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+const char *const NAMES[static_cast<int>(Kernel::KernelCount)] = {"scalar", "sse4.1", "avx2"};
+
+}
+
+/**
+ * @brief Checks whether the processor runs a kernel.
+ *
+ * The processor is only queried once.
+ *
+ * @param aKernel Kernel to check.
+ * @return True if the kernel was compiled in and the processor has its instruction set.
+ */
+bool isSupported(Kernel aKernel)
+{
+#ifdef SPRITEBLITTER_X86
+    static bool sse41 = false;
+    static bool avx2 = false;
+    static bool detected = (detect(sse41, avx2), true);
+    (void)detected;
+    switch (aKernel)
+    {
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Sse41:
+        return sse41;
+    case Kernel::Avx2:
+        return avx2;
+    default:
+        return false;
+    }
+#else
+    return aKernel == Kernel::Scalar;
+#endif
+}
+
+/**
+ * @brief Returns the fastest kernel the processor runs.
+ * @return AVX2, else SSE4.1, else the scalar kernel.
+ */
+Kernel bestKernel()
+{
+    if (isSupported(Kernel::Avx2))
+    {
+        return Kernel::Avx2;
+    }
+    return isSupported(Kernel::Sse41) ? Kernel::Sse41 : Kernel::Scalar;
+}
+
+/**
+ * @brief Returns the name of a kernel, as given on the command line.
+ * @param aKernel Kernel.
+ * @return "scalar", "sse4.1" or "avx2".
+ */
+const char *kernelName(Kernel aKernel)
+{
+    int index = static_cast<int>(aKernel);
+    return index >= 0 && index < static_cast<int>(Kernel::KernelCount) ? NAMES[index] : "unknown";
+}
+
+/**
+ * @brief Finds a kernel by name.
+ * @param aName Name given by kernelName().
+ * @param aKernel Receives the kernel.
+ * @return True if the name is known.
+ */
+bool kernelFromName(std::string_view aName, Kernel &aKernel)
+{
+    for (int index = 0; index < static_cast<int>(Kernel::KernelCount); ++index)
+    {
+        if (aName == NAMES[index])
+        {
+            aKernel = static_cast<Kernel>(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Blends a sprite over a rectangle of the back buffer.
+ * @param aKernel Kernel to run, it must be supported.
+ * @param aDestination First pixel of the rectangle in the back buffer.
+ * @param aDestinationStride Distance between two lines of the back buffer, in pixels.
+ * @param aSource First pixel of the sprite to blend.
+ * @param aSourceStride Distance between two lines of the sprite, in pixels.
+ * @param aWidth Width of the rectangle, in pixels.
+ * @param aHeight Height of the rectangle, in pixels.
+ */
+void blend(Kernel aKernel, uint32_t *aDestination, size_t aDestinationStride, const uint32_t *aSource,
+           size_t aSourceStride, int aWidth, int aHeight)
+{
+    switch (aKernel)
+    {
+#ifdef SPRITEBLITTER_X86
+    case Kernel::Avx2:
+        blendAvx2(aDestination, aDestinationStride, aSource, aSourceStride, aWidth, aHeight);
+        break;
+    case Kernel::Sse41:
+        blendSse41(aDestination, aDestinationStride, aSource, aSourceStride, aWidth, aHeight);
+        break;
+#endif
+    default:
+        blendScalar(aDestination, aDestinationStride, aSource, aSourceStride, aWidth, aHeight);
+        break;
+    }
+}
+
+}
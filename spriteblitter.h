@@ -0,0 +1,80 @@
+#ifndef SPRITEBLITTER_H
+#define SPRITEBLITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @file spriteblitter.h
+ * @brief Alpha blending of pre-scaled sprites into a back buffer, for the software renderer.
+ *
+ * The pixels are premultiplied 32-bit ARGB, laid out like QImage::Format_ARGB32_Premultiplied, and
+ * the sprites are blended at integer positions without scaling, which is how the pre-scaled sprite
+ * frames are drawn. Each pixel gets source over: d = s + d * (255 - sa) / 255, rounded exactly, so
+ * every kernel writes the same bytes. The SSE4.1 and AVX2 kernels are compiled for those instruction
+ * sets whatever the flags of the build, and only run when the processor has them. This file only
+ * depends on the standard library.
+ */
+
+namespace SpriteBlitter
+{
+
+/**
+ * @brief Implementation of the blending loop.
+ */
+enum class Kernel
+{
+    Scalar, ///< Two channels per 32-bit operation, runs everywhere.
+    Sse41, ///< Four pixels per operation, x86 with SSE4.1.
+    Avx2, ///< Eight pixels per operation, x86 with AVX2.
+    KernelCount
+};
+
+/**
+ * @brief Checks whether the processor runs a kernel.
+ * @param aKernel Kernel to check.
+ * @return True if the kernel was compiled in and the processor has its instruction set.
+ */
+bool isSupported(Kernel aKernel);
+
+/**
+ * @brief Returns the fastest kernel the processor runs.
+ * @return AVX2, else SSE4.1, else the scalar kernel.
+ */
+Kernel bestKernel();
+
+/**
+ * @brief Returns the name of a kernel, as given on the command line.
+ * @param aKernel Kernel.
+ * @return "scalar", "sse4.1" or "avx2".
+ */
+const char *kernelName(Kernel aKernel);
+
+/**
+ * @brief Finds a kernel by name.
+ * @param aName Name given by kernelName().
+ * @param aKernel Receives the kernel.
+ * @return True if the name is known.
+ */
+bool kernelFromName(std::string_view aName, Kernel &aKernel);
+
+/**
+ * @brief Blends a sprite over a rectangle of the back buffer.
+ *
+ * The rectangle must already be clipped to both images.
+ *
+ * @param aKernel Kernel to run, it must be supported.
+ * @param aDestination First pixel of the rectangle in the back buffer.
+ * @param aDestinationStride Distance between two lines of the back buffer, in pixels.
+ * @param aSource First pixel of the sprite to blend.
+ * @param aSourceStride Distance between two lines of the sprite, in pixels.
+ * @param aWidth Width of the rectangle, in pixels.
+ * @param aHeight Height of the rectangle, in pixels.
+ */
+void blend(Kernel aKernel, uint32_t *aDestination, size_t aDestinationStride, const uint32_t *aSource,
+           size_t aSourceStride, int aWidth, int aHeight);
+
+}
+
+#endif // SPRITEBLITTER_H
@@ -0,0 +1,252 @@
+/**
+ * @file spritepack.cpp
+ * @brief Writing and checking of the sprite pack format.
+ */
+
+#include "spritepack.h"
+#include "levelformat.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+
+namespace SpritePack
+{
+
+namespace
+{
+
+/**
+ * @brief Returns the key the entries are sorted by.
+ * @param anEntry Entry of the table.
+ * @return Path hash, draw size and device pixel ratio.
+ */
+std::tuple<uint32_t, uint16_t, uint16_t, uint16_t> sortKey(const Entry &anEntry)
+{
+    return std::make_tuple(anEntry.pathHash, anEntry.width, anEntry.height, anEntry.ratio);
+}
+
+/**
+ * @brief Computes the hash of a resource path.
+ * @param aPath Resource path.
+ * @return The hash.
+ */
+uint32_t pathHash(std::string_view aPath)
+{
+    return LevelFormat::checksum(reinterpret_cast<const unsigned char *>(aPath.data()), aPath.size());
+}
+
+}
+
+/**
+ * @brief Copies an entry out of the table.
+ * @param anIndex Index of the entry.
+ * @return The entry.
+ */
+Entry View::entry(uint32_t anIndex) const
+{
+    Entry entry;
+    std::memcpy(&entry, data + sizeof(Header) + size_t(anIndex) * sizeof(Entry), sizeof(Entry));
+    return entry;
+}
+
+/**
+ * @brief Looks a frame up.
+ *
+ * The entries are sorted, a binary search finds the first frame of the path at that draw size,
+ * the frames of the other device pixel ratios follow it.
+ *
+ * @param aPath Resource path of the source image.
+ * @param aWidth Draw width, in logical pixels.
+ * @param aHeight Draw height, in logical pixels.
+ * @param aRatio Device pixel ratio, in hundredths.
+ * @param anEntry Receives the entry of the frame.
+ * @return True if the pack has the frame at that draw size.
+ */
+bool View::find(std::string_view aPath, uint16_t aWidth, uint16_t aHeight, uint16_t aRatio, Entry &anEntry) const
+{
+    auto wanted = std::make_tuple(pathHash(aPath), aWidth, aHeight, uint16_t(0));
+    uint32_t first = 0;
+    uint32_t count = header.entryNb;
+    while (count > 0)
+    {
+        uint32_t step = count / 2;
+        if (sortKey(entry(first + step)) < wanted)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    const char *paths = reinterpret_cast<const char *>(data + sizeof(Header) + size_t(header.entryNb) * sizeof(Entry));
+    bool found = false;
+    for (uint32_t index = first; index < header.entryNb; ++index)
+    {
+        Entry candidate = entry(index);
+        if (candidate.pathHash != std::get<0>(wanted) || candidate.width != aWidth || candidate.height != aHeight)
+        {
+            break;
+        }
+        if (std::string_view(paths + candidate.pathOffset, candidate.pathSize) != aPath)
+        {
+            continue;
+        }
+        // The exact ratio wins, otherwise the nearest one
+        if (!found || std::abs(int(candidate.ratio) - int(aRatio)) < std::abs(int(anEntry.ratio) - int(aRatio)))
+        {
+            anEntry = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Writes frames into a sprite pack.
+ * @param someFrames Frames of the pack.
+ * @param aBlob Receives the pack.
+ * @param anError Receives the reason if the frames are refused.
+ * @return True if the pack was written.
+ */
+bool build(const std::vector<Frame> &someFrames, std::vector<unsigned char> &aBlob, std::string &anError)
+{
+    std::vector<Entry> entries;
+    std::string paths;
+    entries.reserve(someFrames.size());
+    for (const Frame &frame : someFrames)
+    {
+        if (frame.path.size() > UINT16_MAX || frame.bytesPerLine < uint32_t(frame.deviceWidth) * 4
+            || frame.pixels.size() != size_t(frame.bytesPerLine) * frame.deviceHeight)
+        {
+            anError = "invalid frame " + frame.path;
+            return false;
+        }
+        Entry entry = {};
+        entry.pathHash = pathHash(frame.path);
+        entry.pathOffset = uint32_t(paths.size());
+        entry.pathSize = uint16_t(frame.path.size());
+        entry.ratio = frame.ratio;
+        entry.width = frame.width;
+        entry.height = frame.height;
+        entry.deviceWidth = frame.deviceWidth;
+        entry.deviceHeight = frame.deviceHeight;
+        entry.bytesPerLine = frame.bytesPerLine;
+        entry.sourceBytes = frame.sourceBytes;
+        entries.push_back(entry);
+        paths += frame.path;
+    }
+
+    // The entries are sorted for the lookup, the frames keep their order in the file
+    std::vector<uint32_t> order(entries.size());
+    for (uint32_t index = 0; index < order.size(); ++index)
+    {
+        order[index] = index;
+    }
+    std::stable_sort(order.begin(), order.end(), [&entries](uint32_t aLeft, uint32_t aRight)
+    {
+        return sortKey(entries[aLeft]) < sortKey(entries[aRight]);
+    });
+    for (size_t index = 1; index < order.size(); ++index)
+    {
+        const Frame &previous = someFrames[order[index - 1]];
+        const Frame &current = someFrames[order[index]];
+        if (sortKey(entries[order[index - 1]]) == sortKey(entries[order[index]]) && previous.path == current.path)
+        {
+            anError = "frame " + current.path + " packed twice at the same size";
+            return false;
+        }
+    }
+
+    uint64_t offset = sizeof(Header) + entries.size() * sizeof(Entry) + paths.size();
+    for (size_t index = 0; index < entries.size(); ++index)
+    {
+        offset = (offset + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+        entries[index].offset = offset;
+        offset += someFrames[index].pixels.size();
+    }
+
+    aBlob.assign(size_t(offset), 0);
+    unsigned char *table = aBlob.data() + sizeof(Header);
+    for (size_t index = 0; index < order.size(); ++index)
+    {
+        std::memcpy(table + index * sizeof(Entry), &entries[order[index]], sizeof(Entry));
+    }
+    std::memcpy(table + entries.size() * sizeof(Entry), paths.data(), paths.size());
+    for (size_t index = 0; index < entries.size(); ++index)
+    {
+        const std::vector<unsigned char> &pixels = someFrames[index].pixels;
+        std::copy(pixels.begin(), pixels.end(), aBlob.begin() + std::ptrdiff_t(entries[index].offset));
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entrySize = sizeof(Entry);
+    header.entryNb = uint32_t(entries.size());
+    header.pathSize = uint32_t(paths.size());
+    header.checksum = LevelFormat::checksum(table, entries.size() * sizeof(Entry) + paths.size());
+    std::memcpy(aBlob.data(), &header, sizeof(Header));
+    return true;
+}
+
+/**
+ * @brief Checks a sprite pack and makes a view on it.
+ * @param someData Sprite pack.
+ * @param aSize Size of the sprite pack, in bytes.
+ * @param aView Receives the view, valid as long as someData is.
+ * @param anError Receives the reason if the pack is refused.
+ * @return True if the pack is valid.
+ */
+bool open(const unsigned char *someData, size_t aSize, View &aView, std::string &anError)
+{
+    if (someData == nullptr || aSize < sizeof(Header))
+    {
+        anError = "file too short for a header";
+        return false;
+    }
+
+    Header &header = aView.header;
+    std::memcpy(&header, someData, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        anError = "not a sprite pack";
+        return false;
+    }
+    if (header.version != VERSION || header.entrySize != sizeof(Entry))
+    {
+        anError = "unsupported version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION);
+        return false;
+    }
+
+    uint64_t tableSize = uint64_t(header.entryNb) * sizeof(Entry) + header.pathSize;
+    if (sizeof(Header) + tableSize > aSize)
+    {
+        anError = "size is " + std::to_string(aSize) + " bytes, too short for " + std::to_string(header.entryNb) + " frames";
+        return false;
+    }
+    if (LevelFormat::checksum(someData + sizeof(Header), size_t(tableSize)) != header.checksum)
+    {
+        anError = "checksum mismatch";
+        return false;
+    }
+
+    aView.data = someData;
+    for (uint32_t index = 0; index < header.entryNb; ++index)
+    {
+        Entry entry = aView.entry(index);
+        if (uint64_t(entry.pathOffset) + entry.pathSize > header.pathSize
+            || entry.bytesPerLine < uint32_t(entry.deviceWidth) * 4 || entry.offset % 4 != 0
+            || entry.offset + uint64_t(entry.bytesPerLine) * entry.deviceHeight > aSize)
+        {
+            anError = "invalid frame " + std::to_string(index);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
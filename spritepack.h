@@ -0,0 +1,138 @@
+#ifndef SPRITEPACK_H
+#define SPRITEPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file spritepack.h
+ * @brief Sprite pack format, shared by the game and the asset packer.
+ *
+ * A sprite pack (.npak) holds sprite frames already decoded and scaled to the size they are drawn
+ * at, as premultiplied 32-bit ARGB pixels laid out like QImage::Format_ARGB32_Premultiplied.
+ * The file is a header, a table of frame entries sorted by path hash, draw size and device pixel
+ * ratio, the UTF-8 resource paths of the frames, then the pixels. Every frame starts on a
+ * FRAME_ALIGNMENT boundary, so the game can memory-map the pack and wrap the frames in images
+ * without copying nor decoding them. Every field is little-endian, and the checksum covers the
+ * table and the paths, with LevelFormat::checksum(). This file only depends on the standard library.
+ */
+
+namespace SpritePack
+{
+
+const char MAGIC[4] = {'N', 'S', 'P', 'K'}; ///< First bytes of every sprite pack.
+const uint16_t VERSION = 1; ///< Version of the format, bumped on any layout change.
+const uint32_t FRAME_ALIGNMENT = 64; ///< Alignment of the pixels of each frame in the file.
+
+/**
+ * @brief Header at the start of a sprite pack.
+ */
+struct Header
+{
+    char magic[4]; ///< Always MAGIC.
+    uint16_t version; ///< Always VERSION.
+    uint16_t entrySize; ///< Size of an entry, in bytes.
+    uint32_t entryNb; ///< Number of frames.
+    uint32_t pathSize; ///< Size of the path block, in bytes.
+    uint32_t checksum; ///< FNV-1a hash of the entries and the path block.
+    uint32_t reserved; ///< Always zero.
+};
+
+/**
+ * @brief Frame of a sprite pack.
+ */
+struct Entry
+{
+    uint32_t pathHash; ///< FNV-1a hash of the resource path.
+    uint32_t pathOffset; ///< Offset of the resource path in the path block.
+    uint16_t pathSize; ///< Size of the resource path, in bytes.
+    uint16_t ratio; ///< Device pixel ratio the frame is scaled for, in hundredths.
+    uint16_t width; ///< Draw width, in logical pixels.
+    uint16_t height; ///< Draw height, in logical pixels.
+    uint16_t deviceWidth; ///< Width of the frame, in pixels.
+    uint16_t deviceHeight; ///< Height of the frame, in pixels.
+    uint32_t bytesPerLine; ///< Size of a line of pixels, in bytes.
+    uint32_t sourceBytes; ///< Size of the source image once decoded at full size.
+    uint32_t reserved; ///< Always zero.
+    uint64_t offset; ///< Offset of the pixels in the file.
+};
+
+static_assert(sizeof(Header) == 24, "The header layout is part of the file format");
+static_assert(sizeof(Entry) == 40, "The entry layout is part of the file format");
+
+/**
+ * @brief Frame given to build(), with its pixels.
+ */
+struct Frame
+{
+    std::string path; ///< Resource path of the source image.
+    uint16_t ratio = 100; ///< Device pixel ratio the frame is scaled for, in hundredths.
+    uint16_t width = 0; ///< Draw width, in logical pixels.
+    uint16_t height = 0; ///< Draw height, in logical pixels.
+    uint16_t deviceWidth = 0; ///< Width of the frame, in pixels.
+    uint16_t deviceHeight = 0; ///< Height of the frame, in pixels.
+    uint32_t bytesPerLine = 0; ///< Size of a line of pixels, in bytes.
+    uint32_t sourceBytes = 0; ///< Size of the source image once decoded at full size.
+    std::vector<unsigned char> pixels; ///< deviceHeight lines of bytesPerLine bytes.
+};
+
+/**
+ * @brief Read-only view on a sprite pack, pointing into the caller's memory.
+ */
+struct View
+{
+    Header header; ///< Copy of the header.
+    const unsigned char *data = nullptr; ///< Start of the pack.
+
+    /**
+     * @brief Copies an entry out of the table.
+     *
+     * @param anIndex Index of the entry, lower than header.entryNb
+     * @return The entry
+     */
+    Entry entry(uint32_t anIndex) const;
+
+    /**
+     * @brief Looks a frame up.
+     *
+     * The frame scaled for the nearest device pixel ratio is returned when the pack has none for aRatio.
+     *
+     * @param aPath Resource path of the source image
+     * @param aWidth Draw width, in logical pixels
+     * @param aHeight Draw height, in logical pixels
+     * @param aRatio Device pixel ratio, in hundredths
+     * @param anEntry Receives the entry of the frame
+     * @return True if the pack has the frame at that draw size
+     */
+    bool find(std::string_view aPath, uint16_t aWidth, uint16_t aHeight, uint16_t aRatio, Entry &anEntry) const;
+};
+
+/**
+ * @brief Writes frames into a sprite pack.
+ *
+ * @param someFrames Frames of the pack, a frame is refused if another one has the same path, size and ratio
+ * @param aBlob Receives the pack
+ * @param anError Receives the reason if the frames are refused
+ * @return True if the pack was written
+ */
+bool build(const std::vector<Frame> &someFrames, std::vector<unsigned char> &aBlob, std::string &anError);
+
+/**
+ * @brief Checks a sprite pack and makes a view on it.
+ *
+ * The table and the bounds of every frame are checked, the pixels are not read.
+ *
+ * @param someData Sprite pack
+ * @param aSize Size of the sprite pack, in bytes
+ * @param aView Receives the view, valid as long as someData is
+ * @param anError Receives the reason if the pack is refused
+ * @return True if the pack is valid
+ */
+bool open(const unsigned char *someData, size_t aSize, View &aView, std::string &anError);
+
+}
+
+#endif // SPRITEPACK_H
@@ -0,0 +1,338 @@
+#ifndef SPRITEREGISTRY_H
+#define SPRITEREGISTRY_H
+
+#include <QStringView>
+
+/**
+ * @file spriteregistry.h
+ * @brief Compile-time registry of the sprites: identifiers, sources and animation tables.
+ *
+ * Every sprite has an integer identifier that indexes a flat pixmap array, and the
+ * animations are constexpr tables of identifiers. Picking a frame is an array lookup,
+ * with no string built nor map searched while drawing.
+ */
+
+/**
+ * @brief Era of a level, given by its "ws", "cs" or "nt" line.
+ */
+enum class Era : unsigned char
+{
+    MiddleAge,  ///< "ws" levels
+    ModernTime, ///< "cs" levels
+    Futurist,   ///< "nt" levels
+    None        ///< Levels without era line, the boss levels
+};
+
+/// Number of real eras, Era::None excluded
+constexpr int ERA_COUNT = 3;
+
+/**
+ * @brief Kind of a ShortScope enemy, as numbered in the level files.
+ */
+enum class EnemyKind : unsigned char
+{
+    Primary = 1,  ///< Skeleton, soldier or nautilus depending on the era
+    Secondary = 2 ///< Wolf, canon or turret depending on the era
+};
+
+/// Number of enemy kinds
+constexpr int ENEMY_KIND_COUNT = 2;
+
+/**
+ * @brief Reads the era code of a level file line.
+ *
+ * @param aCode "ws", "cs" or "nt"
+ * @return The matching era, Era::None for any other code
+ */
+inline Era eraFromCode(QStringView aCode)
+{
+    return aCode == u"ws" ? Era::MiddleAge
+         : aCode == u"cs" ? Era::ModernTime
+         : aCode == u"nt" ? Era::Futurist
+                          : Era::None;
+}
+
+/**
+ * @brief Identifier of every sprite, it is the index of the sprite in the pixmap array.
+ *
+ * The main character slots hold the sprites of the era loaded last, the enemy slots
+ * exist once per era.
+ */
+enum SpriteId : unsigned short
+{
+    MainWalk1, MainWalk2, MainWalk3,
+    MainWalk1Reversed, MainWalk2Reversed, MainWalk3Reversed,
+    MainAttack1, MainAttack2, MainAttack3,
+    MainAttack1Reversed, MainAttack2Reversed, MainAttack3Reversed,
+    MainDead,
+
+    SkeletonWalk1, SkeletonWalk2, SkeletonWalk3,
+    SkeletonWalk1Reversed, SkeletonWalk2Reversed, SkeletonWalk3Reversed,
+    WolfWalk1, WolfWalk2, WolfWalk3,
+    WolfWalk1Reversed, WolfWalk2Reversed, WolfWalk3Reversed,
+    SoldierWalk1, SoldierWalk2, SoldierWalk3,
+    SoldierWalk1Reversed, SoldierWalk2Reversed, SoldierWalk3Reversed,
+    CanonWalk1, CanonWalk2, CanonWalk3,
+    CanonWalk1Reversed, CanonWalk2Reversed, CanonWalk3Reversed,
+    NautilusWalk1, NautilusWalk2, NautilusWalk3,
+    NautilusWalk1Reversed, NautilusWalk2Reversed, NautilusWalk3Reversed,
+    TurretWalk1, TurretWalk2, TurretWalk3,
+    TurretWalk1Reversed, TurretWalk2Reversed, TurretWalk3Reversed,
+
+    CompanionWalk1, CompanionWalk2,
+    CompanionWalk1Reversed, CompanionWalk2Reversed,
+
+    Chevalry, ChevalryDead, SwordVertical, SwordHorizontal,
+    GhostFly1Reversed, GhostFly2Reversed, GhostDead,
+    LittleFantomeWalk1, LittleFantomeWalk2,
+
+    AsteriosWalk1, AsteriosWalk2,
+    AsteriosWalk1Reversed, AsteriosWalk2Reversed,
+    AsteriosArmorWalk1, AsteriosArmorWalk2,
+    AsteriosArmorWalk1Reversed, AsteriosArmorWalk2Reversed,
+
+    PieceSprite, Victory, TextBackground,
+
+    Lvl0Object1, Lvl0Object2, Lvl0Object3,
+    Lvl1Object1, Lvl1Object2, Lvl1Object3,
+    Lvl2Object1, Lvl2Object2, Lvl2Object3,
+    Lvl3Object1, Lvl3Object2, Lvl3Object3,
+
+    Door1, Door2, Door3, Portal1, Portal2,
+
+    SpriteCount,
+    NoSprite = SpriteCount ///< Draws nothing
+};
+
+/**
+ * @brief Size a sprite is pre-scaled to, resolved from the level file when loading.
+ */
+enum SpriteSize : unsigned char
+{
+    MainSize,
+    CompanionSize,
+    Enemy1Size,
+    Enemy2Size,
+    BossSize,
+    FinalBossSize,
+    SummoningSize,
+    PieceSize,
+    ObjectSize,
+    DoorSize,
+    ScreenSize,
+    TextBackgroundSize,
+    SpriteSizeCount
+};
+
+/**
+ * @brief Resource image of a sprite and the size it is drawn at.
+ */
+struct SpriteSource
+{
+    SpriteId id;        ///< Slot of the sprite
+    SpriteSize size;    ///< Draw size of the sprite
+    const char *path;   ///< Resource path, UTF-8 encoded
+};
+
+/// Number of sprites loaded for each era
+constexpr int ERA_SPRITE_COUNT = 25;
+
+/// Sprites that depend on the era of the level, loaded with it
+constexpr SpriteSource ERA_SPRITES[ERA_COUNT][ERA_SPRITE_COUNT] = {
+    { // Middle age
+        {MainWalk1, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk1.png"},
+        {MainWalk2, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk2.png"},
+        {MainWalk3, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk3.png"},
+        {MainWalk1Reversed, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk1_reversed.png"},
+        {MainWalk2Reversed, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk2_reversed.png"},
+        {MainWalk3Reversed, MainSize, ":/déplacements/assets/nova/nova_middle_age/walk/nova_middle_age_walk3_reversed.png"},
+        {SkeletonWalk1, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk1.png"},
+        {SkeletonWalk2, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk2.png"},
+        {SkeletonWalk3, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk3.png"},
+        {SkeletonWalk1Reversed, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk1_reversed.png"},
+        {SkeletonWalk2Reversed, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk2_reversed.png"},
+        {SkeletonWalk3Reversed, Enemy1Size, ":/déplacements/assets/ennemy/skeleton/skeleton_walk3_reversed.png"},
+        {WolfWalk1, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_1.png"},
+        {WolfWalk2, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_2.png"},
+        {WolfWalk3, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_3.png"},
+        {WolfWalk1Reversed, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_1_reversed.png"},
+        {WolfWalk2Reversed, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_2_reversed.png"},
+        {WolfWalk3Reversed, Enemy2Size, ":/déplacements/assets/ennemy/wicked_wolf/wolf_run_3_reversed.png"},
+        {MainAttack1, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack1.png"},
+        {MainAttack2, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack2.png"},
+        {MainAttack3, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack3.png"},
+        {MainAttack1Reversed, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack1_reversed.png"},
+        {MainAttack2Reversed, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack2_reversed.png"},
+        {MainAttack3Reversed, MainSize, ":/attacks/assets/nova/nova_middle_age/attack/main_sword_attack3_reversed.png"},
+        {MainDead, MainSize, ":/dead/assets/nova/nova_dead.png"},
+    },
+    { // Modern time
+        {MainWalk1, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk1.png"},
+        {MainWalk2, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk2.png"},
+        {MainWalk3, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk3.png"},
+        {MainWalk1Reversed, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk1_reversed.png"},
+        {MainWalk2Reversed, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk2_reversed.png"},
+        {MainWalk3Reversed, MainSize, ":/déplacements/assets/nova/nova_modern_time/walk/nova_modern_time_walk3_reversed.png"},
+        {SoldierWalk1, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_1.png"},
+        {SoldierWalk2, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_2.png"},
+        {SoldierWalk3, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_3.png"},
+        {SoldierWalk1Reversed, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_1_reversed.png"},
+        {SoldierWalk2Reversed, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_2_reversed.png"},
+        {SoldierWalk3Reversed, Enemy1Size, ":/déplacements/assets/ennemy/soldier/walk/soldier_walk_3_reversed.png"},
+        {CanonWalk1, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_1.png"},
+        {CanonWalk2, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_2.png"},
+        {CanonWalk3, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_1.png"},
+        {CanonWalk1Reversed, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_1_reversed.png"},
+        {CanonWalk2Reversed, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_2_reversed.png"},
+        {CanonWalk3Reversed, Enemy2Size, ":/déplacements/assets/ennemy/canon/walk/canon_walk_1_reversed.png"},
+        {MainAttack1, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack1.png"},
+        {MainAttack2, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack2.png"},
+        {MainAttack3, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack3.png"},
+        {MainAttack1Reversed, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack1_reversed.png"},
+        {MainAttack2Reversed, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack2_reversed.png"},
+        {MainAttack3Reversed, MainSize, ":/attacks/assets/nova/nova_modern_time/attack/nova_modern_time_attack3_reversed.png"},
+        {MainDead, MainSize, ":/dead/assets/nova/nova_dead.png"},
+    },
+    { // Futurist
+        {MainWalk1, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk1.png"},
+        {MainWalk2, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk2.png"},
+        {MainWalk3, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk3.png"},
+        {MainWalk1Reversed, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk1_reversed.png"},
+        {MainWalk2Reversed, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk2_reversed.png"},
+        {MainWalk3Reversed, MainSize, ":/déplacements/assets/nova/nova_futurist/walk/nova_futurist_walk3_reversed.png"},
+        {NautilusWalk1, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_1.png"},
+        {NautilusWalk2, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_2.png"},
+        {NautilusWalk3, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_3.png"},
+        {NautilusWalk1Reversed, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_1_reversed.png"},
+        {NautilusWalk2Reversed, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_2_reversed.png"},
+        {NautilusWalk3Reversed, Enemy1Size, ":/déplacements/assets/ennemy/nautilus/walk/nautilus_walk_3_reversed.png"},
+        {TurretWalk1, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk1_reversed.png"},
+        {TurretWalk2, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk2_reversed.png"},
+        {TurretWalk3, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk3_reversed.png"},
+        {TurretWalk1Reversed, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk1.png"},
+        {TurretWalk2Reversed, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk2.png"},
+        {TurretWalk3Reversed, Enemy2Size, ":/déplacements/assets/ennemy/turret/walk/turret_walk3.png"},
+        {MainAttack1, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png"},
+        {MainAttack2, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png"},
+        {MainAttack3, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1.png"},
+        {MainAttack1Reversed, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack1_reversed.png"},
+        {MainAttack2Reversed, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack2_reversed.png"},
+        {MainAttack3Reversed, MainSize, ":/attacks/assets/nova/nova_futurist/attack/nova_futurist_attack3_reversed.png"},
+        {MainDead, MainSize, ":/dead/assets/nova/nova_dead.png"},
+    },
+};
+
+/// Sprites shared by every level
+constexpr SpriteSource COMMON_SPRITES[] = {
+    {CompanionWalk1, CompanionSize, ":/déplacements/assets/sparkle/sparke_fly_1.png"},
+    {CompanionWalk2, CompanionSize, ":/déplacements/assets/sparkle/sparkle_fly_2.png"},
+    {CompanionWalk1Reversed, CompanionSize, ":/déplacements/assets/sparkle/sparkle_fly_1_reversed.png"},
+    {CompanionWalk2Reversed, CompanionSize, ":/déplacements/assets/sparkle/sparkle_fly_2_reversed.png"},
+
+    {Chevalry, BossSize, ":/attacks/assets/ennemy/chevalry/chevalry.png"},
+    {ChevalryDead, BossSize, ":/attacks/assets/ennemy/chevalry/chevalry_dead.png"},
+    {SwordVertical, SummoningSize, ":/attacks/assets/ennemy/chevalry/sword_vertical.png"},
+    {SwordHorizontal, SummoningSize, ":/attacks/assets/ennemy/chevalry/sword_horizontal.png"},
+    {GhostFly1Reversed, BossSize, ":/déplacements/assets/ennemy/ghost/ghost_fly_1_reversed.png"},
+    {GhostDead, BossSize, ":/déplacements/assets/ennemy/ghost/ghost_dead.png"},
+    {GhostFly2Reversed, BossSize, ":/déplacements/assets/ennemy/ghost/ghost_fly_2_reversed.png"},
+    {LittleFantomeWalk1, SummoningSize, ":/déplacements/assets/ennemy/ghost/little_fantome_walk_1.png"},
+    {LittleFantomeWalk2, SummoningSize, ":/déplacements/assets/ennemy/ghost/little_fantome_walk_2.png"},
+
+    {AsteriosWalk1, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_walk2.png"},
+    {AsteriosWalk2, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_walk3.png"},
+    {AsteriosWalk1Reversed, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_walk2_reversed.png"},
+    {AsteriosWalk2Reversed, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_walk3_reversed.png"},
+    {AsteriosArmorWalk1, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_with_armor_walk2.png"},
+    {AsteriosArmorWalk2, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_with_armor_walk3.png"},
+    {AsteriosArmorWalk1Reversed, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_with_armor_walk2_reversed.png"},
+    {AsteriosArmorWalk2Reversed, FinalBossSize, ":/déplacements/assets/asterios/walk/asterios_with_armor_walk3_reversed.png"},
+
+    {PieceSprite, PieceSize, ":/hud/assets/hud_elements/piece/piece.png"},
+    {Victory, ScreenSize, ":/hud/assets/game_style/victory.png"},
+    {TextBackground, TextBackgroundSize, ":/menu/assets/game_style/text_background.png"},
+
+    {Lvl0Object1, ObjectSize, ":/object/assets/object/lvl0_object1.png"},
+    {Lvl1Object1, ObjectSize, ":/object/assets/object/lvl1_object1.png"},
+    {Lvl1Object2, ObjectSize, ":/object/assets/object/lvl1_object2.png"},
+    {Lvl1Object3, ObjectSize, ":/object/assets/object/lvl1_object3.png"},
+    {Lvl2Object1, ObjectSize, ":/object/assets/object/lvl2_object1.png"},
+    {Lvl2Object2, ObjectSize, ":/object/assets/object/lvl2_object2.png"},
+    {Lvl2Object3, ObjectSize, ":/object/assets/object/lvl2_object3.png"},
+    {Lvl3Object1, ObjectSize, ":/object/assets/object/lvl3_object1.png"},
+    {Lvl3Object2, ObjectSize, ":/object/assets/object/lvl3_object2.png"},
+    {Lvl3Object3, ObjectSize, ":/object/assets/object/lvl3_object3.png"},
+
+    {Door1, DoorSize, ":/door/assets/door/door1.png"},
+    {Door2, DoorSize, ":/door/assets/door/door2.png"},
+    {Door3, DoorSize, ":/door/assets/door/door3.png"},
+    {Portal1, DoorSize, ":/portal/assets/portal/portail1.png"},
+    {Portal2, DoorSize, ":/portal/assets/portal/portail2.png"},
+};
+
+/// Walk of the main character, by [reversed][frame]
+constexpr SpriteId MAIN_WALK[2][3] = {
+    {MainWalk1, MainWalk2, MainWalk3},
+    {MainWalk1Reversed, MainWalk2Reversed, MainWalk3Reversed},
+};
+
+/// Sword attack of the main character, by frame, the last frame draws nothing
+constexpr SpriteId MAIN_ATTACK[4] = {MainAttack1, MainAttack2, MainAttack3, NoSprite};
+
+/// Sword attack of the main character facing left, by frame
+constexpr SpriteId MAIN_ATTACK_REVERSED[3] = {MainAttack1Reversed, MainAttack2Reversed, MainAttack3Reversed};
+
+/// Walk of the enemies, by [era][kind - 1][reversed][frame]
+constexpr SpriteId ENEMY_WALK[ERA_COUNT][ENEMY_KIND_COUNT][2][3] = {
+    {
+        {{SkeletonWalk1, SkeletonWalk2, SkeletonWalk3}, {SkeletonWalk1Reversed, SkeletonWalk2Reversed, SkeletonWalk3Reversed}},
+        {{WolfWalk1, WolfWalk2, WolfWalk3}, {WolfWalk1Reversed, WolfWalk2Reversed, WolfWalk3Reversed}},
+    },
+    {
+        {{SoldierWalk1, SoldierWalk2, SoldierWalk3}, {SoldierWalk1Reversed, SoldierWalk2Reversed, SoldierWalk3Reversed}},
+        {{CanonWalk1, CanonWalk2, CanonWalk3}, {CanonWalk1Reversed, CanonWalk2Reversed, CanonWalk3Reversed}},
+    },
+    {
+        {{NautilusWalk1, NautilusWalk2, NautilusWalk3}, {NautilusWalk1Reversed, NautilusWalk2Reversed, NautilusWalk3Reversed}},
+        {{TurretWalk1, TurretWalk2, TurretWalk3}, {TurretWalk1Reversed, TurretWalk2Reversed, TurretWalk3Reversed}},
+    },
+};
+
+/// Whether the enemy sprites of an era are drawn reversed when getPreviousDirection() is true
+constexpr bool ENEMY_REVERSED_ON_PREVIOUS_DIRECTION[ERA_COUNT] = {false, true, false};
+
+/// Flight of the companion, by [reversed][frame]
+constexpr SpriteId COMPANION_WALK[2][2] = {
+    {CompanionWalk1, CompanionWalk2},
+    {CompanionWalk1Reversed, CompanionWalk2Reversed},
+};
+
+/// Walk of the final boss, by [armored][reversed][frame]
+constexpr SpriteId ASTERIOS_WALK[2][2][2] = {
+    {{AsteriosWalk1, AsteriosWalk2}, {AsteriosWalk1Reversed, AsteriosWalk2Reversed}},
+    {{AsteriosArmorWalk1, AsteriosArmorWalk2}, {AsteriosArmorWalk1Reversed, AsteriosArmorWalk2Reversed}},
+};
+
+/// Flight of the ghost boss, by frame
+constexpr SpriteId GHOST_FLY[2] = {GhostFly2Reversed, GhostFly1Reversed};
+
+/// Walk of the little ghosts summoned by the ghost boss, by frame
+constexpr SpriteId LITTLE_FANTOME_WALK[2] = {LittleFantomeWalk2, LittleFantomeWalk1};
+
+/**
+ * @brief Returns the sprite of a flashback object.
+ *
+ * @param aHUDNb Level number shown in the HUD, from 0 to 3
+ * @param aObjectNb Number of the object in its level, from 1 to 3
+ * @return The sprite of the object, or NoSprite if there is none
+ */
+constexpr SpriteId flashbackObjectSprite(int aHUDNb, int aObjectNb)
+{
+    return (aHUDNb < 0 || aHUDNb > 3 || aObjectNb < 1 || aObjectNb > 3)
+               ? NoSprite
+               : static_cast<SpriteId>(Lvl0Object1 + aHUDNb * 3 + aObjectNb - 1);
+}
+
+static_assert(flashbackObjectSprite(3, 3) == Lvl3Object3, "Flashback object sprites must be contiguous");
+
+#endif // SPRITEREGISTRY_H
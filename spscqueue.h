@@ -0,0 +1,83 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file spscqueue.h
+ * @brief Lock-free bounded queue from one producer thread to one consumer thread.
+ *
+ * The items live in a ring of fixed capacity, the producer only writes the tail index and the
+ * consumer only writes the head index, so neither side ever waits for the other. The indexes
+ * are on separate cache lines, pushing does not invalidate the line the consumer polls. This
+ * file only depends on the standard library.
+ */
+
+/**
+ * @brief Single-producer single-consumer ring of items of type T.
+ *
+ * @tparam T Type of the items, copied in and out
+ * @tparam Capacity Number of items the ring holds, a power of two
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+    static constexpr std::size_t INDEX_MASK = Capacity - 1; /**< Turns an index into a position in the ring. */
+
+    T itsItems[Capacity]; /**< Ring of items. */
+    alignas(64) std::atomic<std::size_t> itsHead{0}; /**< Index of the next item to pop, written by the consumer. */
+    alignas(64) std::atomic<std::size_t> itsTail{0}; /**< Index of the next item to push, written by the producer. */
+
+public:
+    /**
+     * @brief Adds an item at the end of the queue, only called by the producer.
+     *
+     * @param anItem Item to add
+     * @return False if the queue is full, the item is then dropped
+     */
+    bool push(const T &anItem)
+    {
+        std::size_t tail = itsTail.load(std::memory_order_relaxed);
+        if (tail - itsHead.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        itsItems[tail & INDEX_MASK] = anItem;
+        itsTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the item at the front of the queue, only called by the consumer.
+     *
+     * @param anItem Receives the item
+     * @return False if the queue is empty
+     */
+    bool pop(T &anItem)
+    {
+        std::size_t head = itsHead.load(std::memory_order_relaxed);
+        if (head == itsTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        anItem = itsItems[head & INDEX_MASK];
+        itsHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the queue holds no item.
+     *
+     * The answer may be outdated as soon as it is returned if the other thread is active.
+     *
+     * @return True if the queue is empty
+     */
+    bool isEmpty() const
+    {
+        return itsHead.load(std::memory_order_acquire) == itsTail.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSCQUEUE_H
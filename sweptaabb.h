@@ -0,0 +1,33 @@
+#ifndef SWEPTAABB_H
+#define SWEPTAABB_H
+
+#include <QRect>
+
+/**
+ * @brief The SweepHit struct describes the first contact of a moving rectangle with a fixed one.
+ */
+struct SweepHit
+{
+    double itsTime = 1.0; /**< Fraction of the move done at the contact, between 0 and 1. */
+    int itsNormalX = 0; /**< X component of the contact normal, -1, 0 or 1. */
+    int itsNormalY = 0; /**< Y component of the contact normal, -1, 0 or 1. */
+    int itsDistance = 0; /**< Pixels left to travel along the normal axis before the contact. */
+};
+
+/**
+ * @brief Sweeps a moving rectangle against a fixed one.
+ *
+ * The test is done on the slab entry and exit times of both axes, so its cost does not
+ * depend on the speed. A rectangle touching the fixed one and moving into it is hit at
+ * time 0. A rectangle already overlapping the fixed one is not hit, so that it can leave it.
+ *
+ * @param aMoving Rectangle at the start of the move
+ * @param aDx Move along X, in pixels
+ * @param aDy Move along Y, in pixels
+ * @param aFixed Rectangle that blocks the move
+ * @param aHit Filled with the contact when there is one
+ * @return True if the move touches the fixed rectangle before its end
+ */
+bool sweepRect(const QRect &aMoving, int aDx, int aDy, const QRect &aFixed, SweepHit &aHit);
+
+#endif // SWEPTAABB_H
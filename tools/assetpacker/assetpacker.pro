@@ -0,0 +1,22 @@
+# Command line packer of the sprites into the pre-scaled sprite pack the game maps
+TEMPLATE = app
+TARGET = assetpacker
+QT = core gui concurrent
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../assetmanager.cpp \
+    ../../atlaspacker.cpp \
+    ../../levelformat.cpp \
+    ../../spritepack.cpp
+
+HEADERS += \
+    ../../assetmanager.h \
+    ../../atlaspacker.h \
+    ../../levelformat.h \
+    ../../spritepack.h \
+    ../../spriteregistry.h
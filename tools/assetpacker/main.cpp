@@ -0,0 +1,259 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of the asset packer.
+ *
+ * Usage: assetpacker [--ratio R]... --qrc <resources.qrc>... <sprites.npak> <level.nlvl>...
+ * Lists the sprites each compiled level loads, at the draw sizes the level gives, decodes and
+ * scales them once for each device pixel ratio, 1 by default, and writes them into a sprite pack.
+ * The resource paths of the sprites are resolved through the .qrc files, the images are read
+ * from the disk, so the packer does not need the resources compiled in.
+ */
+
+#include "assetmanager.h"
+#include "levelformat.h"
+#include "spritepack.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSet>
+#include <QXmlStreamReader>
+#include <iostream>
+
+/**
+ * @brief Reads the files listed by a resource collection file.
+ * @param aPath Path of the .qrc file.
+ * @param someFiles Receives the path on the disk of each resource path.
+ * @return True if the file was read.
+ */
+static bool readQrc(const QString &aPath, QMap<QString, QString> &someFiles)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        std::cerr << "Failed to open " << aPath.toStdString() << std::endl;
+        return false;
+    }
+
+    QDir directory = QFileInfo(aPath).absoluteDir();
+    QXmlStreamReader xml(&file);
+    QString prefix;
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+        {
+            continue;
+        }
+        if (xml.name() == QLatin1String("qresource"))
+        {
+            prefix = xml.attributes().value("prefix").toString();
+            if (!prefix.endsWith('/'))
+            {
+                prefix += '/';
+            }
+        }
+        else if (xml.name() == QLatin1String("file"))
+        {
+            QString alias = xml.attributes().value("alias").toString();
+            QString name = xml.readElementText();
+            someFiles.insert(":" + prefix + (alias.isEmpty() ? name : alias), directory.filePath(name));
+        }
+    }
+    if (xml.hasError())
+    {
+        std::cerr << aPath.toStdString() << ":" << xml.lineNumber() << ": " << xml.errorString().toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lists the sprites a compiled level loads, at the draw sizes it gives.
+ *
+ * The era comes from the level file, the boss levels only load the sprites shared by every level.
+ *
+ * @param aPath Path of the compiled level.
+ * @param someSprites Receives the sprites, after the sprites already listed.
+ * @return True if the level was read.
+ */
+static bool levelSprites(const QString &aPath, QVector<SpriteRequest> &someSprites)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        std::cerr << "Failed to open " << aPath.toStdString() << std::endl;
+        return false;
+    }
+    QByteArray blob = file.readAll();
+
+    LevelFormat::View view;
+    std::string error;
+    if (!LevelFormat::open(reinterpret_cast<const unsigned char *>(blob.constData()), size_t(blob.size()), view, error))
+    {
+        std::cerr << aPath.toStdString() << ": " << error << std::endl;
+        return false;
+    }
+
+    QMap<QString, QSize> drawSizes;
+    for (uint32_t index = 0; index < view.header.recordNb; ++index)
+    {
+        LevelFormat::Record record = view.record(index);
+        QString key = QString::fromStdString(LevelFormat::drawSizeKey(record));
+        if (!drawSizes.contains(key))
+        {
+            drawSizes.insert(key, QSize(record.width, record.height));
+        }
+    }
+
+    Era era = view.header.era[0] != '\0' ? eraFromCode(QString::fromLatin1(view.header.era, 2)) : Era::None;
+    QVector<SpriteRequest> eraSprites;
+    AssetManager::spriteRequests(drawSizes, era, eraSprites, someSprites);
+    someSprites += eraSprites;
+    return true;
+}
+
+/**
+ * @brief Main function of the asset packer.
+ * @param argc Number of arguments passed to the program.
+ * @param argv Array of arguments passed to the program.
+ * @return 0 if the pack was written, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    // The asset manager holds pixmaps, which need an application object even when null
+    QCoreApplication application(argc, argv);
+    QVector<qreal> ratios;
+    QMap<QString, QString> files;
+    QStringList positional;
+    for (int index = 1; index < argc; ++index)
+    {
+        QString argument = QString::fromLocal8Bit(argv[index]);
+        if ((argument == "--ratio" || argument == "--qrc") && index + 1 < argc)
+        {
+            QString value = QString::fromLocal8Bit(argv[++index]);
+            if (argument == "--ratio")
+            {
+                ratios.append(value.toDouble());
+            }
+            else if (!readQrc(value, files))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            positional.append(argument);
+        }
+    }
+
+    if (positional.size() < 2 || files.isEmpty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--ratio R]... --qrc <resources.qrc>... <sprites.npak> <level.nlvl>..." << std::endl;
+        return 1;
+    }
+    if (ratios.isEmpty())
+    {
+        ratios.append(1.0);
+    }
+
+    // The levels share most of their sprites, each path and draw size is packed once
+    QVector<SpriteRequest> sprites;
+    for (int index = 1; index < positional.size(); ++index)
+    {
+        QVector<SpriteRequest> levelRequests;
+        if (!levelSprites(positional.at(index), levelRequests))
+        {
+            return 1;
+        }
+        sprites += levelRequests;
+    }
+
+    // Each path and draw size is packed once per ratio, the images are decoded in parallel
+    AssetManager loader;
+    QElapsedTimer clock;
+    clock.start();
+    qint64 cpuNs = 0;
+    std::vector<SpritePack::Frame> frames;
+    qint64 sourceFileBytes = 0;
+    QSet<QString> sourceFiles;
+    for (qreal ratio : ratios)
+    {
+        QSet<QString> packed;
+        QVector<SpriteRequest> requests;
+        QStringList resourcePaths;
+        for (const SpriteRequest &sprite : sprites)
+        {
+            QString key = QString("%1@%2x%3").arg(sprite.path).arg(sprite.size.width()).arg(sprite.size.height());
+            if (packed.contains(key))
+            {
+                continue;
+            }
+            packed.insert(key);
+
+            QString file = files.value(sprite.path);
+            if (file.isEmpty())
+            {
+                std::cerr << "Warning: " << sprite.path.toStdString() << " is in no resource file, not packed" << std::endl;
+                continue;
+            }
+            SpriteRequest request = sprite;
+            request.path = file;
+            requests.append(request);
+            resourcePaths.append(sprite.path);
+        }
+
+        cpuNs += loader.loadAll(requests, ratio);
+
+        for (int index = 0; index < requests.size(); ++index)
+        {
+            const SpriteRequest &request = requests.at(index);
+            const QImage &image = request.prepared;
+            if (image.isNull() || image.width() > UINT16_MAX || image.height() > UINT16_MAX)
+            {
+                std::cerr << "Warning: " << request.path.toStdString() << " cannot be packed" << std::endl;
+                continue;
+            }
+            if (!sourceFiles.contains(request.path))
+            {
+                sourceFiles.insert(request.path);
+                sourceFileBytes += QFileInfo(request.path).size();
+            }
+
+            SpritePack::Frame frame;
+            frame.path = resourcePaths.at(index).toStdString();
+            frame.ratio = uint16_t(qRound(ratio * 100));
+            frame.width = uint16_t(request.size.width());
+            frame.height = uint16_t(request.size.height());
+            frame.deviceWidth = uint16_t(image.width());
+            frame.deviceHeight = uint16_t(image.height());
+            frame.bytesPerLine = uint32_t(image.bytesPerLine());
+            frame.sourceBytes = uint32_t(request.sourceBytes);
+            frame.pixels.assign(image.constBits(), image.constBits() + image.sizeInBytes());
+            frames.push_back(std::move(frame));
+        }
+    }
+    qint64 wallMs = clock.elapsed();
+
+    std::vector<unsigned char> blob;
+    std::string error;
+    if (!SpritePack::build(frames, blob, error))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    QFile output(positional.first());
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || output.write(reinterpret_cast<const char *>(blob.data()), qint64(blob.size())) != qint64(blob.size()))
+    {
+        std::cerr << "Failed to write " << positional.first().toStdString() << std::endl;
+        return 1;
+    }
+
+    std::cout << positional.first().toStdString() << ": " << frames.size() << " frames, " << blob.size() << " bytes, from "
+              << sourceFiles.size() << " images of " << sourceFileBytes << " bytes decoded in " << wallMs << " ms of wall time for "
+              << cpuNs / 1000000 << " ms of CPU time" << std::endl;
+    return 0;
+}
@@ -0,0 +1,14 @@
+# Command line compiler of the text levels into the binary level format
+TEMPLATE = app
+TARGET = levelcompiler
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../levelformat.cpp
+
+HEADERS += \
+    ../../levelformat.h
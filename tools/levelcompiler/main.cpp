@@ -0,0 +1,126 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of the level compiler.
+ *
+ * Usage: levelcompiler <level.txt> <level.nlvl>
+ * Compiles a text level into the binary format loaded by the game, and checks the result.
+ *
+ * Usage: levelcompiler --bench [record number]
+ * Generates a text level with the given number of records, 100000 by default, and times
+ * its compilation and the check of the result.
+ */
+
+#include "levelformat.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief Times the compilation of a generated level.
+ * @param aRecordNb Number of records of the level.
+ * @return 0 if the level was compiled, 1 otherwise.
+ */
+static int bench(long aRecordNb)
+{
+    // Obstacles, enemies and pieces, with a prefab placed every 100 records
+    std::string text = "ws\nMainCharacter,100,400,100,115\nCompanion,75,500,50,65\nPrefab,stairs\n"
+                       "Obstacle,0,600,200,20\nObstacle,200,550,200,20\nObstacle,400,500,200,20\nEnd\n";
+    long recordNb = 2;
+    for (long index = 0; recordNb < aRecordNb; ++index)
+    {
+        long x = index * 97 % 1000000;
+        if (index % 100 == 99)
+        {
+            text += "Place,stairs," + std::to_string(x) + ",0\n";
+            recordNb += 3;
+            continue;
+        }
+        switch (index % 4)
+        {
+        case 0:
+        case 1:
+            text += "Obstacle," + std::to_string(x) + ",619,1545,10\n";
+            break;
+        case 2:
+            text += "Enemy," + std::to_string(x) + ",534,100,85,2\n";
+            break;
+        default:
+            text += "Piece," + std::to_string(x) + ",500,40,40\n";
+            break;
+        }
+        recordNb++;
+    }
+
+    const int runNb = 10;
+    double bestMs = 0;
+    std::vector<unsigned char> blob;
+    std::string error;
+    LevelFormat::View view;
+    for (int run = 0; run < runNb; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!LevelFormat::compile(text, "bench", blob, error) || !LevelFormat::open(blob.data(), blob.size(), view, error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        bestMs = run == 0 ? ms : std::min(bestMs, ms);
+    }
+
+    std::cout << view.header.recordNb << " records, " << text.size() / 1024 << " KB of text: best of " << runNb
+              << " runs " << bestMs << " ms (" << long(view.header.recordNb / (bestMs / 1000)) << " records/s)" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Main function of the level compiler.
+ * @param argc Number of arguments passed to the program.
+ * @param argv Array of arguments passed to the program.
+ * @return 0 if the level was compiled, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && std::string(argv[1]) == "--bench")
+    {
+        return bench(argc >= 3 ? std::atol(argv[2]) : 100000);
+    }
+
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <level.txt> <level.nlvl>" << std::endl
+                  << "       " << argv[0] << " --bench [record number]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input)
+    {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::vector<unsigned char> blob;
+    std::string error;
+    LevelFormat::View view;
+    if (!LevelFormat::compile(text, argv[1], blob, error) || !LevelFormat::open(blob.data(), blob.size(), view, error))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char *>(blob.data()), std::streamsize(blob.size()));
+    if (!output)
+    {
+        std::cerr << "Failed to write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << argv[2] << ": " << view.header.recordNb << " entities, " << blob.size() << " bytes" << std::endl;
+    return 0;
+}
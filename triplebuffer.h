@@ -0,0 +1,85 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @file triplebuffer.h
+ * @brief Lock-free hand-off of the latest value from a writer thread to a reader thread.
+ *
+ * The buffer holds three values: the writer fills the back one, the reader reads the front one,
+ * and the third is exchanged between them with one atomic operation. Publishing swaps the back
+ * value with the middle one, updating swaps the front value with the middle one if a newer value
+ * was published. Neither side ever waits for the other, and a value published while the reader
+ * still reads the previous one is not lost unless a newer value replaces it. The values are
+ * reused: the writer finds in back() a value published two times ago, which it must overwrite
+ * entirely, and the containers it holds keep their capacity. This file only depends on the
+ * standard library.
+ */
+
+/**
+ * @brief Triple buffer of values of type T, for one writer thread and one reader thread.
+ *
+ * Several threads may write in turn if they are serialized by a lock, the same goes for readers.
+ */
+template <typename T>
+class TripleBuffer
+{
+    static constexpr int INDEX_MASK = 3; /**< Bits of itsMiddle holding the index of the middle value. */
+    static constexpr int FRESH = 4; /**< Bit of itsMiddle set when the middle value was published and not read yet. */
+
+    T itsValues[3]; /**< Back, middle and front values, in an order given by the indexes. */
+    std::atomic<int> itsMiddle{1}; /**< Index of the middle value, with the FRESH bit. */
+    int itsBack = 0; /**< Index of the value being written, only used by the writer. */
+    int itsFront = 2; /**< Index of the value being read, only used by the reader. */
+
+public:
+    /**
+     * @brief Returns the value to write, only called by the writer.
+     *
+     * @return Value published two times ago, or a default value
+     */
+    T &back()
+    {
+        return itsValues[itsBack];
+    }
+
+    /**
+     * @brief Publishes the back value, only called by the writer.
+     *
+     * The release makes everything written in the value visible to the reader that takes it.
+     */
+    void publish()
+    {
+        itsBack = itsMiddle.exchange(itsBack | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Takes the last value published, if the reader does not already have it.
+     *
+     * The value returned by front() before the call must not be used after it.
+     *
+     * @return True if front() now returns a newer value
+     */
+    bool update()
+    {
+        if ((itsMiddle.load(std::memory_order_relaxed) & FRESH) == 0)
+        {
+            return false;
+        }
+        itsFront = itsMiddle.exchange(itsFront, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Returns the value being read, only called by the reader.
+     *
+     * @return Last value taken by update(), or a default value
+     */
+    const T &front() const
+    {
+        return itsValues[itsFront];
+    }
+};
+
+#endif // TRIPLEBUFFER_H
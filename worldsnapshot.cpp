@@ -0,0 +1,38 @@
+/**
+ * @file worldsnapshot.cpp
+ * @brief Implementation of the WorldSnapshot struct methods.
+ */
+
+#include "worldsnapshot.h"
+
+/**
+ * @brief Returns the rectangle between the last two ticks.
+ *
+ * The previous rectangle already equals the current one after a teleport, so a respawn does not
+ * slide across the level.
+ *
+ * @param anAlpha Interpolation factor between 0 and 1.
+ * @return Interpolated rectangle.
+ */
+QRect WorldSnapshot::Mover::getInterpolatedRect(double anAlpha) const
+{
+    QPoint delta = rect.topLeft() - previousRect.topLeft();
+    QRect interpolated = rect;
+    interpolated.moveTopLeft(previousRect.topLeft() + delta * anAlpha);
+    return interpolated;
+}
+
+/**
+ * @brief Returns how far the clock is between the tick of the snapshot and the next one.
+ *
+ * The time elapsed since the snapshot was taken is added, so the frames drawn between two ticks
+ * still move.
+ *
+ * @param aNowNs Current time on the clock of the game.
+ * @return Interpolation factor between 0 and 1.
+ */
+double WorldSnapshot::getAlpha(qint64 aNowNs) const
+{
+    double elapsed = static_cast<double>(aNowNs - publishedNs) / static_cast<double>(stepNs);
+    return qBound(0.0, alpha + elapsed, 1.0);
+}
@@ -0,0 +1,97 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <QMap>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include "spriteregistry.h"
+
+/**
+ * @brief The WorldSnapshot struct is the state of the world the GUI draws, copied after a tick.
+ *
+ * The simulation thread fills a snapshot after each tick and publishes it through a triple buffer,
+ * the GUI draws its frames from the last snapshot published and never reads the entities. A
+ * snapshot only holds values: the rectangles before and after the tick for interpolation, the
+ * health and the animation state. The geometry of the level does not change while it runs, its
+ * containers are shared by the snapshots of the level rather than copied after each tick.
+ */
+struct WorldSnapshot
+{
+    /**
+     * @brief State of a character.
+     */
+    struct Mover
+    {
+        QRect previousRect; ///< Rectangle before the last tick, the current one after a teleport
+        QRect rect; ///< Rectangle after the last tick
+        int hp = 0; ///< Health points
+        int type = 0; ///< Kind of enemy, see Character::getType()
+        bool left = false; ///< True while moving left
+        bool right = false; ///< True while moving right
+        bool previousDirection = false; ///< Direction the character faced, see Character::getPreviousDirection()
+        bool dead = false; ///< True once the character is dead
+
+        /**
+         * @brief Returns the rectangle between the last two ticks, like Character::getInterpolatedRect().
+         *
+         * @param anAlpha Interpolation factor between 0 and 1
+         * @return Interpolated rectangle
+         */
+        QRect getInterpolatedRect(double anAlpha) const;
+    };
+
+    /**
+     * @brief Flashback object left in the level.
+     */
+    struct Object
+    {
+        QRect rect; ///< Rectangle of the object
+        int nb = 0; ///< Number of the object in the level, it selects its sprite
+    };
+
+    quint64 tickNb = 0; ///< Number of ticks run in the level when the snapshot was taken
+    qint64 gameTimeMs = 0; ///< Time of the snapshot on the game clock, which only moves with the ticks
+    qint64 publishedNs = 0; ///< Time of the snapshot on the clock of the game
+    double alpha = 0.0; ///< Interpolation factor when the snapshot was taken
+    qint64 stepNs = 10000000; ///< Duration of a tick
+
+    int levelNb = 0; ///< Number of the level
+    int levelWidth = 0; ///< Width of the level
+    Era era = Era::None; ///< Era of the level
+    int hudNb = 0; ///< Level number shown by the HUD
+    int flashbackObjectTotal = 0; ///< Flashback objects to collect in the level
+    QVector<QRect> obstacles; ///< Obstacles of the level, shared by the snapshots of the level
+    QMap<QString, QSize> drawSizes; ///< Size of the first entity of each kind, see Level::getItsDrawSizes()
+
+    Mover mainCharacter; ///< Main character
+    int pieceNb = 0; ///< Pieces collected by the main character
+    int flashbackObjectNb = 0; ///< Flashback objects collected by the main character
+    bool dead = false; ///< True once the player is dead
+    bool playerIsNearDoor = false; ///< True when the player can go through the door
+    Mover companion; ///< Companion
+    QVector<Mover> enemies; ///< Enemies, in the order of the level
+
+    bool hasFinalBoss = false; ///< True if the level has a final boss
+    Mover finalBoss; ///< Final boss, when there is one
+    bool hasBoss = false; ///< True if the level has a classic boss
+    Mover boss; ///< Classic boss, when there is one
+    bool isSwordVertical = false; ///< Orientation of the swords of the knight
+    QVector<QRect> summonings; ///< Attacks of the classic boss
+
+    QVector<QRect> pieces; ///< Pieces left in the level
+    QVector<Object> flashbackObjects; ///< Flashback objects left in the level
+    bool hasDoor = false; ///< True if the level has a door
+    QRect door; ///< Door of the level, when there is one
+
+    /**
+     * @brief Returns how far the clock is between the tick of the snapshot and the next one.
+     *
+     * @param aNowNs Current time on the clock of the game
+     * @return Interpolation factor between 0 and 1
+     */
+    double getAlpha(qint64 aNowNs) const;
+};
+
+#endif // WORLDSNAPSHOT_H